@@ -48,6 +48,8 @@ namespace openvkl {
              "\t-field wavelet | xyz | sphere | torus (vdb float only) | "
              "<FIELD> (-file only)\n"
              "\t-file <filename>\n"
+             "\t-fileAccess normal | random | sequential | willneed (raw "
+             "files only)\n"
              "\t-numParticles <N> (particle only)\n"
              "\t-vdbRepackNodes 0 | 1 (vdb only)\n"
              "\t-background <BG VALUE>| undefined\n";
@@ -68,6 +70,20 @@ namespace openvkl {
           source   = "file";
         }
 
+        else if (arg == "-fileAccess") {
+          const auto fa = cmd::consume_1<std::string>(args, it);
+          if (fa == "normal")
+            fileAccess = MappedFileAdvice::Normal;
+          else if (fa == "random")
+            fileAccess = MappedFileAdvice::Random;
+          else if (fa == "sequential")
+            fileAccess = MappedFileAdvice::Sequential;
+          else if (fa == "willneed")
+            fileAccess = MappedFileAdvice::WillNeed;
+          else
+            throw std::runtime_error("unknown file access hint " + fa);
+        }
+
         else if (arg == "-field") {
           fieldParam = cmd::consume_1<std::string>(args, it);
         }
@@ -239,14 +255,15 @@ namespace openvkl {
         const std::string ext = getFileExtension(filename);
         if (ext == ".rwh") {
           return rkcommon::make_unique<RawHFileStructuredVolume>(
-              filename, volumeType, gridOrigin, gridSpacing);
+              filename, volumeType, gridOrigin, gridSpacing, fileAccess);
         } else {
           return rkcommon::make_unique<RawFileStructuredVolume>(filename,
                                                                 volumeType,
                                                                 dimensions,
                                                                 gridOrigin,
                                                                 gridSpacing,
-                                                                voxelType);
+                                                                voxelType,
+                                                                fileAccess);
         }
       }
 
@@ -64,6 +64,7 @@ namespace openvkl {
       std::string volumeType{supportedVolumeTypes()[0]};
       std::string source{supportedSources("structuredRegular")[0]};
       std::string filename;
+      MappedFileAdvice fileAccess{MappedFileAdvice::Normal};
       std::string field{supportedFields("structuredRegular")[0]};
       std::string fieldInFile{"density"};
       VKLDataType voxelType{VKL_FLOAT};
@@ -434,6 +434,16 @@ extern "C" int vklIterateInterval(VKLIntervalIterator iterator,
 }
 OPENVKL_CATCH_END(false)
 
+extern "C" unsigned int vklIterateIntervals(VKLIntervalIterator iterator,
+                                            VKLInterval *intervals,
+                                            unsigned int maxCount)
+    OPENVKL_CATCH_BEGIN_UNSAFE(iterator)
+{
+  return deviceObj->iterateIntervals(
+      iterator, reinterpret_cast<vVKLIntervalN<1> *>(intervals), maxCount);
+}
+OPENVKL_CATCH_END(0u)
+
 #define __define_vklIterateIntervalN(WIDTH)                  \
   extern "C" void vklIterateInterval##WIDTH(                 \
       const int *valid,                                      \
@@ -455,6 +465,30 @@ __define_vklIterateIntervalN(16);
 
 #undef __define_vklIterateIntervalN
 
+extern "C" void vklIterateIntervalsN(VKLIntervalIteratorContext context,
+                                     unsigned int N,
+                                     const vkl_vec3f *origins,
+                                     const vkl_vec3f *directions,
+                                     const vkl_range1f *tRanges,
+                                     const float *times,
+                                     unsigned int maxIntervals,
+                                     VKLInterval *intervals,
+                                     unsigned int *numIntervals)
+    OPENVKL_CATCH_BEGIN_UNSAFE(context)
+{
+  deviceObj->iterateIntervalsN(
+      context,
+      N,
+      reinterpret_cast<const vvec3fn<1> *>(origins),
+      reinterpret_cast<const vvec3fn<1> *>(directions),
+      reinterpret_cast<const vrange1fn<1> *>(tRanges),
+      times,
+      maxIntervals,
+      reinterpret_cast<vVKLIntervalN<1> *>(intervals),
+      numIntervals);
+}
+OPENVKL_CATCH_END()
+
 ///////////////////////////////////////////////////////////////////////////////
 // Hit iterator ///////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -559,6 +593,16 @@ extern "C" int vklIterateHit(VKLHitIterator iterator, VKLHit *hit)
 }
 OPENVKL_CATCH_END(false)
 
+extern "C" unsigned int vklIterateHits(VKLHitIterator iterator,
+                                       VKLHit *hits,
+                                       unsigned int maxCount)
+    OPENVKL_CATCH_BEGIN_UNSAFE(iterator)
+{
+  return deviceObj->iterateHits(
+      iterator, reinterpret_cast<vVKLHitN<1> *>(hits), maxCount);
+}
+OPENVKL_CATCH_END(0u)
+
 #define __define_vklIterateHitN(WIDTH)                                       \
   extern "C" void vklIterateHit##WIDTH(const int *valid,                     \
                                        VKLHitIterator##WIDTH iterator,       \
@@ -577,6 +621,29 @@ __define_vklIterateHitN(16);
 
 #undef __define_vklIterateHitN
 
+extern "C" void vklIterateHitsN(VKLHitIteratorContext context,
+                                unsigned int N,
+                                const vkl_vec3f *origins,
+                                const vkl_vec3f *directions,
+                                const vkl_range1f *tRanges,
+                                const float *times,
+                                unsigned int maxHits,
+                                VKLHit *hits,
+                                unsigned int *numHits)
+    OPENVKL_CATCH_BEGIN_UNSAFE(context)
+{
+  deviceObj->iterateHitsN(context,
+                          N,
+                          reinterpret_cast<const vvec3fn<1> *>(origins),
+                          reinterpret_cast<const vvec3fn<1> *>(directions),
+                          reinterpret_cast<const vrange1fn<1> *>(tRanges),
+                          times,
+                          maxHits,
+                          reinterpret_cast<vVKLHitN<1> *>(hits),
+                          numHits);
+}
+OPENVKL_CATCH_END()
+
 ///////////////////////////////////////////////////////////////////////////////
 // Module /////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -880,6 +947,74 @@ extern "C" void vklComputeGradientN(VKLSampler sampler,
 }
 OPENVKL_CATCH_END()
 
+extern "C" float vklComputeSampleAndGradient(
+    VKLSampler sampler,
+    const vkl_vec3f *objectCoordinates,
+    vkl_vec3f *gradient,
+    unsigned int attributeIndex,
+    float time) OPENVKL_CATCH_BEGIN_UNSAFE(sampler)
+{
+  constexpr int valid = 1;
+  float sample;
+  deviceObj->computeSampleAndGradient1(
+      &valid,
+      sampler,
+      reinterpret_cast<const vvec3fn<1> &>(*objectCoordinates),
+      &sample,
+      reinterpret_cast<vvec3fn<1> &>(*gradient),
+      attributeIndex,
+      &time);
+  return sample;
+}
+OPENVKL_CATCH_END(rkcommon::math::nan)
+
+#define __define_vklComputeSampleAndGradientN(WIDTH)                  \
+  extern "C" void vklComputeSampleAndGradient##WIDTH(                 \
+      const int *valid,                                               \
+      VKLSampler sampler,                                             \
+      const vkl_vvec3f##WIDTH *objectCoordinates,                     \
+      float *samples,                                                 \
+      vkl_vvec3f##WIDTH *gradients,                                   \
+      unsigned int attributeIndex,                                    \
+      const float *times) OPENVKL_CATCH_BEGIN_UNSAFE(sampler)         \
+  {                                                                   \
+    deviceObj->computeSampleAndGradient##WIDTH(                       \
+        valid,                                                        \
+        sampler,                                                      \
+        reinterpret_cast<const vvec3fn<WIDTH> &>(*objectCoordinates), \
+        samples,                                                      \
+        reinterpret_cast<vvec3fn<WIDTH> &>(*gradients),               \
+        attributeIndex,                                               \
+        times);                                                       \
+  }                                                                   \
+  OPENVKL_CATCH_END()
+
+__define_vklComputeSampleAndGradientN(4);
+__define_vklComputeSampleAndGradientN(8);
+__define_vklComputeSampleAndGradientN(16);
+
+#undef __define_vklComputeSampleAndGradientN
+
+extern "C" void vklComputeSampleAndGradientN(VKLSampler sampler,
+                                             unsigned int N,
+                                             const vkl_vec3f *objectCoordinates,
+                                             float *samples,
+                                             vkl_vec3f *gradients,
+                                             unsigned int attributeIndex,
+                                             const float *times)
+    OPENVKL_CATCH_BEGIN_UNSAFE(sampler)
+{
+  deviceObj->computeSampleAndGradientN(
+      sampler,
+      N,
+      reinterpret_cast<const vvec3fn<1> *>(objectCoordinates),
+      samples,
+      reinterpret_cast<vvec3fn<1> *>(gradients),
+      attributeIndex,
+      times);
+}
+OPENVKL_CATCH_END()
+
 ///////////////////////////////////////////////////////////////////////////////
 // Volume /////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -133,6 +133,10 @@ namespace openvkl {
                                     vVKLIntervalN<1> &interval,
                                     int *result) const = 0;
 
+      virtual unsigned int iterateIntervals(VKLIntervalIterator iterator,
+                                            vVKLIntervalN<1> *intervals,
+                                            unsigned int maxCount) const = 0;
+
 #define __define_iterateIntervalN(WIDTH)                                   \
   virtual void iterateInterval##WIDTH(const int *valid,                    \
                                       VKLIntervalIterator##WIDTH iterator, \
@@ -145,6 +149,16 @@ namespace openvkl {
 
 #undef __define_iterateIntervalN
 
+      virtual void iterateIntervalsN(VKLIntervalIteratorContext context,
+                                     unsigned int N,
+                                     const vvec3fn<1> *origins,
+                                     const vvec3fn<1> *directions,
+                                     const vrange1fn<1> *tRanges,
+                                     const float *times,
+                                     unsigned int maxIntervals,
+                                     vVKLIntervalN<1> *intervals,
+                                     unsigned int *numIntervals) const = 0;
+
       /////////////////////////////////////////////////////////////////////////
       // Hit iterator /////////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
@@ -190,6 +204,10 @@ namespace openvkl {
                                vVKLHitN<1> &hit,
                                int *result) const = 0;
 
+      virtual unsigned int iterateHits(VKLHitIterator iterator,
+                                       vVKLHitN<1> *hits,
+                                       unsigned int maxCount) const = 0;
+
 #define __define_iterateHitN(WIDTH)                              \
   virtual void iterateHit##WIDTH(const int *valid,               \
                                  VKLHitIterator##WIDTH iterator, \
@@ -202,6 +220,16 @@ namespace openvkl {
 
 #undef __define_iterateHitN
 
+      virtual void iterateHitsN(VKLHitIteratorContext context,
+                                unsigned int N,
+                                const vvec3fn<1> *origins,
+                                const vvec3fn<1> *directions,
+                                const vrange1fn<1> *tRanges,
+                                const float *times,
+                                unsigned int maxHits,
+                                vVKLHitN<1> *hits,
+                                unsigned int *numHits) const = 0;
+
       /////////////////////////////////////////////////////////////////////////
       // Parameters ///////////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
@@ -304,6 +332,32 @@ namespace openvkl {
                                     unsigned int attributeIndex,
                                     const float *times) = 0;
 
+#define __define_computeSampleAndGradientN(WIDTH) \
+  virtual void computeSampleAndGradient##WIDTH(   \
+      const int *valid,                           \
+      VKLSampler sampler,                         \
+      const vvec3fn<WIDTH> &objectCoordinates,    \
+      float *samples,                             \
+      vvec3fn<WIDTH> &gradients,                  \
+      unsigned int attributeIndex,                \
+      const float *times) = 0;
+
+      __define_computeSampleAndGradientN(1);
+      __define_computeSampleAndGradientN(4);
+      __define_computeSampleAndGradientN(8);
+      __define_computeSampleAndGradientN(16);
+
+#undef __define_computeSampleAndGradientN
+
+      virtual void computeSampleAndGradientN(
+          VKLSampler sampler,
+          unsigned int N,
+          const vvec3fn<1> *objectCoordinates,
+          float *samples,
+          vvec3fn<1> *gradients,
+          unsigned int attributeIndex,
+          const float *times) = 0;
+
       /////////////////////////////////////////////////////////////////////////
       // Volume ///////////////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
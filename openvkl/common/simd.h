@@ -254,6 +254,7 @@ namespace openvkl {
     vrange1fn<W> tRange;
     vrange1fn<W> valueRange;
     vfloatn<W> nominalDeltaT;
+    vfloatn<W> majorant;
 
     vVKLIntervalN<W>()
     {
@@ -267,7 +268,8 @@ namespace openvkl {
     vVKLIntervalN<W>(const vVKLIntervalN<W> &v)
         : tRange(v.tRange),
           valueRange(v.valueRange),
-          nominalDeltaT(v.nominalDeltaT)
+          nominalDeltaT(v.nominalDeltaT),
+          majorant(v.majorant)
     {
     }
   };
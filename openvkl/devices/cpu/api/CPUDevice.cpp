@@ -12,6 +12,11 @@
 #include "../volume/Volume.h"
 #include "CPUDevice_ispc.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 namespace openvkl {
   namespace cpu_device {
 
@@ -217,6 +222,92 @@ namespace openvkl {
       return observerObject.getNumElements();
     }
 
+    ///////////////////////////////////////////////////////////////////////////
+    // Stream iteration helpers ///////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Assigns the rays of a stream to the lanes of a native width packet.
+    // Lanes retire independently as their rays finish; once no more than half
+    // of the lanes remain active and unstarted rays are left, the packet is
+    // refilled: active rays are compacted to the front, free lanes receive new
+    // rays, and the packet iterator is restarted where each ray left off.
+    template <int W>
+    struct StreamPacket
+    {
+      explicit StreamPacket(unsigned int N) : N(N)
+      {
+        std::fill(ray, ray + W, -1);
+      }
+
+      // returns false once all rays are done
+      bool refill()
+      {
+        numActive = 0;
+
+        for (int i = 0; i < W; i++) {
+          if (ray[i] >= 0) {
+            ray[numActive++] = ray[i];
+          }
+        }
+
+        while (numActive < W && nextRay < N) {
+          ray[numActive++] = nextRay++;
+        }
+
+        for (int i = 0; i < W; i++) {
+          if (i >= numActive) {
+            ray[i] = -1;
+          }
+          valid[i] = ray[i] >= 0 ? -1 : 0;
+        }
+
+        return numActive > 0;
+      }
+
+      void retire(int lane)
+      {
+        ray[lane]   = -1;
+        valid[lane] = 0;
+        numActive--;
+      }
+
+      bool needsRefill() const
+      {
+        return numActive == 0 || (nextRay < N && numActive <= W / 2);
+      }
+
+      void load(const vvec3fn<1> *origins,
+                const vvec3fn<1> *directions,
+                const vrange1fn<1> *tRanges,
+                const float *tLower,
+                const float *times,
+                vvec3fn<W> &origin,
+                vvec3fn<W> &direction,
+                vrange1fn<W> &tRange,
+                vfloatn<W> &time) const
+      {
+        for (int i = 0; i < W; i++) {
+          const int64_t r = ray[i] >= 0 ? ray[i] : ray[0];
+
+          origin.x[i]     = origins[r].x[0];
+          origin.y[i]     = origins[r].y[0];
+          origin.z[i]     = origins[r].z[0];
+          direction.x[i]  = directions[r].x[0];
+          direction.y[i]  = directions[r].y[0];
+          direction.z[i]  = directions[r].z[0];
+          tRange.lower[i] = tLower[r];
+          tRange.upper[i] = tRanges[r].upper[0];
+          time[i]         = times ? times[r] : 0.f;
+        }
+      }
+
+      const unsigned int N;
+      unsigned int nextRay = 0;
+      int numActive        = 0;
+      int64_t ray[W];
+      vintn<W> valid;
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     // Interval iterator //////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
@@ -231,6 +322,95 @@ namespace openvkl {
           .newContext(samplerObject);
     }
 
+    template <int W>
+    void CPUDevice<W>::iterateIntervalsN(VKLIntervalIteratorContext context,
+                                         unsigned int N,
+                                         const vvec3fn<1> *origins,
+                                         const vvec3fn<1> *directions,
+                                         const vrange1fn<1> *tRanges,
+                                         const float *times,
+                                         unsigned int maxIntervals,
+                                         vVKLIntervalN<1> *intervals,
+                                         unsigned int *numIntervals) const
+    {
+      const auto &ctx =
+          referenceFromHandle<IntervalIteratorContext<W>>(context);
+      const auto &factory = ctx.getSampler().getIntervalIteratorFactory();
+
+      std::fill(numIntervals, numIntervals + N, 0u);
+
+      if (maxIntervals == 0) {
+        return;
+      }
+
+      // restarted rays continue from the end of their last interval
+      std::vector<float> tLower(N);
+      for (unsigned int i = 0; i < N; i++) {
+        tLower[i] = tRanges[i].lower[0];
+      }
+
+      std::vector<char> buffer(factory.sizeV());
+      StreamPacket<W> packet(N);
+
+      while (packet.refill()) {
+        vvec3fn<W> origin;
+        vvec3fn<W> direction;
+        vrange1fn<W> tRange;
+        vfloatn<W> time;
+
+        packet.load(origins,
+                    directions,
+                    tRanges,
+                    tLower.data(),
+                    times,
+                    origin,
+                    direction,
+                    tRange,
+                    time);
+
+        assertValidTimes(packet.valid, time);
+
+        IntervalIterator<W> *it = factory.constructV(ctx, buffer.data());
+        it->initializeIntervalV(packet.valid, origin, direction, tRange, time);
+
+        do {
+          vVKLIntervalN<W> interval;
+          vintn<W> result;
+
+          it->iterateIntervalV(packet.valid, interval, result);
+
+          for (int i = 0; i < W; i++) {
+            if (!packet.valid[i]) {
+              continue;
+            }
+
+            if (!result[i]) {
+              packet.retire(i);
+              continue;
+            }
+
+            const int64_t r = packet.ray[i];
+
+            vVKLIntervalN<1> &out =
+                intervals[r * maxIntervals + numIntervals[r]++];
+
+            out.tRange.lower[0]     = interval.tRange.lower[i];
+            out.tRange.upper[0]     = interval.tRange.upper[i];
+            out.valueRange.lower[0] = interval.valueRange.lower[i];
+            out.valueRange.upper[0] = interval.valueRange.upper[i];
+            out.nominalDeltaT[0]    = interval.nominalDeltaT[i];
+            out.majorant[0]         = interval.majorant[i];
+
+            tLower[r] = interval.tRange.upper[i];
+
+            if (numIntervals[r] == maxIntervals) {
+              packet.retire(i);
+            }
+          }
+        } while (!packet.needsRefill());
+      }
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Hit iterator ///////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
@@ -244,6 +424,94 @@ namespace openvkl {
           .newContext(samplerObject);
     }
 
+    template <int W>
+    void CPUDevice<W>::iterateHitsN(VKLHitIteratorContext context,
+                                    unsigned int N,
+                                    const vvec3fn<1> *origins,
+                                    const vvec3fn<1> *directions,
+                                    const vrange1fn<1> *tRanges,
+                                    const float *times,
+                                    unsigned int maxHits,
+                                    vVKLHitN<1> *hits,
+                                    unsigned int *numHits) const
+    {
+      const auto &ctx     = referenceFromHandle<HitIteratorContext<W>>(context);
+      const auto &factory = ctx.getSampler().getHitIteratorFactory();
+
+      std::fill(numHits, numHits + N, 0u);
+
+      if (maxHits == 0) {
+        return;
+      }
+
+      // restarted rays continue just past their last hit, using the hit
+      // epsilon so that the same hit is not reported twice
+      std::vector<float> tLower(N);
+      for (unsigned int i = 0; i < N; i++) {
+        tLower[i] = tRanges[i].lower[0];
+      }
+
+      std::vector<char> buffer(factory.sizeV());
+      StreamPacket<W> packet(N);
+
+      while (packet.refill()) {
+        vvec3fn<W> origin;
+        vvec3fn<W> direction;
+        vrange1fn<W> tRange;
+        vfloatn<W> time;
+
+        packet.load(origins,
+                    directions,
+                    tRanges,
+                    tLower.data(),
+                    times,
+                    origin,
+                    direction,
+                    tRange,
+                    time);
+
+        assertValidTimes(packet.valid, time);
+
+        HitIterator<W> *it = factory.constructV(ctx, buffer.data());
+        it->initializeHitV(packet.valid, origin, direction, tRange, time);
+
+        do {
+          vVKLHitN<W> hit;
+          vintn<W> result;
+
+          it->iterateHitV(packet.valid, hit, result);
+
+          for (int i = 0; i < W; i++) {
+            if (!packet.valid[i]) {
+              continue;
+            }
+
+            if (!result[i]) {
+              packet.retire(i);
+              continue;
+            }
+
+            const int64_t r = packet.ray[i];
+
+            vVKLHitN<1> &out = hits[r * maxHits + numHits[r]++];
+
+            out.t[0]       = hit.t[i];
+            out.sample[0]  = hit.sample[i];
+            out.epsilon[0] = hit.epsilon[i];
+
+            const float tNext = std::nextafter(
+                hit.t[i], std::numeric_limits<float>::infinity());
+
+            tLower[r] = std::max(hit.t[i] + hit.epsilon[i], tNext);
+
+            if (numHits[r] == maxHits) {
+              packet.retire(i);
+            }
+          }
+        } while (!packet.needsRefill());
+      }
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Parameters /////////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
@@ -469,6 +737,48 @@ namespace openvkl {
           N, objectCoordinates, gradients, attributeIndex, times);
     }
 
+#define __define_computeSampleAndGradientN(WIDTH)              \
+  template <int W>                                             \
+  void CPUDevice<W>::computeSampleAndGradient##WIDTH(          \
+      const int *valid,                                        \
+      VKLSampler sampler,                                      \
+      const vvec3fn<WIDTH> &objectCoordinates,                 \
+      float *samples,                                          \
+      vvec3fn<WIDTH> &gradients,                               \
+      unsigned int attributeIndex,                             \
+      const float *times)                                      \
+  {                                                            \
+    computeSampleAndGradientAnyWidth<WIDTH>(valid,             \
+                                            sampler,           \
+                                            objectCoordinates, \
+                                            samples,           \
+                                            gradients,         \
+                                            attributeIndex,    \
+                                            times);            \
+  }
+
+    __define_computeSampleAndGradientN(1);
+    __define_computeSampleAndGradientN(4);
+    __define_computeSampleAndGradientN(8);
+    __define_computeSampleAndGradientN(16);
+
+#undef __define_computeSampleAndGradientN
+
+    template <int W>
+    void CPUDevice<W>::computeSampleAndGradientN(
+        VKLSampler sampler,
+        unsigned int N,
+        const vvec3fn<1> *objectCoordinates,
+        float *samples,
+        vvec3fn<1> *gradients,
+        unsigned int attributeIndex,
+        const float *times)
+    {
+      auto &samplerObject = referenceFromHandle<Sampler<W>>(sampler);
+      samplerObject.computeSampleAndGradientN(
+          N, objectCoordinates, samples, gradients, attributeIndex, times);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Volume /////////////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
@@ -805,6 +1115,117 @@ namespace openvkl {
       }
     }
 
+    template <int W>
+    template <int OW>
+    typename std::enable_if<(OW < W), void>::type
+    CPUDevice<W>::computeSampleAndGradientAnyWidth(
+        const int *valid,
+        VKLSampler sampler,
+        const vvec3fn<OW> &objectCoordinates,
+        float *samples,
+        vvec3fn<OW> &gradients,
+        unsigned int attributeIndex,
+        const float *times)
+    {
+      auto &samplerObject = referenceFromHandle<Sampler<W>>(sampler);
+
+      vvec3fn<W> ocW = static_cast<vvec3fn<W>>(objectCoordinates);
+      vfloatn<W> tW(times, OW);
+
+      vintn<W> validW;
+      for (int i = 0; i < W; i++)
+        validW[i] = i < OW ? valid[i] : 0;
+
+      ocW.fill_inactive_lanes(validW);
+      tW.fill_inactive_lanes(validW);
+
+      vfloatn<W> samplesW;
+      vvec3fn<W> gradientsW;
+
+      samplerObject.computeSampleAndGradientV(
+          validW, ocW, samplesW, gradientsW, attributeIndex, tW);
+
+      for (int i = 0; i < OW; i++) {
+        samples[i]     = samplesW[i];
+        gradients.x[i] = gradientsW.x[i];
+        gradients.y[i] = gradientsW.y[i];
+        gradients.z[i] = gradientsW.z[i];
+      }
+    }
+
+    template <int W>
+    template <int OW>
+    typename std::enable_if<(OW == W), void>::type
+    CPUDevice<W>::computeSampleAndGradientAnyWidth(
+        const int *valid,
+        VKLSampler sampler,
+        const vvec3fn<OW> &objectCoordinates,
+        float *samples,
+        vvec3fn<OW> &gradients,
+        unsigned int attributeIndex,
+        const float *times)
+    {
+      auto &samplerObject = referenceFromHandle<Sampler<W>>(sampler);
+
+      vfloatn<W> tW(times, W);
+
+      vintn<W> validW;
+      for (int i = 0; i < W; i++)
+        validW[i] = valid[i];
+
+      vfloatn<W> samplesW;
+
+      samplerObject.computeSampleAndGradientV(
+          validW, objectCoordinates, samplesW, gradients, attributeIndex, tW);
+
+      for (int i = 0; i < W; i++)
+        samples[i] = samplesW[i];
+    }
+
+    template <int W>
+    template <int OW>
+    typename std::enable_if<(OW > W), void>::type
+    CPUDevice<W>::computeSampleAndGradientAnyWidth(
+        const int *valid,
+        VKLSampler sampler,
+        const vvec3fn<OW> &objectCoordinates,
+        float *samples,
+        vvec3fn<OW> &gradients,
+        unsigned int attributeIndex,
+        const float *times)
+    {
+      auto &samplerObject = referenceFromHandle<Sampler<W>>(sampler);
+
+      vfloatn<OW> tOW(times, OW);
+
+      const int numPacks = OW / W + (OW % W != 0);
+
+      for (int packIndex = 0; packIndex < numPacks; packIndex++) {
+        vvec3fn<W> ocW = objectCoordinates.template extract_pack<W>(packIndex);
+        vfloatn<W> tW  = tOW.template extract_pack<W>(packIndex);
+
+        vintn<W> validW;
+        for (int i = packIndex * W; i < (packIndex + 1) * W && i < OW; i++)
+          validW[i - packIndex * W] = i < OW ? valid[i] : 0;
+
+        ocW.fill_inactive_lanes(validW);
+        tW.fill_inactive_lanes(validW);
+
+        vfloatn<W> samplesW;
+        vvec3fn<W> gradientsW;
+
+        samplerObject.computeSampleAndGradientV(
+            validW, ocW, samplesW, gradientsW, attributeIndex, tW);
+
+        for (int i = packIndex * W; i < (packIndex + 1) * W && i < OW; i++) {
+          samples[i]     = samplesW[i - packIndex * W];
+          gradients.x[i] = gradientsW.x[i - packIndex * W];
+          gradients.y[i] = gradientsW.y[i - packIndex * W];
+          gradients.z[i] = gradientsW.z[i - packIndex * W];
+        }
+      }
+    }
+
     VKL_REGISTER_DEVICE(CPUDevice<VKL_TARGET_WIDTH>,
                         CONCAT1(internal_cpu_, VKL_TARGET_WIDTH))
 
@@ -146,6 +146,10 @@ namespace openvkl {
                             vVKLIntervalN<1> &interval,
                             int *result) const override;
 
+      unsigned int iterateIntervals(const VKLIntervalIterator iterator,
+                                    vVKLIntervalN<1> *intervals,
+                                    unsigned int maxCount) const override;
+
 #define __define_iterateIntervalN(WIDTH)                           \
   void iterateInterval##WIDTH(const int *valid,                    \
                               VKLIntervalIterator##WIDTH iterator, \
@@ -165,6 +169,16 @@ namespace openvkl {
 
 #undef __define_iterateIntervalN
 
+      void iterateIntervalsN(VKLIntervalIteratorContext context,
+                             unsigned int N,
+                             const vvec3fn<1> *origins,
+                             const vvec3fn<1> *directions,
+                             const vrange1fn<1> *tRanges,
+                             const float *times,
+                             unsigned int maxIntervals,
+                             vVKLIntervalN<1> *intervals,
+                             unsigned int *numIntervals) const override;
+
      private:
       template <int OW>
       EnableIf<(W == OW)> iterateIntervalAnyWidth(
@@ -270,6 +284,10 @@ namespace openvkl {
                        vVKLHitN<1> &hit,
                        int *result) const override;
 
+      unsigned int iterateHits(VKLHitIterator iterator,
+                               vVKLHitN<1> *hits,
+                               unsigned int maxCount) const override;
+
 #define __define_iterateHitN(WIDTH)                        \
   void iterateHit##WIDTH(const int *valid,                 \
                          VKLHitIterator##WIDTH iterator,   \
@@ -289,6 +307,16 @@ namespace openvkl {
 
 #undef __define_iterateHitN
 
+      void iterateHitsN(VKLHitIteratorContext context,
+                        unsigned int N,
+                        const vvec3fn<1> *origins,
+                        const vvec3fn<1> *directions,
+                        const vrange1fn<1> *tRanges,
+                        const float *times,
+                        unsigned int maxHits,
+                        vVKLHitN<1> *hits,
+                        unsigned int *numHits) const override;
+
      private:
       template <int OW>
       EnableIf<(W == OW)> iterateHitAnyWidth(const int *valid,
@@ -402,6 +430,31 @@ namespace openvkl {
                             unsigned int attributeIndex,
                             const float *times) override;
 
+#define __define_computeSampleAndGradientN(WIDTH) \
+  void computeSampleAndGradient##WIDTH(           \
+      const int *valid,                           \
+      VKLSampler sampler,                         \
+      const vvec3fn<WIDTH> &objectCoordinates,    \
+      float *samples,                             \
+      vvec3fn<WIDTH> &gradients,                  \
+      unsigned int attributeIndex,                \
+      const float *times) override;
+
+      __define_computeSampleAndGradientN(1);
+      __define_computeSampleAndGradientN(4);
+      __define_computeSampleAndGradientN(8);
+      __define_computeSampleAndGradientN(16);
+
+#undef __define_computeSampleAndGradientN
+
+      void computeSampleAndGradientN(VKLSampler sampler,
+                                     unsigned int N,
+                                     const vvec3fn<1> *objectCoordinates,
+                                     float *samples,
+                                     vvec3fn<1> *gradients,
+                                     unsigned int attributeIndex,
+                                     const float *times) override;
+
       /////////////////////////////////////////////////////////////////////////
       // Volume ///////////////////////////////////////////////////////////////
       /////////////////////////////////////////////////////////////////////////
@@ -499,6 +552,36 @@ namespace openvkl {
           vvec3fn<OW> &gradients,
           unsigned int attributeIndex,
           const float *times);
+
+      template <int OW>
+      typename std::enable_if<(OW < W), void>::type
+      computeSampleAndGradientAnyWidth(const int *valid,
+                                       VKLSampler sampler,
+                                       const vvec3fn<OW> &objectCoordinates,
+                                       float *samples,
+                                       vvec3fn<OW> &gradients,
+                                       unsigned int attributeIndex,
+                                       const float *times);
+
+      template <int OW>
+      typename std::enable_if<(OW == W), void>::type
+      computeSampleAndGradientAnyWidth(const int *valid,
+                                       VKLSampler sampler,
+                                       const vvec3fn<OW> &objectCoordinates,
+                                       float *samples,
+                                       vvec3fn<OW> &gradients,
+                                       unsigned int attributeIndex,
+                                       const float *times);
+
+      template <int OW>
+      typename std::enable_if<(OW > W), void>::type
+      computeSampleAndGradientAnyWidth(const int *valid,
+                                       VKLSampler sampler,
+                                       const vvec3fn<OW> &objectCoordinates,
+                                       float *samples,
+                                       vvec3fn<OW> &gradients,
+                                       unsigned int attributeIndex,
+                                       const float *times);
     };
 
     ////////////////////////////////////////////////////////////////////////////
@@ -590,6 +673,16 @@ namespace openvkl {
                           reinterpret_cast<vintn<1> &>(*result));
     }
 
+    template <int W>
+    inline unsigned int CPUDevice<W>::iterateIntervals(
+        const VKLIntervalIterator iterator,
+        vVKLIntervalN<1> *intervals,
+        unsigned int maxCount) const
+    {
+      auto &it = referenceFromHandle<IntervalIterator<W>>(iterator);
+      return it.iterateIntervalsU(intervals, maxCount);
+    }
+
     template <int W>
     template <int OW>
     inline EnableIf<(W == OW)> CPUDevice<W>::iterateIntervalAnyWidth(
@@ -706,6 +799,15 @@ namespace openvkl {
                      reinterpret_cast<vintn<1> &>(*result));
     }
 
+    template <int W>
+    inline unsigned int CPUDevice<W>::iterateHits(const VKLHitIterator iterator,
+                                                  vVKLHitN<1> *hits,
+                                                  unsigned int maxCount) const
+    {
+      auto &it = referenceFromHandle<HitIterator<W>>(iterator);
+      return it.iterateHitsU(hits, maxCount);
+    }
+
     template <int W>
     template <int OW>
     inline EnableIf<(W == OW)> CPUDevice<W>::iterateHitAnyWidth(
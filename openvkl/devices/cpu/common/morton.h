@@ -0,0 +1,109 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "rkcommon/math/vec.h"
+#include "rkcommon/tasking/parallel_for.h"
+
+namespace openvkl {
+  namespace cpu_device {
+
+    /*
+     * Spread the lower 21 bits of v so that there are two zero bits between
+     * each pair of bits.
+     */
+    inline uint64_t mortonExpandBits(uint64_t v)
+    {
+      v &= 0x1fffff;
+      v = (v | v << 32) & 0x1f00000000ffffull;
+      v = (v | v << 16) & 0x1f0000ff0000ffull;
+      v = (v | v << 8) & 0x100f00f00f00f00full;
+      v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+      v = (v | v << 2) & 0x1249249249249249ull;
+      return v;
+    }
+
+    /*
+     * Morton code for 3D coordinates with up to 21 bits each. Note that
+     * mortonEncode(c >> s) == mortonEncode(c) >> (3 * s), so node keys can be
+     * quantized to coarser levels by shifting.
+     */
+    inline uint64_t mortonEncode(const rkcommon::math::vec3ui &c)
+    {
+      return (mortonExpandBits(c.x) << 2) | (mortonExpandBits(c.y) << 1) |
+             mortonExpandBits(c.z);
+    }
+
+    // Work is split into blocks of this many keys for parallel sorting.
+    static constexpr size_t sortBlockSize = 1 << 16;
+
+    /*
+     * Stable sort of keys using a parallel LSD radix sort. Only the lowest
+     * numBits bits of each key are considered, so that the upper bits may
+     * carry a payload.
+     */
+    inline void parallelRadixSort(std::vector<uint64_t> &keys,
+                                  uint32_t numBits)
+    {
+      const size_t n = keys.size();
+      const uint64_t mask =
+          numBits < 64 ? (uint64_t(1) << numBits) - 1 : ~uint64_t(0);
+
+      if (n <= sortBlockSize) {
+        std::stable_sort(
+            keys.begin(), keys.end(), [&](uint64_t a, uint64_t b) {
+              return (a & mask) < (b & mask);
+            });
+        return;
+      }
+
+      constexpr uint32_t radixBits  = 8;
+      constexpr uint32_t numBuckets = 1u << radixBits;
+      const size_t numBlocks        = (n + sortBlockSize - 1) / sortBlockSize;
+
+      std::vector<uint64_t> sorted(n);
+      std::vector<size_t> offsets(numBlocks * numBuckets);
+
+      const auto digit = [&](uint64_t key, uint32_t shift) -> size_t {
+        return ((key & mask) >> shift) & (numBuckets - 1);
+      };
+
+      for (uint32_t shift = 0; shift < numBits; shift += radixBits) {
+        // Per-block digit histograms.
+        rkcommon::tasking::parallel_for(numBlocks, [&](size_t b) {
+          size_t *histogram = offsets.data() + b * numBuckets;
+          std::fill(histogram, histogram + numBuckets, 0);
+          const size_t end = std::min(n, (b + 1) * sortBlockSize);
+          for (size_t i = b * sortBlockSize; i < end; ++i) {
+            histogram[digit(keys[i], shift)]++;
+          }
+        });
+
+        // Exclusive prefix sum in (digit, block) order keeps the sort stable.
+        size_t sum = 0;
+        for (uint32_t d = 0; d < numBuckets; ++d) {
+          for (size_t b = 0; b < numBlocks; ++b) {
+            const size_t count          = offsets[b * numBuckets + d];
+            offsets[b * numBuckets + d] = sum;
+            sum += count;
+          }
+        }
+
+        rkcommon::tasking::parallel_for(numBlocks, [&](size_t b) {
+          size_t *blockOffsets = offsets.data() + b * numBuckets;
+          const size_t end     = std::min(n, (b + 1) * sortBlockSize);
+          for (size_t i = b * sortBlockSize; i < end; ++i) {
+            sorted[blockOffsets[digit(keys[i], shift)]++] = keys[i];
+          }
+        });
+
+        keys.swap(sorted);
+      }
+    }
+
+  }  // namespace cpu_device
+}  // namespace openvkl
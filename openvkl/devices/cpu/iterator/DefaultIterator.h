@@ -10,6 +10,22 @@
 namespace openvkl {
   namespace cpu_device {
 
+    // Iterates up to maxCount intervals for a single ray, in one call into
+    // ISPC. Works for all interval iterators usable with the default hit
+    // iterator (see DefaultHitIteratorIntervalIterator). Intervals are still
+    // found one at a time by the varying iterate function.
+    template <int W>
+    inline unsigned int iterateDefaultIntervalsU(IntervalIterator<W> &iterator,
+                                                 vVKLIntervalN<1> *intervals,
+                                                 unsigned int maxCount)
+    {
+      return CALL_ISPC(DefaultIntervalIterator_iterateIntervals,
+                       iterator.getIspcStorage(),
+                       intervals,
+                       sizeof(vVKLIntervalN<1>),
+                       maxCount);
+    }
+
     template <int W>
     struct DefaultIntervalIterator : public IntervalIterator<W>
     {
@@ -25,6 +41,12 @@ namespace openvkl {
                             vVKLIntervalN<W> &interval,
                             vintn<W> &result) override final;
 
+      unsigned int iterateIntervalsU(vVKLIntervalN<1> *intervals,
+                                     unsigned int maxCount) override final
+      {
+        return iterateDefaultIntervalsU(*this, intervals, maxCount);
+      }
+
       void *getIspcStorage() override final
       {
         return reinterpret_cast<void *>(ispcStorage);
@@ -53,6 +75,9 @@ namespace openvkl {
                        vVKLHitN<W> &hit,
                        vintn<W> &result) override final;
 
+      unsigned int iterateHitsU(vVKLHitN<1> *hits,
+                                unsigned int maxCount) override final;
+
      protected:
       IntervalIterator intervalIterator;
 
@@ -105,5 +130,16 @@ namespace openvkl {
                 static_cast<int *>(result));
     }
 
+    template <int W, class IntervalIterator>
+    unsigned int DefaultHitIterator<W, IntervalIterator>::iterateHitsU(
+        vVKLHitN<1> *hits, unsigned int maxCount)
+    {
+      return CALL_ISPC(DefaultHitIterator_iterateHits,
+                       ispcStorage,
+                       hits,
+                       sizeof(vVKLHitN<1>),
+                       maxCount);
+    }
+
   }  // namespace cpu_device
 }  // namespace openvkl
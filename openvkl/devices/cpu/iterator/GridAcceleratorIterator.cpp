@@ -69,6 +69,17 @@ namespace openvkl {
                 static_cast<int *>(result));
     }
 
+    template <int W>
+    unsigned int GridAcceleratorIntervalIterator<W>::iterateIntervalsU(
+        vVKLIntervalN<1> *intervals, unsigned int maxCount)
+    {
+      return CALL_ISPC(GridAcceleratorIteratorU_iterateIntervals,
+                       ispcStorage,
+                       intervals,
+                       sizeof(vVKLIntervalN<1>),
+                       maxCount);
+    }
+
     template class GridAcceleratorIntervalIterator<VKL_TARGET_WIDTH>;
 
     __vkl_verify_max_interval_iterator_size(
@@ -135,6 +146,17 @@ namespace openvkl {
                 static_cast<int *>(result));
     }
 
+    template <int W>
+    unsigned int GridAcceleratorHitIterator<W>::iterateHitsU(
+        vVKLHitN<1> *hits, unsigned int maxCount)
+    {
+      return CALL_ISPC(GridAcceleratorIteratorU_iterateHits,
+                       ispcStorage,
+                       hits,
+                       sizeof(vVKLHitN<1>),
+                       maxCount);
+    }
+
     template class GridAcceleratorHitIterator<VKL_TARGET_WIDTH>;
 
     __vkl_verify_max_hit_iterator_size(GridAcceleratorHitIterator<VKL_TARGET_WIDTH>)
@@ -37,6 +37,9 @@ namespace openvkl {
       void iterateIntervalU(vVKLIntervalN<1> &interval,
                             vintn<1> &result) override final;
 
+      unsigned int iterateIntervalsU(vVKLIntervalN<1> *intervals,
+                                     unsigned int maxCount) override final;
+
       void *getIspcStorage() override final
       {
         return reinterpret_cast<void *>(ispcStorage);
@@ -81,6 +84,9 @@ namespace openvkl {
 
       void iterateHitU(vVKLHitN<1> &hit, vintn<1> &result) override final;
 
+      unsigned int iterateHitsU(vVKLHitN<1> *hits,
+                                unsigned int maxCount) override final;
+
      protected:
       using Iterator<W>::context;
       using IspcIterator = __varying_ispc_type(GridAcceleratorIterator);
@@ -101,10 +101,34 @@ namespace openvkl {
         interval.valueRange.lower[0] = intervalW.valueRange.lower[0];
         interval.valueRange.upper[0] = intervalW.valueRange.upper[0];
         interval.nominalDeltaT[0]    = intervalW.nominalDeltaT[0];
+        interval.majorant[0]         = intervalW.majorant[0];
 
         result[0] = resultW[0];
       }
 
+      /*
+       * Iterates up to maxCount intervals, returning the number written.
+       * Implementations with a uniform traversal should override this to
+       * return several intervals per call into ISPC; by default we repeat
+       * iterateIntervalU().
+       */
+      virtual unsigned int iterateIntervalsU(vVKLIntervalN<1> *intervals,
+                                             unsigned int maxCount)
+      {
+        unsigned int count = 0;
+        vintn<1> result;
+
+        while (count < maxCount) {
+          iterateIntervalU(intervals[count], result);
+          if (!result[0]) {
+            break;
+          }
+          count++;
+        }
+
+        return count;
+      }
+
       /*
        * Varying code path.
        */
@@ -203,6 +227,27 @@ namespace openvkl {
         result[0]      = resultW[0];
       }
 
+      /*
+       * Iterates up to maxCount hits, returning the number written. As for
+       * interval iterators, we repeat iterateHitU() by default.
+       */
+      virtual unsigned int iterateHitsU(vVKLHitN<1> *hits,
+                                        unsigned int maxCount)
+      {
+        unsigned int count = 0;
+        vintn<1> result;
+
+        while (count < maxCount) {
+          iterateHitU(hits[count], result);
+          if (!result[0]) {
+            break;
+          }
+          count++;
+        }
+
+        return count;
+      }
+
       /*
        * Varying code path.
        */
@@ -213,6 +213,57 @@ namespace openvkl {
           mapToMaxIteratorDepth(*this, intervalResolutionHint);
       const bool elementaryCellIteration = (intervalResolutionHint == 1.f);
 
+      // optional majorant transfer function
+      Ref<const DataT<float>> majorantTransferFunction =
+          this->template getParamDataT<float>("majorantTransferFunction",
+                                              nullptr);
+
+      range1f majorantValueRange(0.f, 1.f);
+      size_t numMajorantSamples = 0;
+      majorantTable.clear();
+
+      if (majorantTransferFunction) {
+        if (majorantTransferFunction->size() == 0) {
+          throw std::runtime_error(
+              "majorantTransferFunction must have at least one value");
+        }
+
+        majorantValueRange = this->template getParam<box1f>(
+            "majorantValueRange",
+            this->getSampler().getVolume().getValueRange(
+                this->attributeIndex));
+
+        if (!(majorantValueRange.lower < majorantValueRange.upper)) {
+          throw std::runtime_error("majorantValueRange must not be empty");
+        }
+
+        majorantTable.assign(majorantTransferFunction->begin(),
+                             majorantTransferFunction->end());
+
+        for (const float &v : majorantTable) {
+          if (!(v >= 0.f)) {
+            throw std::runtime_error(
+                "majorantTransferFunction values must be non-negative");
+          }
+        }
+
+        // sparse table for constant time range maximum queries: level k
+        // holds the maximum of the 2^k samples starting at each sample, and
+        // entries past the end of a level are unused.
+        numMajorantSamples = majorantTable.size();
+
+        for (size_t width = 2; width <= numMajorantSamples; width *= 2) {
+          const size_t previous = majorantTable.size() - numMajorantSamples;
+          majorantTable.resize(majorantTable.size() + numMajorantSamples, 0.f);
+
+          for (size_t i = 0; i + width <= numMajorantSamples; i++) {
+            majorantTable[previous + numMajorantSamples + i] =
+                std::max(majorantTable[previous + i],
+                         majorantTable[previous + i + width / 2]);
+          }
+        }
+      }
+
       if (this->SharedStructInitialized) {
         CALL_ISPC(IntervalIteratorContext_Destructor, this->getSh());
       }
@@ -224,6 +275,9 @@ namespace openvkl {
                 (const ispc::box1f *)valueRanges.data(),
                 maxIteratorDepth,
                 elementaryCellIteration,
+                numMajorantSamples,
+                majorantTable.data(),
+                (const ispc::box1f &)majorantValueRange,
                 this->getSh());
 
       this->SharedStructInitialized = true;
@@ -263,6 +317,9 @@ namespace openvkl {
         }
       }
 
+      const bool analyticHits =
+          this->template getParam<bool>("analyticHits", false);
+
       // default interval iterator depth used for hit iteration
       int maxIteratorDepth;
 
@@ -299,6 +356,7 @@ namespace openvkl {
                 values.size(),
                 (const float *)values.data(),
                 maxIteratorDepth,
+                analyticHits,
                 this->getSh());
 
       this->SharedStructInitialized = true;
@@ -7,6 +7,8 @@
 #include "../common/StructShared.h"
 #include "IteratorContextShared.h"
 
+#include <vector>
+
 using namespace rkcommon::math;
 
 namespace openvkl {
@@ -73,6 +75,12 @@ namespace openvkl {
       virtual ~IntervalIteratorContext();
 
       void commit() override;
+
+     private:
+      // optional majorant transfer function, as a sparse table for constant
+      // time range maximum queries in the iterators; see
+      // IteratorContextShared.h for the layout.
+      std::vector<float> majorantTable;
     };
 
     ///////////////////////////////////////////////////////////////////////////
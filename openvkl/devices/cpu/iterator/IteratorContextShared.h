@@ -56,6 +56,15 @@ namespace ispc {
   struct IntervalIteratorContext
   {
     VKL_INTEROP_UNIFORM IteratorContext super;
+
+    // optional majorant transfer function, sampled uniformly over
+    // majorantValueRange. majorantTable[k * numMajorantSamples + i] holds the
+    // maximum of the 2^k samples starting at sample i. If numMajorantSamples
+    // is zero, the majorant of an interval is the upper bound of its value
+    // range.
+    VKL_INTEROP_UNIFORM int numMajorantSamples;
+    const float *VKL_INTEROP_UNIFORM majorantTable;
+    VKL_INTEROP_UNIFORM box1f majorantValueRange;
   };
 #endif
 
@@ -71,6 +80,9 @@ namespace ispc {
 
     VKL_INTEROP_UNIFORM int numValues;
     float *VKL_INTEROP_UNIFORM values;
+
+    // intersect isosurfaces analytically, if supported by the sampler
+    VKL_INTEROP_UNIFORM bool analyticHits;
   };
 
 #endif
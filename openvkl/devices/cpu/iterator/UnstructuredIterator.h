@@ -28,6 +28,12 @@ namespace openvkl {
                             vVKLIntervalN<W> &interval,
                             vintn<W> &result) override final;
 
+      unsigned int iterateIntervalsU(vVKLIntervalN<1> *intervals,
+                                     unsigned int maxCount) override final
+      {
+        return iterateDefaultIntervalsU(*this, intervals, maxCount);
+      }
+
       void *getIspcStorage() override final
       {
         return reinterpret_cast<void*>(ispcStorage);
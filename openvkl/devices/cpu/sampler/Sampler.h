@@ -111,6 +111,26 @@ namespace openvkl {
                                     unsigned int attributeIndex,
                                     const float *times) const = 0;
 
+      // samplers can optionally compute samples and gradients together, e.g.
+      // from the same filter stencil; the default implementation uses
+      // computeSampleV() / computeSampleN() and computeGradientV() /
+      // computeGradientN()
+      virtual void computeSampleAndGradientV(
+          const vintn<W> &valid,
+          const vvec3fn<W> &objectCoordinates,
+          vfloatn<W> &samples,
+          vvec3fn<W> &gradients,
+          unsigned int attributeIndex,
+          const vfloatn<W> &times) const;
+
+      virtual void computeSampleAndGradientN(
+          unsigned int N,
+          const vvec3fn<1> *objectCoordinates,
+          float *samples,
+          vvec3fn<1> *gradients,
+          unsigned int attributeIndex,
+          const float *times) const;
+
       // multi-attribute //////////////////////////////////////////////////////
 
       virtual void computeSampleM(const vvec3fn<1> &objectCoordinates,
@@ -182,6 +202,33 @@ namespace openvkl {
       samples[0] = samplesW[0];
     }
 
+    template <int W>
+    inline void Sampler<W>::computeSampleAndGradientV(
+        const vintn<W> &valid,
+        const vvec3fn<W> &objectCoordinates,
+        vfloatn<W> &samples,
+        vvec3fn<W> &gradients,
+        unsigned int attributeIndex,
+        const vfloatn<W> &times) const
+    {
+      computeSampleV(valid, objectCoordinates, samples, attributeIndex, times);
+      computeGradientV(
+          valid, objectCoordinates, gradients, attributeIndex, times);
+    }
+
+    template <int W>
+    inline void Sampler<W>::computeSampleAndGradientN(
+        unsigned int N,
+        const vvec3fn<1> *objectCoordinates,
+        float *samples,
+        vvec3fn<1> *gradients,
+        unsigned int attributeIndex,
+        const float *times) const
+    {
+      computeSampleN(N, objectCoordinates, samples, attributeIndex, times);
+      computeGradientN(N, objectCoordinates, gradients, attributeIndex, times);
+    }
+
     template <int W>
     inline void Sampler<W>::computeSampleM(const vvec3fn<1> &objectCoordinates,
                                            float *samples,
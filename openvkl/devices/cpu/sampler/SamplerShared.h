@@ -10,6 +10,8 @@
 #ifdef __cplusplus
 namespace ispc {
 #else
+#include "openvkl/iterator.isph"
+#include "rkcommon/math/box.ih"
 #include "rkcommon/math/vec.ih"
 #endif  // __cplusplus
 
@@ -31,6 +33,8 @@ namespace ispc {
     void *computeSample_varying;
 
     void *computeGradient_varying;
+
+    void *intersectIsosurfaces_varying;
 #else
     uniform float (*uniform computeSample_uniform)(
         const SamplerShared *uniform _self,
@@ -47,6 +51,19 @@ namespace ispc {
     varying vec3f (*uniform computeGradient_varying)(
         const SamplerShared *uniform _self,
         const varying vec3f &objectCoordinates);
+
+    // optional; samplers may provide exact isosurface intersection for hit
+    // iterators. NULL if not supported.
+    varying bool (*uniform intersectIsosurfaces_varying)(
+        const SamplerShared *uniform _self,
+        const varying vec3f &origin,
+        const varying vec3f &direction,
+        const varying box1f &tRange,
+        const uniform uint32 attributeIndex,
+        const varying float &time,
+        const uniform int numValues,
+        const float *uniform values,
+        varying VKLHit &hit);
 #endif
 
     // Samplers may choose to implement these filter modes.
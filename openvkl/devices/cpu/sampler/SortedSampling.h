@@ -0,0 +1,171 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "../common/morton.h"
+#include "openvkl/common/math.h"
+#include "openvkl/common/simd.h"
+#include "rkcommon/tasking/parallel_for.h"
+
+namespace openvkl {
+  namespace cpu_device {
+
+    // Batches smaller than this are not worth sorting.
+    static constexpr unsigned int minSortedBatchSize = 4096;
+
+    /*
+     * Sort queries by the Morton code of their position, quantized to a
+     * 1024^3 grid over the given bounds, so that queries touching the same
+     * leaf node or brick are adjacent. The sort is stable, so queries within
+     * a grid cell keep their relative order.
+     *
+     * Returns one key per query, in sorted order; the original index of a
+     * query is held in the upper 32 bits of its key.
+     */
+    inline std::vector<uint64_t> computeQueryOrder(
+        const box3f &bounds,
+        unsigned int N,
+        const vvec3fn<1> *objectCoordinates)
+    {
+      constexpr uint32_t gridBits = 10;
+      const float gridRes         = float(1u << gridBits);
+      const vec3f size            = bounds.size();
+      const vec3f scale(gridRes / std::max(size.x, 1e-20f),
+                        gridRes / std::max(size.y, 1e-20f),
+                        gridRes / std::max(size.z, 1e-20f));
+
+      // Keys hold the query index in the upper 32 bits, and the Morton code
+      // of its grid cell in the lower 3 * gridBits bits.
+      std::vector<uint64_t> keys(N);
+      rkcommon::tasking::parallel_for(N, [&](unsigned int i) {
+        const vvec3fn<1> &p = objectCoordinates[i];
+        const vec3f g =
+            (vec3f(p.x[0], p.y[0], p.z[0]) - bounds.lower) * scale;
+        const auto quantize = [&](float v) -> uint32_t {
+          // Also maps NaN to zero.
+          return v > 0.f ? uint32_t(std::min(v, gridRes - 1.f)) : 0u;
+        };
+        keys[i] = (uint64_t(i) << 32) |
+                  mortonEncode(vec3ui(
+                      quantize(g.x), quantize(g.y), quantize(g.z)));
+      });
+
+      parallelRadixSort(keys, 3 * gridBits);
+
+      return keys;
+    }
+
+    /*
+     * Gather query coordinates and times in the order given by keys.
+     */
+    inline void gatherSortedQueries(const std::vector<uint64_t> &keys,
+                                    const vvec3fn<1> *objectCoordinates,
+                                    const float *times,
+                                    std::vector<vvec3fn<1>> &sortedCoordinates,
+                                    std::vector<float> &sortedTimes)
+    {
+      const size_t N = keys.size();
+      sortedCoordinates.resize(N);
+      sortedTimes.resize(times ? N : 0);
+
+      rkcommon::tasking::parallel_for(N, [&](size_t i) {
+        const uint32_t j     = uint32_t(keys[i] >> 32);
+        sortedCoordinates[i] = objectCoordinates[j];
+        if (times) {
+          sortedTimes[i] = times[j];
+        }
+      });
+    }
+
+    /*
+     * Sample a large batch of unordered queries in spatially coherent order
+     * (see computeQueryOrder()), so that queries touching the same leaf node
+     * or brick are sampled back to back and hit the cache. Results are
+     * scattered back to the original query order.
+     *
+     * sampleN(N, objectCoordinates, times, results) must sample a contiguous
+     * batch of queries.
+     */
+    template <typename ResultT, typename SampleNFunc>
+    inline void computeSortedN(const box3f &bounds,
+                               unsigned int N,
+                               const vvec3fn<1> *objectCoordinates,
+                               const float *times,
+                               ResultT *results,
+                               SampleNFunc &&sampleN)
+    {
+      if (N < minSortedBatchSize || bounds.empty()) {
+        sampleN(N, objectCoordinates, times, results);
+        return;
+      }
+
+      const std::vector<uint64_t> keys =
+          computeQueryOrder(bounds, N, objectCoordinates);
+
+      std::vector<vvec3fn<1>> sortedCoordinates;
+      std::vector<float> sortedTimes;
+      gatherSortedQueries(
+          keys, objectCoordinates, times, sortedCoordinates, sortedTimes);
+
+      std::vector<ResultT> sortedResults(N);
+
+      sampleN(N,
+              sortedCoordinates.data(),
+              times ? sortedTimes.data() : nullptr,
+              sortedResults.data());
+
+      rkcommon::tasking::parallel_for(N, [&](unsigned int i) {
+        results[keys[i] >> 32] = sortedResults[i];
+      });
+    }
+
+    /*
+     * As above, for queries producing two results each (e.g. a sample and a
+     * gradient).
+     *
+     * sampleN(N, objectCoordinates, times, results0, results1) must sample a
+     * contiguous batch of queries.
+     */
+    template <typename ResultT0, typename ResultT1, typename SampleNFunc>
+    inline void computeSortedN(const box3f &bounds,
+                               unsigned int N,
+                               const vvec3fn<1> *objectCoordinates,
+                               const float *times,
+                               ResultT0 *results0,
+                               ResultT1 *results1,
+                               SampleNFunc &&sampleN)
+    {
+      if (N < minSortedBatchSize || bounds.empty()) {
+        sampleN(N, objectCoordinates, times, results0, results1);
+        return;
+      }
+
+      const std::vector<uint64_t> keys =
+          computeQueryOrder(bounds, N, objectCoordinates);
+
+      std::vector<vvec3fn<1>> sortedCoordinates;
+      std::vector<float> sortedTimes;
+      gatherSortedQueries(
+          keys, objectCoordinates, times, sortedCoordinates, sortedTimes);
+
+      std::vector<ResultT0> sortedResults0(N);
+      std::vector<ResultT1> sortedResults1(N);
+
+      sampleN(N,
+              sortedCoordinates.data(),
+              times ? sortedTimes.data() : nullptr,
+              sortedResults0.data(),
+              sortedResults1.data());
+
+      rkcommon::tasking::parallel_for(N, [&](unsigned int i) {
+        const uint32_t j = uint32_t(keys[i] >> 32);
+        results0[j]      = sortedResults0[i];
+        results1[j]      = sortedResults1[i];
+      });
+    }
+
+  }  // namespace cpu_device
+}  // namespace openvkl
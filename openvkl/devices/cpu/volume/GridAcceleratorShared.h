@@ -3,6 +3,9 @@
 
 #pragma once
 
+// maximum number of levels in the min/max hierarchy above the macrocells
+#define GRID_ACCELERATOR_MAX_SUPER_LEVELS 16
+
 #ifdef __cplusplus
 namespace ispc {
 #endif  // __cplusplus
@@ -15,6 +18,17 @@ namespace ispc {
     VKL_INTEROP_UNIFORM size_t cellCount;
     box1f *VKL_INTEROP_UNIFORM cellValueRanges;
     SharedStructuredVolume *VKL_INTEROP_UNIFORM volume;
+
+    // min/max hierarchy above the macrocells: a super cell on level l covers
+    // 4^l macrocells per dimension. super cells are stored level by level,
+    // in x-fastest order within each level.
+    VKL_INTEROP_UNIFORM uint32 numSuperLevels;
+    VKL_INTEROP_UNIFORM vec3i
+        superLevelDimensions[GRID_ACCELERATOR_MAX_SUPER_LEVELS];
+    VKL_INTEROP_UNIFORM uint32
+        superLevelOffsets[GRID_ACCELERATOR_MAX_SUPER_LEVELS];
+    VKL_INTEROP_UNIFORM uint32 superCellCount;
+    box1f *VKL_INTEROP_UNIFORM superCellValueRanges;
   };
 
 #ifdef __cplusplus
@@ -7,6 +7,7 @@
 #include "../iterator/DefaultIterator.h"
 #include "../iterator/GridAcceleratorIterator.h"
 #include "../sampler/Sampler.h"
+#include "../sampler/SortedSampling.h"
 #include "Sampler_ispc.h"
 #include "SharedStructuredVolume_ispc.h"
 #include "StructuredRegularVolume.h"
@@ -67,6 +68,22 @@ namespace openvkl {
                             unsigned int attributeIndex,
                             const float *times) const override final;
 
+      void computeSampleAndGradientV(
+          const vintn<W> &valid,
+          const vvec3fn<W> &objectCoordinates,
+          vfloatn<W> &samples,
+          vvec3fn<W> &gradients,
+          unsigned int attributeIndex,
+          const vfloatn<W> &time) const override final;
+
+      void computeSampleAndGradientN(
+          unsigned int N,
+          const vvec3fn<1> *objectCoordinates,
+          float *samples,
+          vvec3fn<1> *gradients,
+          unsigned int attributeIndex,
+          const float *times) const override final;
+
       // multi-attribute //////////////////////////////////////////////////////
 
       void computeSampleM(const vvec3fn<1> &objectCoordinates,
@@ -99,6 +116,7 @@ namespace openvkl {
 
       VKLFilter filter;
       VKLFilter gradientFilter;
+      bool sortQueries{false};
     };
 
     // Inlined definitions ////////////////////////////////////////////////////
@@ -153,6 +171,8 @@ namespace openvkl {
                 this->getSh(),
                 (ispc::VKLFilter)filter,
                 (ispc::VKLFilter)gradientFilter);
+
+      sortQueries = this->template getParam<bool>("sortQueries", false);
     }
 
     template <int W,
@@ -216,13 +236,30 @@ namespace openvkl {
     {
       assert(attributeIndex < volume->getNumAttributes());
       assertAllValidTimes(N, times);
-      CALL_ISPC(SharedStructuredVolume_sample_N_export,
-                this->getSh(),
-                N,
-                (ispc::vec3f *)objectCoordinates,
-                attributeIndex,
-                times,
-                samples);
+
+      auto sampleN = [&](unsigned int n,
+                         const vvec3fn<1> *coordinates,
+                         const float *t,
+                         float *s) {
+        CALL_ISPC(SharedStructuredVolume_sample_N_export,
+                  this->getSh(),
+                  n,
+                  (ispc::vec3f *)coordinates,
+                  attributeIndex,
+                  t,
+                  s);
+      };
+
+      if (sortQueries) {
+        computeSortedN(volume->getBoundingBox(),
+                       N,
+                       objectCoordinates,
+                       times,
+                       samples,
+                       sampleN);
+      } else {
+        sampleN(N, objectCoordinates, times, samples);
+      }
     }
 
     template <int W,
@@ -264,13 +301,101 @@ namespace openvkl {
     {
       assert(attributeIndex < volume->getNumAttributes());
       assertAllValidTimes(N, times);
-      CALL_ISPC(SharedStructuredVolume_gradient_N_export,
+
+      auto gradientN = [&](unsigned int n,
+                           const vvec3fn<1> *coordinates,
+                           const float *t,
+                           vvec3fn<1> *g) {
+        CALL_ISPC(SharedStructuredVolume_gradient_N_export,
+                  this->getSh(),
+                  n,
+                  (ispc::vec3f *)coordinates,
+                  attributeIndex,
+                  t,
+                  (ispc::vec3f *)g);
+      };
+
+      if (sortQueries) {
+        computeSortedN(volume->getBoundingBox(),
+                       N,
+                       objectCoordinates,
+                       times,
+                       gradients,
+                       gradientN);
+      } else {
+        gradientN(N, objectCoordinates, times, gradients);
+      }
+    }
+
+    template <int W,
+              template <int>
+              class IntervalIteratorFactory,
+              template <int>
+              class HitIteratorFactory>
+    inline void
+    StructuredSampler<W, IntervalIteratorFactory, HitIteratorFactory>::
+        computeSampleAndGradientV(const vintn<W> &valid,
+                                  const vvec3fn<W> &objectCoordinates,
+                                  vfloatn<W> &samples,
+                                  vvec3fn<W> &gradients,
+                                  unsigned int attributeIndex,
+                                  const vfloatn<W> &time) const
+    {
+      assert(attributeIndex < volume->getNumAttributes());
+      assertValidTimes(valid, time);
+      CALL_ISPC(SharedStructuredVolume_sampleAndGradient_export,
+                static_cast<const int *>(valid),
                 this->getSh(),
-                N,
-                (ispc::vec3f *)objectCoordinates,
+                &objectCoordinates,
                 attributeIndex,
-                times,
-                (ispc::vec3f *)gradients);
+                &time,
+                &samples,
+                &gradients);
+    }
+
+    template <int W,
+              template <int>
+              class IntervalIteratorFactory,
+              template <int>
+              class HitIteratorFactory>
+    inline void
+    StructuredSampler<W, IntervalIteratorFactory, HitIteratorFactory>::
+        computeSampleAndGradientN(unsigned int N,
+                                  const vvec3fn<1> *objectCoordinates,
+                                  float *samples,
+                                  vvec3fn<1> *gradients,
+                                  unsigned int attributeIndex,
+                                  const float *times) const
+    {
+      assert(attributeIndex < volume->getNumAttributes());
+      assertAllValidTimes(N, times);
+
+      auto sampleAndGradientN = [&](unsigned int n,
+                                    const vvec3fn<1> *coordinates,
+                                    const float *t,
+                                    float *s,
+                                    vvec3fn<1> *g) {
+        CALL_ISPC(SharedStructuredVolume_sampleAndGradient_N_export,
+                  this->getSh(),
+                  n,
+                  (ispc::vec3f *)coordinates,
+                  attributeIndex,
+                  t,
+                  s,
+                  (ispc::vec3f *)g);
+      };
+
+      if (sortQueries) {
+        computeSortedN(volume->getBoundingBox(),
+                       N,
+                       objectCoordinates,
+                       times,
+                       samples,
+                       gradients,
+                       sampleAndGradientN);
+      } else {
+        sampleAndGradientN(N, objectCoordinates, times, samples, gradients);
+      }
     }
 
     template <int W,
@@ -5,6 +5,7 @@
 
 #include "../common/Data.h"
 #include "../common/export_util.h"
+#include "../common/logging.h"
 #include "../common/math.h"
 #include "../common/temporal_data_verification.h"
 #include "GridAccelerator_ispc.h"
@@ -49,6 +50,17 @@ namespace openvkl {
 
       std::vector<range1f> valueRanges;
 
+      // parameters of the last accelerator build; modified regions can only
+      // be updated in place if these are unchanged
+      vec3i acceleratorDimensions{0};
+      std::vector<Ref<const Data>> acceleratorData;
+      int acceleratorNumTimesteps{0};
+      Ref<const Data> acceleratorUnstructuredIndices;
+      Ref<const DataT<float>> acceleratorUnstructuredTimes;
+
+      // modified regions only apply to the commit they were set for
+      Ref<const DataT<box3i>> consumedModifiedRegions;
+
       // parameters set in commit()
       vec3i dimensions;
       vec3f gridOrigin;
@@ -60,6 +72,11 @@ namespace openvkl {
       VKLFilter filter{VKL_FILTER_TRILINEAR};
       VKLFilter gradientFilter{VKL_FILTER_TRILINEAR};
       Ref<const DataT<float>> background;
+      Ref<const DataT<box3i>> modifiedRegions;
+
+     private:
+      bool canUpdateAccelerator() const;
+      void updateAccelerator(void *accelerator);
     };
 
     // Inlined definitions ////////////////////////////////////////////////////
@@ -113,6 +130,9 @@ namespace openvkl {
       background = this->template getParamDataT<float>(
           "background", attributesData.size(), VKL_BACKGROUND_UNDEFINED);
 
+      modifiedRegions =
+          this->template getParamDataT<box3i>("modifiedRegions", nullptr);
+
       // validate type of each provided attribute; size validated depending on
       // temporal configuration
       const std::vector<VKLDataType> supportedDataTypes{
@@ -182,11 +202,61 @@ namespace openvkl {
       return valueRanges[attributeIndex];
     }
 
+    template <int W>
+    inline bool StructuredVolume<W>::canUpdateAccelerator() const
+    {
+      // the regions must describe in place modifications of the voxel data
+      // the accelerator was built from, since the previous commit
+      if (!modifiedRegions ||
+          modifiedRegions.ptr == consumedModifiedRegions.ptr ||
+          !this->getSh()->accelerator || dimensions != acceleratorDimensions ||
+          attributesData.size() != acceleratorData.size() ||
+          temporallyStructuredNumTimesteps != acceleratorNumTimesteps ||
+          temporallyUnstructuredIndices.ptr !=
+              acceleratorUnstructuredIndices.ptr ||
+          temporallyUnstructuredTimes.ptr !=
+              acceleratorUnstructuredTimes.ptr) {
+        return false;
+      }
+
+      for (size_t i = 0; i < attributesData.size(); i++) {
+        if (attributesData[i].ptr != acceleratorData[i].ptr) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
     template <int W>
     inline void StructuredVolume<W>::buildAccelerator()
     {
-      void *accelerator = CALL_ISPC(SharedStructuredVolume_createAccelerator,
-                                    this->getSh());
+      void *accelerator = this->getSh()->accelerator;
+
+      const bool update = canUpdateAccelerator();
+
+      // a region list that is still set from an earlier commit does not
+      // describe the modifications since the previous one
+      if (modifiedRegions && !update) {
+        postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+            << this->toString()
+            << ": ignoring modifiedRegions, rebuilding the accelerator";
+      }
+      consumedModifiedRegions = modifiedRegions;
+
+      if (update) {
+        updateAccelerator(accelerator);
+        return;
+      }
+
+      accelerator = CALL_ISPC(SharedStructuredVolume_createAccelerator,
+                              this->getSh());
+
+      acceleratorDimensions          = dimensions;
+      acceleratorData                = attributesData;
+      acceleratorNumTimesteps        = temporallyStructuredNumTimesteps;
+      acceleratorUnstructuredIndices = temporallyUnstructuredIndices;
+      acceleratorUnstructuredTimes   = temporallyUnstructuredTimes;
 
       vec3i bricksPerDimension;
       bricksPerDimension.x =
@@ -202,6 +272,20 @@ namespace openvkl {
         CALL_ISPC(GridAccelerator_build, accelerator, taskIndex);
       });
 
+      // the min/max hierarchy above the macrocells is built bottom up, as
+      // each level is computed from the one below
+      const int numSuperLevels =
+          CALL_ISPC(GridAccelerator_getNumSuperLevels, accelerator);
+
+      for (int level = 1; level <= numSuperLevels; level++) {
+        const int numSuperCells = CALL_ISPC(
+            GridAccelerator_getSuperLevelCellCount, accelerator, level);
+        tasking::parallel_for(numSuperCells, [&](int taskIndex) {
+          CALL_ISPC(
+              GridAccelerator_buildSuperLevel, accelerator, level, taskIndex);
+        });
+      }
+
       valueRanges.resize(getNumAttributes());
 
       for (unsigned int a = 0; a < getNumAttributes(); a++) {
@@ -213,5 +297,69 @@ namespace openvkl {
       }
     }
 
+    template <int W>
+    inline void StructuredVolume<W>::updateAccelerator(void *accelerator)
+    {
+      const int numSuperLevels =
+          CALL_ISPC(GridAccelerator_getNumSuperLevels, accelerator);
+
+      // level 0 are the macrocells, followed by the levels of the min/max
+      // hierarchy; as for a full build, each level is updated from the one
+      // below
+      uint64_t numUpdatedCells = 0;
+
+      for (int level = 0; level <= numSuperLevels; level++) {
+        for (const box3i &region : *modifiedRegions) {
+          if (region.empty()) {
+            continue;
+          }
+
+          vec3i cellLower;
+          vec3i cellUpper;
+          CALL_ISPC(GridAccelerator_getRegionCells,
+                    accelerator,
+                    level,
+                    reinterpret_cast<const ispc::vec3i &>(region.lower),
+                    reinterpret_cast<const ispc::vec3i &>(region.upper),
+                    reinterpret_cast<ispc::vec3i &>(cellLower),
+                    reinterpret_cast<ispc::vec3i &>(cellUpper));
+
+          if (cellLower.x > cellUpper.x || cellLower.y > cellUpper.y ||
+              cellLower.z > cellUpper.z) {
+            continue;
+          }
+
+          const uint64_t numCells =
+              (cellUpper - cellLower + 1).long_product();
+
+          tasking::parallel_for(numCells, [&](uint64_t taskIndex) {
+            CALL_ISPC(GridAccelerator_buildRegion,
+                      accelerator,
+                      level,
+                      reinterpret_cast<const ispc::vec3i &>(cellLower),
+                      reinterpret_cast<const ispc::vec3i &>(cellUpper),
+                      taskIndex);
+          });
+
+          if (level == 0) {
+            numUpdatedCells += numCells;
+          }
+        }
+      }
+
+      for (unsigned int a = 0; a < getNumAttributes(); a++) {
+        CALL_ISPC(GridAccelerator_getRootValueRange,
+                  accelerator,
+                  a,
+                  valueRanges[a].lower,
+                  valueRanges[a].upper);
+      }
+
+      postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+          << this->toString() << ": updated " << numUpdatedCells
+          << " macrocells in " << modifiedRegions->size()
+          << " modified regions";
+    }
+
   }  // namespace cpu_device
 }  // namespace openvkl
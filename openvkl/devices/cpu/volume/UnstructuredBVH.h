@@ -4,9 +4,13 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <vector>
 #include "../common/math.h"
+#include "UnstructuredVolumeBaseShared.h"
 #include "embree4/rtcore.h"
+#include "rkcommon/containers/AlignedVector.h"
 #include "rkcommon/tasking/parallel_for.h"
 
 namespace openvkl {
@@ -326,5 +330,316 @@ namespace openvkl {
       }
     }
 
+    inline size_t getNumInnerNodes(const Node *root)
+    {
+      if (isLeafNode(root)) {
+        return 0;
+      }
+
+      auto inner = (const InnerNode *)root;
+      return 1 + getNumInnerNodes(inner->children[0]) +
+             getNumInnerNodes(inner->children[1]);
+    }
+
+    // Wide BVH ///////////////////////////////////////////////////////////////
+
+    // Wide BVH for point location, built by collapsing the binary BVH produced
+    // by Embree. Each wide node has up to VKL_BVH_WIDTH children, so traversal
+    // visits fewer nodes than in the binary BVH. Leaves are shared with the
+    // binary BVH, which must outlive this object; the binary BVH is still used
+    // for interval and hit iteration.
+    struct WideBVH
+    {
+      void build(Node *root)
+      {
+        nodes.clear();
+
+        // reserve all nodes up front, so that child pointers stay valid
+        nodes.reserve(getNumInnerNodes(root) + 1);
+        collapse(root);
+      }
+
+      void clear()
+      {
+        nodes.clear();
+        nodes.shrink_to_fit();
+      }
+
+      ispc::WideNode *getRoot()
+      {
+        return nodes.empty() ? nullptr : nodes.data();
+      }
+
+     private:
+      static float halfArea(const box3f &b)
+      {
+        const vec3f e = b.upper - b.lower;
+        return e.x * e.y + e.y * e.z + e.z * e.x;
+      }
+
+      // collapses the subtree at the given node into a new wide node, and
+      // returns its index
+      size_t collapse(Node *node)
+      {
+        const size_t index = nodes.size();
+        nodes.emplace_back();
+
+        Node *children[VKL_BVH_WIDTH];
+        int numChildren = 0;
+
+        if (isLeafNode(node)) {
+          // only for a root leaf
+          children[numChildren++] = node;
+        } else {
+          children[numChildren++] = ((InnerNode *)node)->children[0];
+          children[numChildren++] = ((InnerNode *)node)->children[1];
+
+          // pull up the children of the largest inner child until the node is
+          // full
+          while (numChildren < VKL_BVH_WIDTH) {
+            int largest       = -1;
+            float largestArea = -1.f;
+
+            for (int i = 0; i < numChildren; i++) {
+              if (!isLeafNode(children[i])) {
+                const float area = halfArea(getNodeBounds(children[i]));
+                if (area > largestArea) {
+                  largest     = i;
+                  largestArea = area;
+                }
+              }
+            }
+
+            if (largest < 0) {
+              break;
+            }
+
+            InnerNode *opened       = (InnerNode *)children[largest];
+            children[largest]       = opened->children[0];
+            children[numChildren++] = opened->children[1];
+          }
+        }
+
+        ispc::WideNode &wide = nodes[index];
+        wide.leafMask        = 0;
+
+        for (int i = 0; i < VKL_BVH_WIDTH; i++) {
+          const box3f bounds =
+              i < numChildren ? getNodeBounds(children[i]) : box3f(empty);
+
+          wide.lowerX[i]   = bounds.lower.x;
+          wide.lowerY[i]   = bounds.lower.y;
+          wide.lowerZ[i]   = bounds.lower.z;
+          wide.upperX[i]   = bounds.upper.x;
+          wide.upperY[i]   = bounds.upper.y;
+          wide.upperZ[i]   = bounds.upper.z;
+          wide.children[i] = nullptr;
+
+          if (i < numChildren && isLeafNode(children[i])) {
+            wide.leafMask |= 1u << i;
+            wide.children[i] = children[i];
+          }
+        }
+
+        for (int i = 0; i < numChildren; i++) {
+          if (!isLeafNode(children[i])) {
+            const size_t childIndex  = collapse(children[i]);
+            nodes[index].children[i] = &nodes[childIndex];
+          }
+        }
+
+        return index;
+      }
+
+      rkcommon::containers::AlignedVector<ispc::WideNode> nodes;
+    };
+
+    // Compact BVH ////////////////////////////////////////////////////////////
+
+    // Compact copy of a binary BVH with single-cell leaves, including all node
+    // metadata, in a flat array of 32-byte nodes. Once built, the binary BVH
+    // is no longer needed for sampling or iteration. All encodings are
+    // conservative: decoded bounds and value ranges contain the original ones.
+    struct CompactBVH
+    {
+      void build(const Node *root, const box3f &bounds)
+      {
+        nodes.clear();
+        nodes.reserve(2 * getNumInnerNodes(root) + 1);
+
+        origin  = bounds.lower;
+        extent  = bounds.upper - bounds.lower;
+        spacing = extent / float(latticeMax);
+
+        // the last lattice point must not fall short of the volume bounds
+        for (int d = 0; d < 3; d++) {
+          while (origin[d] + float(latticeMax) * spacing[d] <
+                 bounds.upper[d]) {
+            spacing[d] = std::nextafter(spacing[d], inf);
+          }
+          spacing[d] = std::nextafter(spacing[d], inf);
+        }
+
+        nodes.emplace_back();
+        encode(root, 0, 0);
+      }
+
+      void clear()
+      {
+        nodes.clear();
+        nodes.shrink_to_fit();
+      }
+
+      ispc::CompactNode *getRoot()
+      {
+        return nodes.empty() ? nullptr : nodes.data();
+      }
+
+      const vec3f &getOrigin() const
+      {
+        return origin;
+      }
+
+      const vec3f &getSpacing() const
+      {
+        return spacing;
+      }
+
+      const vec3f &getExtent() const
+      {
+        return extent;
+      }
+
+     private:
+      static constexpr int latticeMax = 0xffff;
+
+      void encode(const Node *node, uint32_t index, uint32_t parent)
+      {
+        const box3f bounds = getNodeBounds(node);
+        const bool isLeaf  = isLeafNode(node);
+
+        ispc::CompactNode &compact = nodes[index];
+
+        for (int d = 0; d < 3; d++) {
+          compact.lower[d] = quantize(bounds.lower[d], d, false);
+          compact.upper[d] = quantize(bounds.upper[d], d, true);
+
+          const float relativeLength =
+              extent[d] > 0.f ? std::fabs(node->nominalLength[d]) / extent[d]
+                              : 0.f;
+          compact.nominalLength[d] = floatToHalfUp(relativeLength);
+        }
+
+        if (isLeaf) {
+          compact.nominalLength[0] |= 0x8000;
+        }
+
+        compact.valueRange[0] = floatToHalfDown(node->valueRange.lower);
+        compact.valueRange[1] = floatToHalfUp(node->valueRange.upper);
+        compact.level         = node->level;
+        compact.parent        = parent;
+
+        if (isLeaf) {
+          compact.child = ((const LeafNodeSingle *)node)->cellID;
+          return;
+        }
+
+        // children are adjacent; nodes are reserved up front, so the
+        // reference above is still valid
+        const uint32_t first = nodes.size();
+        compact.child        = first;
+
+        nodes.emplace_back();
+        nodes.emplace_back();
+
+        auto inner = (const InnerNode *)node;
+        encode(inner->children[0], first, index);
+        encode(inner->children[1], first + 1, index);
+      }
+
+      uint16_t quantize(float x, int d, bool roundUp) const
+      {
+        if (spacing[d] == 0.f) {
+          return 0;
+        }
+
+        const float t = (x - origin[d]) / spacing[d];
+
+        // one lattice step of slack, so that bounds remain conservative
+        // regardless of rounding when decoding
+        const int q = roundUp ? int(std::ceil(t)) + 1 : int(std::floor(t)) - 1;
+
+        return uint16_t(std::min(std::max(q, 0), int(latticeMax)));
+      }
+
+      // IEEE 754 binary16 conversions. floatToHalfDown() and floatToHalfUp()
+      // round towards negative and positive infinity, respectively.
+
+      static float halfToFloat(uint16_t h)
+      {
+        const uint32_t sign     = uint32_t(h & 0x8000) << 16;
+        const uint32_t exponent = (h >> 10) & 0x1f;
+        const uint32_t mantissa = h & 0x3ff;
+
+        if (exponent == 0) {
+          const float f = std::ldexp(float(mantissa), -24);
+          return sign ? -f : f;
+        }
+
+        const uint32_t bits = sign |
+                              (exponent == 0x1f ? (0xffu << 23)
+                                                : ((exponent + 112) << 23)) |
+                              (mantissa << 13);
+
+        float f;
+        std::memcpy(&f, &bits, sizeof(float));
+        return f;
+      }
+
+      // rounds towards zero
+      static uint16_t floatToHalfTruncated(float f)
+      {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(float));
+
+        const uint16_t sign     = (bits >> 16) & 0x8000;
+        const int exponent      = int((bits >> 23) & 0xff) - 127 + 15;
+        const uint32_t mantissa = bits & 0x7fffff;
+
+        if (std::isnan(f)) {
+          return sign | 0x7e00;
+        } else if (exponent >= 0x1f) {
+          return sign | (std::isinf(f) ? 0x7c00 : 0x7bff);
+        } else if (exponent <= 0) {
+          // subnormal or zero
+          return exponent < -10
+                     ? sign
+                     : sign | ((mantissa | 0x800000) >> (14 - exponent));
+        }
+
+        return sign | (exponent << 10) | (mantissa >> 13);
+      }
+
+      // truncation only needs to step away from zero, which for both signs is
+      // the next larger bit pattern
+      static uint16_t floatToHalfDown(float f)
+      {
+        const uint16_t h = floatToHalfTruncated(f);
+        return halfToFloat(h) > f ? h + 1 : h;
+      }
+
+      static uint16_t floatToHalfUp(float f)
+      {
+        const uint16_t h = floatToHalfTruncated(f);
+        return halfToFloat(h) < f ? h + 1 : h;
+      }
+
+      rkcommon::containers::AlignedVector<ispc::CompactNode> nodes;
+
+      vec3f origin{0.f};
+      vec3f spacing{0.f};
+      vec3f extent{0.f};
+    };
+
   }  // namespace cpu_device
 }  // namespace openvkl
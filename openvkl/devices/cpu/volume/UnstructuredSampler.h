@@ -16,6 +16,19 @@
 namespace openvkl {
   namespace cpu_device {
 
+    /*
+     * Each thread keeps the cell that contained its last sample in a hint,
+     * across sampling calls. Hints are tagged with an id of the volume commit
+     * they were filled for, so they are invalidated when a thread switches
+     * volumes, or a volume is recommitted.
+     */
+    inline ispc::UnstructuredCellHint *getThreadCellHint()
+    {
+      static thread_local ispc::UnstructuredCellHint hint = {
+          0, VKL_CELL_NO_NEIGHBOR};
+      return &hint;
+    }
+
     template <int W>
     using UnstructuredSamplerBase = SamplerBase<W,
                              UnstructuredVolume,
@@ -89,7 +102,8 @@ namespace openvkl {
                 static_cast<const int *>(valid),
                 this->getSh(),
                 &objectCoordinates,
-                &samples);
+                &samples,
+                getThreadCellHint());
     }
 
     template <int W>
@@ -102,11 +116,12 @@ namespace openvkl {
     {
       assert(attributeIndex < volume->getNumAttributes());
       assertAllValidTimes(N, times);
-      CALL_ISPC(Sampler_sample_N_export,
+      CALL_ISPC(VKLUnstructuredVolume_sample_N_export,
                 this->getSh(),
                 N,
                 (ispc::vec3f *)objectCoordinates,
-                samples);
+                samples,
+                getThreadCellHint());
     }
 
     template <int W>
@@ -123,7 +138,8 @@ namespace openvkl {
                 static_cast<const int *>(valid),
                 this->getSh(),
                 &objectCoordinates,
-                &gradients);
+                &gradients,
+                getThreadCellHint());
     }
 
     template <int W>
@@ -136,11 +152,12 @@ namespace openvkl {
     {
       assert(attributeIndex < volume->getNumAttributes());
       assertAllValidTimes(N, times);
-      CALL_ISPC(Sampler_gradient_N_export,
+      CALL_ISPC(VKLUnstructuredVolume_gradient_N_export,
                 this->getSh(),
                 N,
                 (ispc::vec3f *)objectCoordinates,
-                (ispc::vec3f *)gradients);
+                (ispc::vec3f *)gradients,
+                getThreadCellHint());
     }
 
   }  // namespace cpu_device
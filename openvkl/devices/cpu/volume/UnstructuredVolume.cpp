@@ -3,7 +3,10 @@
 
 #include "UnstructuredVolume.h"
 #include <algorithm>
+#include <atomic>
+#include <limits>
 #include "../common/Data.h"
+#include "../common/morton.h"
 #include "UnstructuredSampler.h"
 #include "rkcommon/containers/AlignedVector.h"
 #include "rkcommon/tasking/parallel_for.h"
@@ -29,6 +32,43 @@ inline uint32_t getVerticesCount(uint8_t cellType)
 namespace openvkl {
   namespace cpu_device {
 
+    static uint64_t newCellHintId(bool traversalCache)
+    {
+      // Zero disables cell hints, and marks an empty hint.
+      static std::atomic<uint64_t> nextId{1};
+      return traversalCache ? nextId++ : 0;
+    }
+
+    // Copy of data in the given order, as a new compact array.
+    template <typename T>
+    static Ref<const DataT<T>> gatherData(const DataT<T> &data,
+                                          const std::vector<uint64_t> &order)
+    {
+      DataT<T> *gathered = new DataT<T>(order.size());
+
+      tasking::parallel_for(order.size(), [&](uint64_t i) {
+        (*gathered)[i] = data[order[i]];
+      });
+
+      Ref<const DataT<T>> ref = gathered;
+      gathered->refDec();
+      return ref;
+    }
+
+    template <typename T>
+    static Ref<const DataT<T>> convertData(const std::vector<uint64_t> &values)
+    {
+      DataT<T> *converted = new DataT<T>(values.size());
+
+      tasking::parallel_for(values.size(), [&](uint64_t i) {
+        (*converted)[i] = T(values[i]);
+      });
+
+      Ref<const DataT<T>> ref = converted;
+      converted->refDec();
+      return ref;
+    }
+
     static void tabIndent(int indent)
     {
       for (int i = 0; i < indent; i++)
@@ -171,6 +211,10 @@ namespace openvkl {
         d->refDec();
       }
 
+      if (this->template getParam<bool>("spatialReorder", false)) {
+        reorderCellsAndVertices();
+      }
+
       hexIterative = this->template getParam<bool>("hexIterative", false);
 
       bool needTolerances = false;
@@ -199,10 +243,36 @@ namespace openvkl {
         }
       }
 
+      if (this->template getParam<bool>("cellAdjacency", false)) {
+        buildCellNeighbors();
+      } else if (!cellNeighbors.empty()) {
+        cellNeighbors.clear();
+        cellNeighbors.shrink_to_fit();
+      }
+
+      compactBVH = this->template getParam<bool>("compactBVH", false);
+      // node indices are 32-bit, and the tree has 2 * nCells - 1 nodes
+      if (compactBVH && nCells > (uint64_t(1) << 31)) {
+        throw std::runtime_error(
+            "unstructured volume compactBVH supports at most 2^31 cells");
+      }
+
       buildBvhAndCalculateBounds();
 
       computeOverlappingNodeMetadata(rtcRoot);
 
+      if (compactBVH) {
+        compactBvh.build(rtcRoot, bounds);
+
+        // the compact BVH holds all node data needed for sampling and
+        // iteration
+        rtcReleaseBVH(rtcBVH);
+        rtcBVH  = 0;
+        rtcRoot = nullptr;
+      } else {
+        compactBvh.clear();
+      }
+
       if (!this->SharedStructInitialized) {
         CALL_ISPC(VKLUnstructuredVolume_Constructor, this->getSh());
         this->SharedStructInitialized = true;
@@ -223,10 +293,21 @@ namespace openvkl {
           indexPrefixed,
           ispc(cellType),
           (void *)(rtcRoot),
+          (void *)(wideBvh.getRoot()),
+          (void *)(compactBvh.getRoot()),
+          (const ispc::vec3f &)compactBvh.getOrigin(),
+          (const ispc::vec3f &)compactBvh.getSpacing(),
+          (const ispc::vec3f &)compactBvh.getExtent(),
           faceNormals.empty() ? nullptr
                               : (const ispc::vec3f *)faceNormals.data(),
           iterativeTolerance.empty() ? nullptr : iterativeTolerance.data(),
-          hexIterative);
+          hexIterative,
+          cellNeighbors.empty() ? nullptr : cellNeighbors.data());
+
+      // Cell IDs may change with every commit, so hints filled before this
+      // commit must not be used.
+      this->getSh()->hintId = newCellHintId(
+          this->template getParam<bool>("traversalCache", false));
     }
 
     template <int W>
@@ -263,6 +344,152 @@ namespace openvkl {
       return bBox;
     }
 
+    /*
+     * Sort cells by the Morton code of their centroid, and number vertices in
+     * the order in which the sorted cells first reference them. Cells and
+     * vertices that are close in space are then also close in memory, which
+     * BVH leaves, cell interpolation and face adjacency all benefit from.
+     *
+     * All cell and vertex arrays are replaced by reordered copies; the
+     * user's arrays are not modified.
+     */
+    template <int W>
+    void UnstructuredVolume<W>::reorderCellsAndVertices()
+    {
+      const uint64_t numVertices = vertexPosition->size();
+
+      box3f vertexBounds = empty;
+      for (uint64_t v = 0; v < numVertices; v++) {
+        vertexBounds.extend((*vertexPosition)[v]);
+      }
+
+      // Keys hold the cell ID in the upper bits, and the Morton code of its
+      // centroid on a 1024^3 grid over the vertex bounds in the lower
+      // 3 * gridBits bits.
+      constexpr uint32_t gridBits = 10;
+      const float gridRes         = float(1u << gridBits);
+      const vec3f size            = vertexBounds.size();
+      const vec3f scale(gridRes / std::max(size.x, 1e-20f),
+                        gridRes / std::max(size.y, 1e-20f),
+                        gridRes / std::max(size.z, 1e-20f));
+
+      if (nCells >= (uint64_t(1) << (64 - 3 * gridBits))) {
+        throw std::runtime_error(
+            "unstructured volume spatialReorder supports at most 2^34 - 1 "
+            "cells");
+      }
+
+      std::vector<uint64_t> keys(nCells);
+
+      tasking::parallel_for(nCells, [&](uint64_t cellId) {
+        const uint64_t cOffset      = getCellOffset(cellId);
+        const uint32_t cellVertices = getVerticesCount((*cellType)[cellId]);
+
+        vec3f centroid(0.f);
+        for (uint32_t i = 0; i < cellVertices; i++) {
+          centroid += (*vertexPosition)[getVertexId(cOffset + i)];
+        }
+
+        const vec3f g =
+            (centroid / float(cellVertices) - vertexBounds.lower) * scale;
+        const auto quantize = [&](float v) -> uint32_t {
+          // Also maps NaN to zero.
+          return v > 0.f ? uint32_t(std::min(v, gridRes - 1.f)) : 0u;
+        };
+
+        keys[cellId] =
+            (cellId << (3 * gridBits)) |
+            mortonEncode(vec3ui(quantize(g.x), quantize(g.y), quantize(g.z)));
+      });
+
+      parallelRadixSort(keys, 3 * gridBits);
+
+      // user cell ID for each internal cell ID
+      std::vector<uint64_t> cellOrder(nCells);
+      for (uint64_t i = 0; i < nCells; i++) {
+        cellOrder[i] = keys[i] >> (3 * gridBits);
+      }
+
+      std::vector<uint64_t>().swap(keys);
+
+      // Vertices are numbered by first use; vertices that no cell references
+      // keep their relative order at the end.
+      const uint64_t unassigned = std::numeric_limits<uint64_t>::max();
+
+      std::vector<uint64_t> newVertexId(numVertices, unassigned);
+      std::vector<uint64_t> vertexOrder;
+      vertexOrder.reserve(numVertices);
+
+      std::vector<uint64_t> newCellOffsets(nCells);
+      uint64_t numIndices = 0;
+
+      for (uint64_t i = 0; i < nCells; i++) {
+        const uint64_t cellId       = cellOrder[i];
+        const uint64_t cOffset      = getCellOffset(cellId);
+        const uint32_t cellVertices = getVerticesCount((*cellType)[cellId]);
+
+        newCellOffsets[i] = numIndices;
+        numIndices += cellVertices + (indexPrefixed ? 1 : 0);
+
+        for (uint32_t j = 0; j < cellVertices; j++) {
+          const uint64_t vId = getVertexId(cOffset + j);
+          if (newVertexId[vId] == unassigned) {
+            newVertexId[vId] = vertexOrder.size();
+            vertexOrder.push_back(vId);
+          }
+        }
+      }
+
+      for (uint64_t v = 0; v < numVertices; v++) {
+        if (newVertexId[v] == unassigned) {
+          newVertexId[v] = vertexOrder.size();
+          vertexOrder.push_back(v);
+        }
+      }
+
+      std::vector<uint64_t> newIndex(numIndices);
+
+      tasking::parallel_for(nCells, [&](uint64_t i) {
+        const uint64_t cellId       = cellOrder[i];
+        const uint64_t cOffset      = getCellOffset(cellId);
+        const uint32_t cellVertices = getVerticesCount((*cellType)[cellId]);
+
+        uint64_t offset = newCellOffsets[i];
+        if (indexPrefixed) {
+          newIndex[offset++] = cellVertices;
+        }
+
+        for (uint32_t j = 0; j < cellVertices; j++) {
+          newIndex[offset + j] = newVertexId[getVertexId(cOffset + j)];
+        }
+      });
+
+      // Replace all arrays only now, as the above reads the user's arrays.
+      cellType = gatherData(*cellType, cellOrder);
+      if (cellValue) {
+        cellValue = gatherData(*cellValue, cellOrder);
+      }
+
+      vertexPosition = gatherData(*vertexPosition, vertexOrder);
+      if (vertexValue) {
+        vertexValue = gatherData(*vertexValue, vertexOrder);
+      }
+
+      if (index32Bit) {
+        index32 = convertData<uint32_t>(newIndex);
+      } else {
+        index64 = convertData<uint64_t>(newIndex);
+      }
+
+      cell32Bit =
+          cell32Bit && numIndices <= std::numeric_limits<uint32_t>::max();
+      if (cell32Bit) {
+        cellIndex32 = convertData<uint32_t>(newCellOffsets);
+      } else {
+        cellIndex64 = convertData<uint64_t>(newCellOffsets);
+      }
+    }
+
     static inline void errorFunction(void *userPtr,
                                      enum RTCError error,
                                      const char *str)
@@ -345,6 +572,13 @@ namespace openvkl {
       addLevelToNodes(rtcRoot, 0);
 
       bvhDepth = getMaxNodeLevel(rtcRoot);
+
+      // point location uses the compact BVH instead, if enabled
+      if (compactBVH) {
+        wideBvh.clear();
+      } else {
+        wideBvh.build(rtcRoot);
+      }
     }
 
     template <int W>
@@ -443,6 +677,114 @@ namespace openvkl {
       });
     }
 
+    // Sorted vertex IDs of the given face of a tetrahedron or hexahedron,
+    // padded with VKL_CELL_NO_NEIGHBOR. Faces are indexed in the order in
+    // which they are intersected in UnstructuredVolume.ispc.
+    template <int W>
+    void UnstructuredVolume<W>::getCellFace(
+        uint64_t cellId,
+        uint32_t face,
+        std::array<uint64_t, 4> &vertexIds) const
+    {
+      const uint32_t tetrahedronFaces[4][3] = {
+          {2, 0, 1}, {3, 1, 0}, {3, 2, 1}, {2, 3, 0}};
+      const uint32_t hexahedronFaces[6][4] = {{0, 1, 2, 3},
+                                              {1, 2, 5, 6},
+                                              {0, 3, 4, 7},
+                                              {0, 1, 4, 5},
+                                              {4, 5, 6, 7},
+                                              {2, 3, 6, 7}};
+
+      const uint64_t cOffset = getCellOffset(cellId);
+
+      if ((*cellType)[cellId] == VKL_TETRAHEDRON) {
+        for (int i = 0; i < 3; i++) {
+          vertexIds[i] = getVertexId(cOffset + tetrahedronFaces[face][i]);
+        }
+        vertexIds[3] = VKL_CELL_NO_NEIGHBOR;
+      } else {
+        for (int i = 0; i < 4; i++) {
+          vertexIds[i] = getVertexId(cOffset + hexahedronFaces[face][i]);
+        }
+      }
+
+      std::sort(vertexIds.begin(), vertexIds.end());
+    }
+
+    // Find the cell sharing each face of all tetrahedra and hexahedra. Faces
+    // are bucketed by their smallest vertex ID, so that matching faces only
+    // need to be searched for within a bucket.
+    template <int W>
+    void UnstructuredVolume<W>::buildCellNeighbors()
+    {
+      auto getNumFaces = [&](uint64_t cellId) -> int {
+        switch ((*cellType)[cellId]) {
+        case VKL_TETRAHEDRON:
+          return 4;
+        case VKL_HEXAHEDRON:
+          return 6;
+        default:
+          return 0;
+        }
+      };
+
+      const uint64_t numVertices = vertexPosition->size();
+
+      std::vector<uint64_t> bucketOffsets(numVertices + 1, 0);
+      std::array<uint64_t, 4> vertexIds;
+
+      for (uint64_t cellId = 0; cellId < nCells; cellId++) {
+        for (int f = 0; f < getNumFaces(cellId); f++) {
+          getCellFace(cellId, f, vertexIds);
+          bucketOffsets[vertexIds[0] + 1]++;
+        }
+      }
+
+      for (uint64_t v = 0; v < numVertices; v++) {
+        bucketOffsets[v + 1] += bucketOffsets[v];
+      }
+
+      // faces are stored as cellId * 6 + face, as in cellNeighbors
+      std::vector<uint64_t> buckets(bucketOffsets[numVertices]);
+      std::vector<uint64_t> bucketSizes(numVertices, 0);
+
+      for (uint64_t cellId = 0; cellId < nCells; cellId++) {
+        for (int f = 0; f < getNumFaces(cellId); f++) {
+          getCellFace(cellId, f, vertexIds);
+          const uint64_t v = vertexIds[0];
+          buckets[bucketOffsets[v] + bucketSizes[v]++] = cellId * 6 + f;
+        }
+      }
+
+      cellNeighbors.assign(nCells * 6, VKL_CELL_NO_NEIGHBOR);
+
+      // each face is in exactly one bucket, so buckets can be matched in
+      // parallel
+      tasking::parallel_for(numVertices, [&](uint64_t v) {
+        const uint64_t begin = bucketOffsets[v];
+        const uint64_t end   = bucketOffsets[v + 1];
+
+        std::array<uint64_t, 4> a;
+        std::array<uint64_t, 4> b;
+
+        for (uint64_t i = begin; i < end; i++) {
+          const uint64_t faceA = buckets[i];
+          getCellFace(faceA / 6, faceA % 6, a);
+
+          for (uint64_t j = i + 1; j < end; j++) {
+            const uint64_t faceB = buckets[j];
+            getCellFace(faceB / 6, faceB % 6, b);
+
+            // faces of a conforming mesh are shared by at most two cells
+            if (a == b) {
+              cellNeighbors[faceA] = faceB / 6;
+              cellNeighbors[faceB] = faceA / 6;
+            }
+          }
+        }
+      });
+    }
+
     // Calculate all normals for arbitrary polyhedron
     // based on given vertices order
     template <int W>
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <array>
 #include "../common/Data.h"
 #include "../common/export_util.h"
 #include "../common/math.h"
@@ -43,6 +44,8 @@ namespace openvkl {
      private:
       void buildBvhAndCalculateBounds();
 
+      void reorderCellsAndVertices();
+
       // Read from index arrays that could have 32/64-bit element size
       uint64_t getCellOffset(uint64_t id) const;
       uint64_t getVertexId(uint64_t id) const;
@@ -52,6 +55,11 @@ namespace openvkl {
                                 const uint32_t facesCount);
       void calculateFaceNormals();
 
+      void getCellFace(uint64_t cellId,
+                       uint32_t face,
+                       std::array<uint64_t, 4> &vertexIds) const;
+      void buildCellNeighbors();
+
       void calculateTolerance(const uint64_t cellId,
                               const uint32_t edge[][2],
                               const uint32_t count);
@@ -80,17 +88,22 @@ namespace openvkl {
       bool cell32Bit{false};
       bool indexPrefixed{false};
       bool hexIterative{false};
+      bool compactBVH{false};
 
       // used only if an explicit cell type array is not provided
       std::vector<uint8_t> generatedCellType;
 
       std::vector<vec3f> faceNormals;
       std::vector<float> iterativeTolerance;
+      std::vector<uint64_t> cellNeighbors;
 
       RTCBVH rtcBVH{0};
       RTCDevice rtcDevice{0};
       Node *rtcRoot{nullptr};
       int bvhDepth{0};
+
+      WideBVH wideBvh;
+      CompactBVH compactBvh;
     };
 
     // Inlined definitions ////////////////////////////////////////////////////
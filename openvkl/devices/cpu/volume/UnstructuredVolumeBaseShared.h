@@ -17,12 +17,65 @@ struct Node
   VKL_INTEROP_UNIFORM Node *VKL_INTEROP_UNIFORM parent;
 };
 
+// Branching factor of the wide BVH used for point location. All children of a
+// node are tested in one SIMD step, one child per program instance.
+#if VKL_TARGET_WIDTH >= 8
+#define VKL_BVH_WIDTH 8
+#else
+#define VKL_BVH_WIDTH 4
+#endif
+
+// Node of the wide BVH, with child bounds in SoA layout. Children are either
+// wide nodes or leaf nodes of the binary BVH, as given by leafMask. Unused
+// child slots have empty bounds.
+struct WideNode
+{
+  VKL_INTEROP_UNIFORM float lowerX[VKL_BVH_WIDTH];
+  VKL_INTEROP_UNIFORM float lowerY[VKL_BVH_WIDTH];
+  VKL_INTEROP_UNIFORM float lowerZ[VKL_BVH_WIDTH];
+  VKL_INTEROP_UNIFORM float upperX[VKL_BVH_WIDTH];
+  VKL_INTEROP_UNIFORM float upperY[VKL_BVH_WIDTH];
+  VKL_INTEROP_UNIFORM float upperZ[VKL_BVH_WIDTH];
+
+  void *VKL_INTEROP_UNIFORM children[VKL_BVH_WIDTH];
+
+  VKL_INTEROP_UNIFORM vkl_uint32 leafMask;
+};
+
+// Node of the compact BVH, which is stored in a flat array. Bounds are
+// quantized to a 16-bit lattice over the volume bounds; value ranges, and
+// nominal lengths relative to the volume size, are stored in half precision.
+// The children of an inner node are adjacent in the array, starting at child.
+// For leaves, child is the cell ID.
+struct CompactNode
+{
+  VKL_INTEROP_UNIFORM vkl_uint16 lower[3];
+  VKL_INTEROP_UNIFORM vkl_uint16 upper[3];
+  VKL_INTEROP_UNIFORM vkl_uint16 valueRange[2];
+  VKL_INTEROP_UNIFORM vkl_uint16 nominalLength[3];  // x negative for leaves
+  VKL_INTEROP_UNIFORM vkl_uint16 level;
+  VKL_INTEROP_UNIFORM vkl_uint32 parent;
+  VKL_INTEROP_UNIFORM vkl_uint32 child;
+};
+
 struct VKLUnstructuredBase
 {
   VolumeShared super;
 
   VKL_INTEROP_UNIFORM box3f boundingBox;
+
+  // binary BVH, used for interval and hit iteration
   VKL_INTEROP_UNIFORM Node *VKL_INTEROP_UNIFORM bvhRoot;
+
+  // wide BVH sharing the leaves of the binary BVH, used for point location.
+  // NULL for volumes which do not locate points in the BVH.
+  VKL_INTEROP_UNIFORM WideNode *VKL_INTEROP_UNIFORM wideBvhRoot;
+
+  // compact BVH, used instead of both of the above if not NULL
+  VKL_INTEROP_UNIFORM CompactNode *VKL_INTEROP_UNIFORM compactBvh;
+  VKL_INTEROP_UNIFORM vec3f compactBvhOrigin;
+  VKL_INTEROP_UNIFORM vec3f compactBvhSpacing;  // of the bounds lattice
+  VKL_INTEROP_UNIFORM vec3f compactBvhExtent;   // scale of nominal lengths
 };
 
 #ifdef __cplusplus
@@ -43,6 +43,22 @@ namespace ispc {
     VKL_INTEROP_UNIFORM Node *VKL_INTEROP_UNIFORM children[2];
   };
 
+  // marks faces without a neighbor in VKLUnstructuredVolume::cellNeighbors
+#define VKL_CELL_NO_NEIGHBOR ((vkl_uint64)-1)
+
+  /*
+   * Remembers the cell that contained the last sample position, so that
+   * coherent queries (e.g. along a ray) can test it and its face neighbors
+   * before traversing the BVH. A hint must only be used by one thread at a
+   * time. Its content is only valid for the volume commit (volumeId) it was
+   * filled for.
+   */
+  struct UnstructuredCellHint
+  {
+    vkl_uint64 volumeId;
+    vkl_uint64 cellID;
+  };
+
   struct VKLUnstructuredVolume
   {
     VKLUnstructuredBase super;
@@ -68,9 +84,17 @@ namespace ispc {
     const vec3f *VKL_INTEROP_UNIFORM faceNormals;
     const float *VKL_INTEROP_UNIFORM iterativeTolerance;
 
+    // face neighbors of tetrahedra and hexahedra, 6 slots per cell, for
+    // walking from cell to cell along rays; NULL if not built
+    const vkl_uint64 *VKL_INTEROP_UNIFORM cellNeighbors;
+
     VKL_INTEROP_UNIFORM vec3f gradientStep;
 
     VKL_INTEROP_UNIFORM bool hexIterative;
+
+    // Unique for every commit, used to validate UnstructuredCellHints.
+    // Zero if the traversal cache is disabled.
+    VKL_INTEROP_UNIFORM vkl_uint64 hintId;
   };
 
 #ifdef __cplusplus
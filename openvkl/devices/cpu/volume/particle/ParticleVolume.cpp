@@ -152,7 +152,8 @@ namespace openvkl {
                 ispc(weights),
                 radiusSupportFactor,
                 clampMaxCumulativeValue,
-                (void *)(rtcRoot));
+                (void *)(rtcRoot),
+                (void *)(wideBvh.getRoot()));
 
       computeValueRanges();
 
@@ -270,6 +271,8 @@ namespace openvkl {
         bounds     = box3f(vals[0].lower, vals[0].upper);
         bounds.extend(box3f(vals[1].lower, vals[1].upper));
       }
+
+      wideBvh.build(rtcRoot);
     }
 
     template <int W>
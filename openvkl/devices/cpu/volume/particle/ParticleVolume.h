@@ -111,6 +111,8 @@ namespace openvkl {
       RTCDevice rtcDevice{0};
       Node *rtcRoot{nullptr};
       int bvhDepth{0};
+
+      WideBVH wideBvh;
     };
 
     // Inlined definitions ////////////////////////////////////////////////////
@@ -27,6 +27,41 @@ namespace openvkl {
       this->constantCellData =
           this->template getParam<bool>("cellCentered", false);
 
+      const int brickSize = this->template getParam<int>("brickSize", 0);
+      if (brickSize != 0 && brickSize != 8 && brickSize != 16) {
+        runtimeError("brickSize must be 0, 8, or 16, but is ", brickSize);
+      }
+      this->denseBrickLog2 = brickSize == 0 ? 0 : (brickSize == 8 ? 3 : 4);
+
+      const int compressionBits =
+          this->template getParam<int>("compressionBitsPerVoxel", 0);
+      if (compressionBits != 0 && compressionBits != 4 &&
+          compressionBits != 8) {
+        runtimeError("compressionBitsPerVoxel must be 0, 4, or 8, but is ",
+                     compressionBits);
+      }
+      if (compressionBits != 0 && brickSize != 0) {
+        runtimeError(
+            "compressionBitsPerVoxel cannot be combined with brickSize");
+      }
+      if (compressionBits != 0 &&
+          temporalFormat != VKL_TEMPORAL_FORMAT_CONSTANT) {
+        runtimeError(
+            "compressionBitsPerVoxel is only supported for temporally constant "
+            "volumes");
+      }
+      this->denseCompressionBits = compressionBits;
+
+      const int mipLevels = this->template getParam<int>("mipLevels", 0);
+      if (mipLevels < 0) {
+        runtimeError("mipLevels must be non-negative, but is ", mipLevels);
+      }
+      if (mipLevels > 0 && temporalFormat != VKL_TEMPORAL_FORMAT_CONSTANT) {
+        runtimeError(
+            "mipLevels is only supported for temporally constant volumes");
+      }
+      this->denseMipLevels = mipLevels;
+
       VdbVolume<W>::commit();
     }
 
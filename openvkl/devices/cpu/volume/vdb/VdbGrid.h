@@ -40,6 +40,20 @@ struct VdbLevel
   // For each voxel, the range of values contained within, by attribute:
   // (range0, range1, ..., rangeNumAttributes)_0, [...]
   range1f *valueRange;
+
+  // Optional: for each voxel, the average value contained within, by
+  // attribute, laid out like valueRange. Used for level of detail sampling.
+  float *average;
+};
+
+/*
+ * Dequantization parameters for a single node and attribute. Quantized
+ * attributes (VKL_UCHAR, VKL_USHORT) decode to offset + scale * value.
+ */
+struct VdbLeafQuantization
+{
+  float scale;
+  float offset;
 };
 
 /*
@@ -67,6 +81,10 @@ struct VdbGrid
 
   vkl_uint32 *attributeTypes;  // Data type for each attribute.
 
+  // Unique for every commit of the owning volume, including commits that
+  // update this grid in place. Used to validate VdbAccessors.
+  vkl_uint64 commitGeneration;
+
   // Per-node data for sparse / non-dense volumes only.
   const vkl_int32 *leafStructuredTimesteps;
   Data1D *leafUnstructuredIndices;
@@ -76,16 +94,54 @@ struct VdbGrid
   // numAttributes]
   Data1D *leafData;
 
+  // Optional: per-node, per-attribute dequantization parameters for sparse /
+  // non-dense volumes with quantized attributes. leafQuantization is indexed
+  // like leafData; the packed versions are indexed by packed node index and
+  // attribute in the same way.
+  VdbLeafQuantization *leafQuantization;
+  VdbLeafQuantization *nodesPackedDenseQuantization;
+  VdbLeafQuantization *nodesPackedTileQuantization;
+
   // Optional: per-attribute node-packed data for sparse / non-dense volumes
   // only: size [numAttributes]
   bool packedAddressing32;
   Data1D *nodesPackedDense;
   Data1D *nodesPackedTile;
 
+  // Optional: out-of-core paging of leaf data for sparse / non-dense volumes.
+  // If leafPager is set, leafData for a node is only valid if
+  // leafResident[node] was 1 within the current read section (see
+  // VdbLeafPager_enter()); other nodes are paged in through
+  // VdbLeafPager_load(). leafLastAccess receives leafPagerEpoch on every
+  // access. All arrays have size [numLeaves].
+  void *leafPager;
+  vkl_uint8 *leafResident;
+  vkl_uint32 *leafLastAccess;
+  vkl_uint32 leafPagerEpoch;
+
   // Parameters for dense volumes only.
   bool dense;
   vec3i denseDimensions;
   Data1D *denseData;  // Per-attribute data: size [numAttributes]
+  // If nonzero, dense data is stored in cubic bricks of (1 << denseBrickLog2)
+  // voxels per dimension, with denseNumBricks bricks in each dimension.
+  vkl_uint32 denseBrickLog2;
+  vec3ui denseNumBricks;
+  // If nonzero, dense data is compressed to denseCompressionBits (4 or 8) bits
+  // per voxel, and denseData holds the codes as VKL_UCHAR. Codes are stored in
+  // the bricked layout with denseBrickLog2 == 2; with 4 bits, two codes share
+  // a byte, low nibble first. Each brick of 4^3 voxels decodes to
+  // offset + scale * code, with parameters in denseBlockQuantization, indexed
+  // by attributeIndex * (number of bricks) + brick index.
+  vkl_uint32 denseCompressionBits;
+  VdbLeafQuantization *denseBlockQuantization;
+  // Optional: prefiltered mip levels 1 to denseNumMipLevels. Level l has
+  // ceil(denseDimensions / 2^l) float voxels in x-fastest order, each the
+  // average of the (up to) 2^3 voxels it covers on level l - 1. denseMipData
+  // has size [denseNumMipLevels * numAttributes], indexed by
+  // (l - 1) * numAttributes + attributeIndex.
+  vkl_uint32 denseNumMipLevels;
+  Data1D *denseMipData;
   VKLTemporalFormat denseTemporalFormat;
   int denseTemporallyStructuredNumTimesteps;
   Data1D denseTemporallyUnstructuredIndices;
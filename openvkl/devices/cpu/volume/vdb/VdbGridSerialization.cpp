@@ -0,0 +1,612 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "VdbGridSerialization.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+#include "../../common/runtime_error.h"
+#include "openvkl/vdb.h"
+
+namespace openvkl {
+  namespace cpu_device {
+
+    // File format ////////////////////////////////////////////////////////////
+
+    static constexpr char vdbGridFileMagic[8] = {
+        'O', 'V', 'K', 'L', 'V', 'D', 'B', 'G'};
+    static constexpr uint32_t vdbGridFileVersion = 1;
+
+    // All sections start at a multiple of this offset, so that arrays are
+    // suitably aligned in a mapping (mappings are page aligned).
+    static constexpr uint64_t vdbGridFileAlignment = 64;
+
+    struct VdbGridFileLevel
+    {
+      uint64_t numNodes;
+      uint64_t originOffset;      // vec3ui[numNodes]
+      uint64_t voxelsOffset;      // uint64_t[numNodes * numVoxels]
+      uint64_t valueRangeOffset;  // range1f[numNodes * numVoxels * numAttr]
+    };
+
+    /*
+     * The file header. All offsets are in bytes, relative to the beginning of
+     * the file. Node data is stored in packed layout: all dense nodes (and
+     * all tile nodes) for one attribute in a single compact array, addressed
+     * by the leaf index in leaf voxels.
+     */
+    struct VdbGridFileHeader
+    {
+      char magic[8];
+      uint32_t version;
+      uint32_t headerSize;  // Guards against layout changes.
+      uint32_t levelLogRes[VKL_VDB_NUM_LEVELS];
+
+      uint64_t fileSize;
+      uint64_t numLeaves;
+      uint32_t numAttributes;
+      uint32_t packedAddressing32;
+      uint64_t numDenseNodes;
+      uint64_t numTileNodes;
+
+      float objectToIndex[12];
+      float indexToObject[12];
+      int32_t rootOrigin[3];
+      uint32_t activeSize[3];
+      float domainBoundingBox[6];
+      float bounds[6];
+
+      uint64_t attributeTypesOffset;  // uint32_t[numAttributes]
+      uint64_t denseDataOffset;       // uint64_t[numAttributes] offsets
+      uint64_t tileDataOffset;        // uint64_t[numAttributes] offsets
+
+      // VdbLeafQuantization[numNodes * numAttributes], or 0 if not quantized.
+      uint64_t denseQuantizationOffset;
+      uint64_t tileQuantizationOffset;
+
+      VdbGridFileLevel levels[VKL_VDB_NUM_LEVELS - 1];
+    };
+
+    // Export /////////////////////////////////////////////////////////////////
+
+    namespace {
+
+      class VdbGridFileWriter
+      {
+       public:
+        explicit VdbGridFileWriter(const std::string &filename)
+            : filename(filename), out(filename, std::ios::binary)
+        {
+          if (!out) {
+            runtimeError("cannot open file ", filename, " for writing");
+          }
+        }
+
+        /*
+         * Pad the file to the next section boundary and return the offset
+         * of the new section.
+         */
+        uint64_t beginSection()
+        {
+          static const char zeros[vdbGridFileAlignment] = {0};
+          const uint64_t padding =
+              (vdbGridFileAlignment - offset % vdbGridFileAlignment) %
+              vdbGridFileAlignment;
+          write(zeros, padding);
+          return offset;
+        }
+
+        void write(const void *data, size_t numBytes)
+        {
+          out.write(reinterpret_cast<const char *>(data), numBytes);
+          offset += numBytes;
+        }
+
+        /*
+         * Write numItems items of the given array, starting at item begin,
+         * as a compact array.
+         */
+        void writeItems(const ispc::Data1D &data,
+                        uint64_t begin,
+                        uint64_t numItems)
+        {
+          const size_t itemSize = sizeOf(data.dataType);
+
+          if (data.compact || data.byteStride == itemSize) {
+            write(data.addr + begin * itemSize, numItems * itemSize);
+          } else {
+            for (uint64_t i = begin; i < begin + numItems; ++i) {
+              write(data.addr + i * data.byteStride, itemSize);
+            }
+          }
+        }
+
+        uint64_t size() const
+        {
+          return offset;
+        }
+
+        void finish(const VdbGridFileHeader &header)
+        {
+          out.seekp(0);
+          out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+          out.close();
+          if (!out) {
+            runtimeError("error writing file ", filename);
+          }
+        }
+
+       private:
+        std::string filename;
+        std::ofstream out;
+        uint64_t offset{0};
+      };
+
+    }  // namespace
+
+    void exportVdbGrid(const VdbGrid &grid,
+                       const box3f &bounds,
+                       const std::string &filename)
+    {
+      if (grid.dense) {
+        runtimeError("only sparse vdb volumes can be serialized");
+      }
+
+      if (!grid.allLeavesConstant) {
+        runtimeError("only temporally constant vdb volumes can be serialized");
+      }
+
+      const bool packed = grid.nodesPackedDense || grid.nodesPackedTile;
+      const uint32_t numAttributes = grid.numAttributes;
+      const uint64_t leafNumVoxels =
+          vklVdbLevelNumVoxels(VKL_VDB_NUM_LEVELS - 1);
+
+      // Copy the tree. For grids with per-node data, leaf pointers are
+      // rewritten to packed indices, assigned in traversal order. Each node
+      // is referenced by exactly one leaf voxel.
+      std::vector<std::vector<uint64_t>> voxels(VKL_VDB_NUM_LEVELS - 1);
+      std::vector<uint64_t> denseNodes;
+      std::vector<uint64_t> tileNodes;
+
+      for (uint32_t l = 0; l + 1 < VKL_VDB_NUM_LEVELS; ++l) {
+        const VdbLevel &level = grid.levels[l];
+        voxels[l].assign(
+            level.voxels,
+            level.voxels + level.numNodes * vklVdbLevelNumVoxels(l));
+
+        if (packed) {
+          continue;
+        }
+
+        for (uint64_t &voxel : voxels[l]) {
+          if (!vklVdbVoxelIsLeafPtr(voxel)) {
+            continue;
+          }
+
+          const VKLFormat format = vklVdbVoxelLeafGetFormat(voxel);
+          std::vector<uint64_t> &nodes =
+              (format == VKL_FORMAT_DENSE_ZYX) ? denseNodes : tileNodes;
+
+          const uint64_t leafIndex = vklVdbVoxelLeafGetIndex(voxel);
+          voxel                    = vklVdbVoxelMakeLeafPtr(
+              nodes.size(), format, VKL_TEMPORAL_FORMAT_CONSTANT);
+          nodes.push_back(leafIndex);
+        }
+      }
+
+      VdbGridFileHeader header;
+      std::memset(&header, 0, sizeof(header));
+      std::memcpy(header.magic, vdbGridFileMagic, sizeof(header.magic));
+      header.version    = vdbGridFileVersion;
+      header.headerSize = sizeof(header);
+      for (uint32_t l = 0; l < VKL_VDB_NUM_LEVELS; ++l) {
+        header.levelLogRes[l] = vklVdbLevelLogRes(l);
+      }
+
+      header.numLeaves     = grid.numLeaves;
+      header.numAttributes = numAttributes;
+
+      if (packed) {
+        header.numDenseNodes =
+            grid.nodesPackedDense
+                ? grid.nodesPackedDense[0].numItems / leafNumVoxels
+                : 0;
+        header.numTileNodes =
+            grid.nodesPackedTile ? grid.nodesPackedTile[0].numItems : 0;
+      } else {
+        header.numDenseNodes = denseNodes.size();
+        header.numTileNodes  = tileNodes.size();
+      }
+
+      std::memcpy(header.objectToIndex,
+                  grid.objectToIndex,
+                  sizeof(header.objectToIndex));
+      std::memcpy(header.indexToObject,
+                  grid.indexToObject,
+                  sizeof(header.indexToObject));
+
+      for (int i = 0; i < 3; ++i) {
+        header.rootOrigin[i]            = grid.rootOrigin[i];
+        header.activeSize[i]            = grid.activeSize[i];
+        header.domainBoundingBox[i]     = grid.domainBoundingBox.lower[i];
+        header.domainBoundingBox[i + 3] = grid.domainBoundingBox.upper[i];
+        header.bounds[i]                = bounds.lower[i];
+        header.bounds[i + 3]            = bounds.upper[i];
+      }
+
+      VdbGridFileWriter writer(filename);
+      writer.write(&header, sizeof(header));
+
+      header.attributeTypesOffset = writer.beginSection();
+      writer.write(grid.attributeTypes, numAttributes * sizeof(uint32_t));
+
+      for (uint32_t l = 0; l + 1 < VKL_VDB_NUM_LEVELS; ++l) {
+        const VdbLevel &level      = grid.levels[l];
+        VdbGridFileLevel &fileLevel = header.levels[l];
+        fileLevel.numNodes          = level.numNodes;
+
+        fileLevel.originOffset = writer.beginSection();
+        writer.write(level.origin, level.numNodes * sizeof(vec3ui));
+
+        fileLevel.voxelsOffset = writer.beginSection();
+        writer.write(voxels[l].data(), voxels[l].size() * sizeof(uint64_t));
+
+        fileLevel.valueRangeOffset = writer.beginSection();
+        writer.write(level.valueRange,
+                     voxels[l].size() * numAttributes * sizeof(range1f));
+      }
+
+      // Node data, one compact array per attribute.
+      const auto writeNodeData = [&](const ispc::Data1D *packedData,
+                                     const std::vector<uint64_t> &nodes,
+                                     uint64_t numNodes,
+                                     uint64_t itemsPerNode) -> uint64_t {
+        std::vector<uint64_t> offsets(numAttributes);
+
+        for (uint32_t a = 0; a < numAttributes; ++a) {
+          offsets[a] = writer.beginSection();
+          if (packed) {
+            if (packedData) {
+              writer.writeItems(packedData[a], 0, numNodes * itemsPerNode);
+            }
+          } else {
+            for (uint64_t n : nodes) {
+              writer.writeItems(
+                  grid.leafData[vklVdbGetLeafDataIndex(&grid, n, a)],
+                  0,
+                  itemsPerNode);
+            }
+          }
+        }
+
+        const uint64_t offsetsOffset = writer.beginSection();
+        writer.write(offsets.data(), offsets.size() * sizeof(uint64_t));
+        return offsetsOffset;
+      };
+
+      header.denseDataOffset = writeNodeData(grid.nodesPackedDense,
+                                             denseNodes,
+                                             header.numDenseNodes,
+                                             leafNumVoxels);
+      header.tileDataOffset  = writeNodeData(
+          grid.nodesPackedTile, tileNodes, header.numTileNodes, 1);
+
+      // The ISPC data array limitation, as for user provided packed data.
+      header.packedAddressing32 = true;
+      for (uint32_t a = 0; a < numAttributes; ++a) {
+        const uint64_t itemSize = sizeOf((VKLDataType)grid.attributeTypes[a]);
+        if (header.numDenseNodes * leafNumVoxels * itemSize >= (1ull << 31) ||
+            header.numTileNodes * itemSize >= (1ull << 31)) {
+          header.packedAddressing32 = false;
+        }
+      }
+
+      // Dequantization parameters, in packed order.
+      const auto writeQuantization = [&](const VdbLeafQuantization *packedQ,
+                                         const std::vector<uint64_t> &nodes,
+                                         uint64_t numNodes) -> uint64_t {
+        const uint64_t offset = writer.beginSection();
+        if (packed) {
+          writer.write(packedQ,
+                       numNodes * numAttributes * sizeof(VdbLeafQuantization));
+        } else {
+          for (uint64_t n : nodes) {
+            writer.write(grid.leafQuantization +
+                             vklVdbGetLeafDataIndex(&grid, n, 0),
+                         numAttributes * sizeof(VdbLeafQuantization));
+          }
+        }
+        return offset;
+      };
+
+      const bool quantized = packed ? (grid.nodesPackedDenseQuantization ||
+                                       grid.nodesPackedTileQuantization)
+                                    : (grid.leafQuantization != nullptr);
+
+      if (quantized) {
+        header.denseQuantizationOffset =
+            writeQuantization(grid.nodesPackedDenseQuantization,
+                              denseNodes,
+                              header.numDenseNodes);
+        header.tileQuantizationOffset =
+            writeQuantization(grid.nodesPackedTileQuantization,
+                              tileNodes,
+                              header.numTileNodes);
+      }
+
+      header.fileSize = writer.size();
+      writer.finish(header);
+    }
+
+    // Import /////////////////////////////////////////////////////////////////
+
+    namespace {
+
+      /*
+       * Return a pointer to an array of numItems items of type T at the
+       * given offset in file, verifying that it lies within the file.
+       */
+      template <typename T>
+      T *getSection(const MappedFile &file, uint64_t offset, uint64_t numItems)
+      {
+        const uint8_t *p = file.data() + offset;
+
+        if (offset % alignof(T) != 0 || offset > file.size() ||
+            numItems > (file.size() - offset) / sizeof(T)) {
+          runtimeError("serialized vdb grid is corrupt");
+        }
+
+        // Mappings are read-only. Mapped grids are never modified after
+        // commit (incremental commits do not apply to them).
+        return reinterpret_cast<T *>(const_cast<uint8_t *>(p));
+      }
+
+      /*
+       * Multiply two sizes read from a file, rejecting results that do not
+       * fit into 64 bits.
+       */
+      uint64_t checkedMul(uint64_t a, uint64_t b)
+      {
+        if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a) {
+          runtimeError("serialized vdb grid is corrupt");
+        }
+        return a * b;
+      }
+
+      /*
+       * Verify that all child pointers in the given level reference existing
+       * nodes, and all leaf pointers reference existing node data.
+       */
+      void verifyLevelVoxels(const VdbGrid &grid,
+                             uint32_t l,
+                             uint64_t numDenseNodes,
+                             uint64_t numTileNodes)
+      {
+        const bool lastInnerLevel = (l + 2 == VKL_VDB_NUM_LEVELS);
+        const VdbLevel &level     = grid.levels[l];
+        const uint64_t numVoxels = level.numNodes * vklVdbLevelNumVoxels(l);
+
+        for (uint64_t i = 0; i < numVoxels; ++i) {
+          const uint64_t voxel = level.voxels[i];
+
+          bool valid = false;
+          if (vklVdbVoxelIsEmpty(voxel)) {
+            valid = true;
+          } else if (vklVdbVoxelIsChildPtr(voxel)) {
+            valid = !lastInnerLevel && vklVdbVoxelChildGetIndex(voxel) <
+                                           grid.levels[l + 1].numNodes;
+          } else if (vklVdbVoxelIsLeafPtr(voxel)) {
+            const uint64_t index = vklVdbVoxelLeafGetIndex(voxel);
+            switch (vklVdbVoxelLeafGetFormat(voxel)) {
+            case VKL_FORMAT_TILE:
+              valid = index < numTileNodes;
+              break;
+            case VKL_FORMAT_DENSE_ZYX:
+              valid = lastInnerLevel && index < numDenseNodes;
+              break;
+            default:
+              break;
+            }
+            valid = valid && vklVdbVoxelLeafGetTemporalFormat(voxel) ==
+                                 VKL_TEMPORAL_FORMAT_CONSTANT;
+          }
+
+          if (!valid) {
+            runtimeError("serialized vdb grid is corrupt");
+          }
+        }
+      }
+
+    }  // namespace
+
+    VdbGrid *mapVdbGrid(const MappedFile &file,
+                        Allocator &allocator,
+                        box3f &bounds)
+    {
+      VdbGridFileHeader header;
+
+      if (file.size() < sizeof(header)) {
+        runtimeError("not a serialized vdb grid");
+      }
+
+      std::memcpy(&header, file.data(), sizeof(header));
+
+      if (std::memcmp(header.magic, vdbGridFileMagic, sizeof(header.magic))) {
+        runtimeError("not a serialized vdb grid");
+      }
+
+      if (header.version != vdbGridFileVersion ||
+          header.headerSize != sizeof(header)) {
+        runtimeError("unsupported serialized vdb grid version");
+      }
+
+      for (uint32_t l = 0; l < VKL_VDB_NUM_LEVELS; ++l) {
+        if (header.levelLogRes[l] != vklVdbLevelLogRes(l)) {
+          runtimeError(
+              "serialized vdb grid was written for a different vdb "
+              "configuration");
+        }
+      }
+
+      if (header.fileSize != file.size()) {
+        runtimeError("serialized vdb grid is truncated");
+      }
+
+      if (header.numAttributes == 0) {
+        runtimeError("serialized vdb grid is corrupt");
+      }
+
+      const uint32_t numAttributes = header.numAttributes;
+      const uint64_t leafNumVoxels =
+          vklVdbLevelNumVoxels(VKL_VDB_NUM_LEVELS - 1);
+
+      const uint32_t *attributeTypes = getSection<uint32_t>(
+          file, header.attributeTypesOffset, numAttributes);
+
+      // Quantized attributes cannot be decoded without their parameters.
+      const bool quantized = header.denseQuantizationOffset != 0;
+      for (uint32_t a = 0; a < numAttributes; ++a) {
+        const VKLDataType dataType = (VKLDataType)attributeTypes[a];
+        if (dataType != VKL_HALF && dataType != VKL_FLOAT &&
+            !(quantized && (dataType == VKL_UCHAR || dataType == VKL_USHORT))) {
+          runtimeError("serialized vdb grid has unsupported attribute type ",
+                       dataType);
+        }
+      }
+
+      const uint64_t *denseDataOffsets =
+          getSection<uint64_t>(file, header.denseDataOffset, numAttributes);
+      const uint64_t *tileDataOffsets =
+          getSection<uint64_t>(file, header.tileDataOffset, numAttributes);
+
+      VdbGrid *grid = allocator.allocate<VdbGrid>(1);
+
+      try {
+        std::memcpy(grid->objectToIndex,
+                    header.objectToIndex,
+                    sizeof(grid->objectToIndex));
+        std::memcpy(grid->indexToObject,
+                    header.indexToObject,
+                    sizeof(grid->indexToObject));
+
+        grid->rootOrigin = vec3i(
+            header.rootOrigin[0], header.rootOrigin[1], header.rootOrigin[2]);
+        grid->activeSize = vec3ui(
+            header.activeSize[0], header.activeSize[1], header.activeSize[2]);
+        grid->domainBoundingBox = box3f(vec3f(header.domainBoundingBox[0],
+                                              header.domainBoundingBox[1],
+                                              header.domainBoundingBox[2]),
+                                        vec3f(header.domainBoundingBox[3],
+                                              header.domainBoundingBox[4],
+                                              header.domainBoundingBox[5]));
+        bounds = box3f(
+            vec3f(header.bounds[0], header.bounds[1], header.bounds[2]),
+            vec3f(header.bounds[3], header.bounds[4], header.bounds[5]));
+
+        grid->constantCellData  = true;
+        grid->numLeaves         = header.numLeaves;
+        grid->numAttributes     = numAttributes;
+        grid->allLeavesCompact  = true;
+        grid->allLeavesConstant = true;
+        grid->dense             = false;
+
+        grid->attributeTypes = allocator.allocate<uint32_t>(numAttributes);
+        std::memcpy(grid->attributeTypes,
+                    attributeTypes,
+                    numAttributes * sizeof(uint32_t));
+
+        for (uint32_t l = 0; l + 1 < VKL_VDB_NUM_LEVELS; ++l) {
+          const VdbGridFileLevel &fileLevel = header.levels[l];
+          const uint64_t numVoxels =
+              checkedMul(fileLevel.numNodes, vklVdbLevelNumVoxels(l));
+
+          VdbLevel &level = grid->levels[l];
+          level.numNodes  = fileLevel.numNodes;
+          level.origin    = getSection<vec3ui>(
+              file, fileLevel.originOffset, fileLevel.numNodes);
+          level.voxels = getSection<uint64_t>(
+              file, fileLevel.voxelsOffset, numVoxels);
+          level.valueRange = getSection<range1f>(
+              file,
+              fileLevel.valueRangeOffset,
+              checkedMul(numVoxels, numAttributes));
+        }
+
+        if (grid->levels[0].numNodes != 1) {
+          runtimeError("serialized vdb grid is corrupt");
+        }
+
+        for (uint32_t l = 0; l + 1 < VKL_VDB_NUM_LEVELS; ++l) {
+          verifyLevelVoxels(
+              *grid, l, header.numDenseNodes, header.numTileNodes);
+        }
+
+        grid->packedAddressing32 = header.packedAddressing32;
+
+        const auto mapNodeData = [&](const uint64_t *offsets,
+                                     uint64_t numItems) -> ispc::Data1D * {
+          ispc::Data1D *data =
+              allocator.allocate<ispc::Data1D>(numAttributes);
+
+          for (uint32_t a = 0; a < numAttributes; ++a) {
+            const VKLDataType dataType = (VKLDataType)attributeTypes[a];
+            const size_t itemSize      = sizeOf(dataType);
+
+            getSection<uint8_t>(
+                file, offsets[a], checkedMul(numItems, itemSize));
+
+            data[a].addr       = file.data() + offsets[a];
+            data[a].byteStride = itemSize;
+            data[a].numItems   = numItems;
+            data[a].dataType   = dataType;
+            data[a].compact    = true;
+          }
+
+          return data;
+        };
+
+        grid->nodesPackedDense = mapNodeData(
+            denseDataOffsets, checkedMul(header.numDenseNodes, leafNumVoxels));
+        grid->nodesPackedTile =
+            mapNodeData(tileDataOffsets, header.numTileNodes);
+
+        if (header.denseQuantizationOffset) {
+          grid->nodesPackedDenseQuantization =
+              getSection<VdbLeafQuantization>(
+                  file,
+                  header.denseQuantizationOffset,
+                  checkedMul(header.numDenseNodes, numAttributes));
+          grid->nodesPackedTileQuantization =
+              getSection<VdbLeafQuantization>(
+                  file,
+                  header.tileQuantizationOffset,
+                  checkedMul(header.numTileNodes, numAttributes));
+        }
+      } catch (...) {
+        detachMappedVdbGrid(*grid);
+        allocator.deallocate(grid->attributeTypes);
+        allocator.deallocate(grid->nodesPackedDense);
+        allocator.deallocate(grid->nodesPackedTile);
+        allocator.deallocate(grid);
+        throw;
+      }
+
+      return grid;
+    }
+
+    void detachMappedVdbGrid(VdbGrid &grid)
+    {
+      for (uint32_t l = 0; l + 1 < VKL_VDB_NUM_LEVELS; ++l) {
+        VdbLevel &level  = grid.levels[l];
+        level.origin     = nullptr;
+        level.voxels     = nullptr;
+        level.valueRange = nullptr;
+      }
+
+      grid.nodesPackedDenseQuantization = nullptr;
+      grid.nodesPackedTileQuantization  = nullptr;
+    }
+
+  }  // namespace cpu_device
+}  // namespace openvkl
@@ -0,0 +1,50 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <string>
+#include "../../common/Allocator.h"
+#include "VdbGrid.h"
+#include "openvkl/utility/mapped_file/MappedFile.h"
+
+namespace openvkl {
+  namespace cpu_device {
+
+    using utility::mapped_file::MappedFile;
+
+    /*
+     * Serialized grids store a committed VdbGrid (levels, value ranges, and
+     * node data in packed dense / tile layout) in a single binary file. All
+     * references within the file are byte offsets, so the file can be memory
+     * mapped at any address and used directly, without rebuilding the tree.
+     *
+     * Only sparse, temporally constant grids can be serialized.
+     */
+
+    /*
+     * Write the given committed grid to filename. bounds is the object space
+     * bounding box of the volume.
+     */
+    void exportVdbGrid(const VdbGrid &grid,
+                       const box3f &bounds,
+                       const std::string &filename);
+
+    /*
+     * Create a grid that refers to the serialized grid in the given mapped
+     * file. Only the grid structure and per-attribute arrays are allocated
+     * with allocator; all bulk data remains in the mapping, which must
+     * outlive the grid.
+     */
+    VdbGrid *mapVdbGrid(const MappedFile &file,
+                        Allocator &allocator,
+                        box3f &bounds);
+
+    /*
+     * Clear all references into the mapped file from the given grid, so that
+     * it can be deallocated like any other grid.
+     */
+    void detachMappedVdbGrid(VdbGrid &grid);
+
+  }  // namespace cpu_device
+}  // namespace openvkl
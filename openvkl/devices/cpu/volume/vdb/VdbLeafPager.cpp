@@ -0,0 +1,494 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "VdbLeafPager.h"
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <utility>
+#include "../../common/runtime_error.h"
+#include "rkcommon/memory/malloc.h"
+#include "rkcommon/tasking/parallel_for.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Called from the sampler (ISPC) when it encounters a node that is not
+ * resident. Returns non-zero if the node is resident afterwards.
+ */
+extern "C" int VdbLeafPager_load(void *pager, uint64_t leafIndex)
+{
+  return static_cast<openvkl::cpu_device::VdbLeafPager *>(pager)->load(
+             leafIndex)
+             ? 1
+             : 0;
+}
+
+/*
+ * Called from the sampler (ISPC) around accesses to node data that are not
+ * already covered by a read section on the C++ side.
+ */
+extern "C" uint64_t VdbLeafPager_beginRead(void *pager)
+{
+  return static_cast<openvkl::cpu_device::VdbLeafPager *>(pager)->beginRead();
+}
+
+extern "C" void VdbLeafPager_endRead(void *pager, uint64_t readEpoch)
+{
+  static_cast<openvkl::cpu_device::VdbLeafPager *>(pager)->endRead(readEpoch);
+}
+
+namespace openvkl {
+  namespace cpu_device {
+
+    // -------------------------------------------------------------------------
+
+    VdbNodePageCallbackSource::VdbNodePageCallbackSource(
+        VKLVdbNodePageCallback callback, void *userData)
+        : callback(callback), userData(userData)
+    {
+    }
+
+    void VdbNodePageCallbackSource::read(uint64_t nodeIndex,
+                                         uint32_t attributeIndex,
+                                         size_t /*numBytes*/,
+                                         void *buffer)
+    {
+      callback(userData, nodeIndex, attributeIndex, buffer);
+    }
+
+    // -------------------------------------------------------------------------
+
+    VdbNodePageFileSource::VdbNodePageFileSource(
+        const std::string &filename,
+        const Ref<const DataT<uint64_t>> &offsets,
+        uint32_t numAttributes)
+        : filename(filename), offsets(offsets), numAttributes(numAttributes)
+    {
+#ifdef _WIN32
+      HANDLE h = CreateFileA(filename.c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ,
+                             nullptr,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL,
+                             nullptr);
+      if (h == INVALID_HANDLE_VALUE) {
+        runtimeError("cannot open file ", filename);
+      }
+      file = h;
+#else
+      fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0) {
+        runtimeError("cannot open file ", filename);
+      }
+#endif
+    }
+
+    VdbNodePageFileSource::~VdbNodePageFileSource()
+    {
+#ifdef _WIN32
+      CloseHandle(static_cast<HANDLE>(file));
+#else
+      close(fd);
+#endif
+    }
+
+    void VdbNodePageFileSource::read(uint64_t nodeIndex,
+                                     uint32_t attributeIndex,
+                                     size_t numBytes,
+                                     void *buffer)
+    {
+      uint64_t offset = (*offsets)[nodeIndex * numAttributes + attributeIndex];
+      uint8_t *dst    = static_cast<uint8_t *>(buffer);
+
+      // Positional reads do not modify the file pointer, so there is no need
+      // to synchronize concurrent readers.
+      while (numBytes > 0) {
+#ifdef _WIN32
+        const DWORD chunk = static_cast<DWORD>(
+            std::min<size_t>(numBytes, std::numeric_limits<DWORD>::max()));
+        OVERLAPPED overlapped = {};
+        overlapped.Offset     = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD bytesRead       = 0;
+        if (!ReadFile(static_cast<HANDLE>(file),
+                      dst,
+                      chunk,
+                      &bytesRead,
+                      &overlapped) ||
+            bytesRead == 0) {
+          runtimeError("cannot read node ", nodeIndex, " from ", filename);
+        }
+        const size_t n = bytesRead;
+#else
+        const ssize_t n =
+            pread(fd, dst, numBytes, static_cast<off_t>(offset));
+        if (n <= 0) {
+          runtimeError("cannot read node ", nodeIndex, " from ", filename);
+        }
+#endif
+        dst += n;
+        offset += n;
+        numBytes -= n;
+      }
+    }
+
+    // -------------------------------------------------------------------------
+
+    VdbLeafPager::VdbLeafPager(std::unique_ptr<VdbNodePageSource> _source,
+                               VdbGrid &grid,
+                               const DataT<uint32_t> &leafFormat,
+                               uint64_t budget)
+        : source(std::move(_source)), grid(grid), budget(budget)
+    {
+      static_assert(sizeof(std::atomic<uint8_t>) == sizeof(vkl_uint8),
+                    "residency flags are shared with ISPC");
+
+      const uint64_t numLeaves     = grid.numLeaves;
+      const uint32_t numAttributes = grid.numAttributes;
+      const uint64_t numVoxels = vklVdbLevelNumVoxels(VKL_VDB_NUM_LEVELS - 1);
+
+      attributeOffset.resize(numAttributes);
+      size_t tileBytes = 0;
+      for (uint32_t a = 0; a < numAttributes; ++a) {
+        const size_t elementSize =
+            sizeOf(static_cast<VKLDataType>(grid.attributeTypes[a]));
+        attributeOffset[a] = denseNodeBytes;
+        denseNodeBytes += numVoxels * elementSize;
+        tileBytes += elementSize;
+      }
+
+      numReaders[0].store(0);
+      numReaders[1].store(0);
+
+      isDense.resize(numLeaves);
+      lastAccess.resize(numLeaves, 0);
+      buffers.resize(numLeaves, nullptr);
+      state.reset(new std::atomic<uint8_t>[numLeaves]);
+
+      uint64_t numTiles = 0;
+      for (uint64_t i = 0; i < numLeaves; ++i) {
+        isDense[i] = (leafFormat[i] == VKL_FORMAT_DENSE_ZYX);
+        state[i].store(NOT_RESIDENT);
+        numTiles += isDense[i] ? 0 : 1;
+      }
+
+      // Tile nodes are loaded once, and are not accounted for in the budget.
+      tileData.resize(numTiles * tileBytes);
+      std::vector<uint64_t> tiles;
+      tiles.reserve(numTiles);
+      for (uint64_t i = 0; i < numLeaves; ++i) {
+        if (!isDense[i]) {
+          tiles.push_back(i);
+        }
+      }
+
+      tasking::parallel_for(tiles.size(), [&](size_t t) {
+        const uint64_t i = tiles[t];
+        uint8_t *buffer  = tileData.data() + t * tileBytes;
+        for (uint32_t a = 0; a < numAttributes; ++a) {
+          const size_t elementSize =
+              sizeOf(static_cast<VKLDataType>(grid.attributeTypes[a]));
+          source->read(i, a, elementSize, buffer);
+          grid.leafData[i * numAttributes + a].addr = buffer;
+          buffer += elementSize;
+        }
+        state[i].store(RESIDENT);
+      });
+
+      grid.leafPager = this;
+      grid.leafResident =
+          reinterpret_cast<vkl_uint8 *>(static_cast<void *>(state.get()));
+      grid.leafLastAccess = lastAccess.data();
+      grid.leafPagerEpoch = epoch;
+    }
+
+    VdbLeafPager::~VdbLeafPager()
+    {
+      for (uint64_t i = 0; i < buffers.size(); ++i) {
+        if (buffers[i]) {
+          evict(i);
+        }
+      }
+      freeRetired(retired[0]);
+      freeRetired(retired[1]);
+
+      grid.leafPager      = nullptr;
+      grid.leafResident   = nullptr;
+      grid.leafLastAccess = nullptr;
+    }
+
+    bool VdbLeafPager::load(uint64_t leafIndex)
+    {
+      std::atomic<uint8_t> &s = state[leafIndex];
+
+      // Another thread may be paging this node in or out; wait for the
+      // outcome, and page the node in ourselves if it is not resident then.
+      for (;;) {
+        uint8_t expected = NOT_RESIDENT;
+        if (s.compare_exchange_strong(expected, LOADING)) {
+          break;
+        }
+        if (expected == RESIDENT) {
+          return true;
+        }
+        std::this_thread::yield();
+      }
+
+      assert(isDense[leafIndex]);
+
+      if (bytesUsed.fetch_add(denseNodeBytes) + denseNodeBytes > budget) {
+        bytesUsed -= denseNodeBytes;
+
+        std::lock_guard<std::mutex> lock(evictionMutex);
+        reclaim();
+        reserve();
+      }
+
+      uint8_t *buffer = static_cast<uint8_t *>(
+          rkcommon::memory::alignedMalloc(denseNodeBytes));
+
+      // We are called from the sampler, so we must not let exceptions escape.
+      try {
+        if (!buffer) {
+          throw std::bad_alloc();
+        }
+        for (uint32_t a = 0; a < grid.numAttributes; ++a) {
+          source->read(leafIndex,
+                       a,
+                       a + 1 < grid.numAttributes
+                           ? attributeOffset[a + 1] - attributeOffset[a]
+                           : denseNodeBytes - attributeOffset[a],
+                       buffer + attributeOffset[a]);
+        }
+      } catch (const std::exception &) {
+        rkcommon::memory::alignedFree(buffer);
+        bytesUsed -= denseNodeBytes;
+        numFailedLoads++;
+        s.store(NOT_RESIDENT, std::memory_order_release);
+        return false;
+      }
+
+      // Readers that saw a previous buffer of this node may still use it,
+      // which is fine: it is only freed once their read sections end.
+      const uint64_t dataIndex = leafIndex * grid.numAttributes;
+      for (uint32_t a = 0; a < grid.numAttributes; ++a) {
+        grid.leafData[dataIndex + a].addr = buffer + attributeOffset[a];
+      }
+      buffers[leafIndex] = buffer;
+
+      // Publish the node only after its data pointers are in place.
+      s.store(RESIDENT, std::memory_order_release);
+      return true;
+    }
+
+    void VdbLeafPager::reserve()
+    {
+      for (;;) {
+        uint64_t used = bytesUsed.load();
+        if (used + denseNodeBytes <= budget) {
+          if (bytesUsed.compare_exchange_weak(used, used + denseNodeBytes)) {
+            return;
+          }
+          continue;
+        }
+
+        if (retireOne()) {
+          continue;
+        }
+
+        // All of the budget is held by nodes that other threads are paging
+        // in right now. They do not need the eviction mutex to finish, and
+        // can be paged out afterwards.
+        if (used > 0) {
+          std::this_thread::yield();
+          continue;
+        }
+
+        // maintain() ensures that the budget holds at least one node, so
+        // this is only reached through transient reservations of threads
+        // that took the fast path in load(). Rather than waiting for them,
+        // we exceed the budget by one node.
+        bytesUsed += denseNodeBytes;
+        return;
+      }
+    }
+
+    bool VdbLeafPager::retireOne()
+    {
+      assert(epoch > 0);
+
+      // Clock sweep: nodes accessed in the current epoch get a second
+      // chance, and are marked as accessed in the previous epoch.
+      const uint64_t numLeaves = buffers.size();
+      for (uint64_t n = 0; n < 2 * numLeaves; ++n) {
+        const uint64_t i = clockHand;
+        clockHand        = (clockHand + 1) % numLeaves;
+
+        if (state[i].load() != RESIDENT || !isDense[i]) {
+          continue;
+        }
+
+        if (lastAccess[i] == epoch) {
+          lastAccess[i] = epoch - 1;
+          continue;
+        }
+
+        uint8_t expected = RESIDENT;
+        if (!state[i].compare_exchange_strong(expected, LOADING)) {
+          continue;
+        }
+
+        uint8_t *buffer = buffers[i];
+        buffers[i]      = nullptr;
+        bytesUsed -= denseNodeBytes;
+
+        // Data pointers stay in place for readers that found this node
+        // resident; new readers will page it in again. The retirement epoch
+        // must be read after the node is marked as not resident.
+        state[i].store(NOT_RESIDENT);
+        retired[readEpoch.load() & 1].push_back(buffer);
+        return true;
+      }
+
+      return false;
+    }
+
+    void VdbLeafPager::reclaim()
+    {
+      const uint64_t e = readEpoch.load();
+
+      // Slot (e + 1) & 1 holds the read sections and retired buffers of the
+      // previous read epoch. Readers entering from now on see epoch e or
+      // later, and therefore do not see these buffers.
+      if (numReaders[(e + 1) & 1].load() == 0) {
+        freeRetired(retired[(e + 1) & 1]);
+        readEpoch.store(e + 1);
+      }
+    }
+
+    void VdbLeafPager::freeRetired(std::vector<uint8_t *> &buffers)
+    {
+      for (uint8_t *buffer : buffers) {
+        rkcommon::memory::alignedFree(buffer);
+      }
+      buffers.clear();
+    }
+
+    uint64_t VdbLeafPager::beginRead()
+    {
+      for (;;) {
+        const uint64_t e = readEpoch.load();
+        numReaders[e & 1]++;
+
+        // If the epoch advanced in the meantime, our slot may belong to a
+        // newer epoch, whose retired buffers we could see.
+        if (readEpoch.load() == e) {
+          return e;
+        }
+        numReaders[e & 1]--;
+      }
+    }
+
+    void VdbLeafPager::endRead(uint64_t e)
+    {
+      numReaders[e & 1]--;
+    }
+
+    void VdbLeafPager::evict(uint64_t leafIndex)
+    {
+      assert(isDense[leafIndex]);
+      rkcommon::memory::alignedFree(buffers[leafIndex]);
+      buffers[leafIndex] = nullptr;
+
+      const uint64_t dataIndex = leafIndex * grid.numAttributes;
+      for (uint32_t a = 0; a < grid.numAttributes; ++a) {
+        grid.leafData[dataIndex + a].addr = nullptr;
+      }
+
+      state[leafIndex].store(NOT_RESIDENT);
+      bytesUsed -= denseNodeBytes;
+    }
+
+    void VdbLeafPager::maintain(const DataT<uint32_t> *prefetch,
+                                uint64_t newBudget)
+    {
+      if (newBudget < denseNodeBytes &&
+          std::find(isDense.begin(), isDense.end(), 1) != isDense.end()) {
+        runtimeError("nodePageBudget must hold at least one dense node (",
+                     denseNodeBytes,
+                     " bytes)");
+      }
+
+      budget = newBudget;
+
+      // There are no concurrent readers, so we may free all retired buffers.
+      freeRetired(retired[0]);
+      freeRetired(retired[1]);
+
+      std::vector<uint64_t> wanted;
+      if (prefetch) {
+        for (size_t i = 0; i < prefetch->size(); ++i) {
+          const uint64_t leafIndex = (*prefetch)[i];
+          if (leafIndex < grid.numLeaves && isDense[leafIndex] &&
+              !buffers[leafIndex]) {
+            wanted.push_back(leafIndex);
+          }
+        }
+        std::sort(wanted.begin(), wanted.end());
+        wanted.erase(std::unique(wanted.begin(), wanted.end()), wanted.end());
+      }
+
+      // Leave room for the prefetched nodes, and for some nodes to be paged
+      // in on demand before the next maintenance.
+      const uint64_t prefetchBytes = wanted.size() * denseNodeBytes;
+      const uint64_t lowWaterMark =
+          std::min(budget - budget / 4,
+                   budget > prefetchBytes ? budget - prefetchBytes : 0);
+
+      if (bytesUsed > lowWaterMark) {
+        std::vector<std::pair<vkl_uint32, uint64_t>> resident;
+        for (uint64_t i = 0; i < buffers.size(); ++i) {
+          if (buffers[i]) {
+            resident.emplace_back(lastAccess[i], i);
+          }
+        }
+
+        // Epochs only grow, so the least recently used nodes come first.
+        std::sort(resident.begin(), resident.end());
+
+        for (size_t i = 0; i < resident.size() && bytesUsed > lowWaterMark;
+             ++i) {
+          evict(resident[i].second);
+        }
+      }
+
+      ++epoch;
+
+      // Prefetching never pages out other nodes.
+      const uint64_t available =
+          budget > bytesUsed ? (budget - bytesUsed) / denseNodeBytes : 0;
+      if (wanted.size() > available) {
+        wanted.resize(available);
+      }
+
+      tasking::parallel_for(wanted.size(), [&](size_t i) {
+        if (load(wanted[i])) {
+          lastAccess[wanted[i]] = epoch;
+        }
+      });
+
+      grid.leafPagerEpoch = epoch;
+    }
+
+  }  // namespace cpu_device
+}  // namespace openvkl
@@ -0,0 +1,219 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <openvkl/volume.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../common/Data.h"
+#include "VdbGrid.h"
+
+namespace openvkl {
+  namespace cpu_device {
+
+    // Default memory budget for paged node data, in bytes.
+    static constexpr uint64_t vdbDefaultNodePageBudget = uint64_t(1) << 30;
+
+    /*
+     * The origin of paged node data. read() fills buffer with the compact
+     * data of the given node and attribute, and may be called concurrently
+     * from multiple threads.
+     */
+    struct VdbNodePageSource
+    {
+      virtual ~VdbNodePageSource() = default;
+
+      virtual void read(uint64_t nodeIndex,
+                        uint32_t attributeIndex,
+                        size_t numBytes,
+                        void *buffer) = 0;
+    };
+
+    /*
+     * Node data is provided by the application through a callback.
+     */
+    struct VdbNodePageCallbackSource : public VdbNodePageSource
+    {
+      VdbNodePageCallbackSource(VKLVdbNodePageCallback callback,
+                                void *userData);
+
+      void read(uint64_t nodeIndex,
+                uint32_t attributeIndex,
+                size_t numBytes,
+                void *buffer) override;
+
+     private:
+      VKLVdbNodePageCallback callback{nullptr};
+      void *userData{nullptr};
+    };
+
+    /*
+     * Node data is read from a file, at the byte offset given for each node
+     * and attribute.
+     */
+    struct VdbNodePageFileSource : public VdbNodePageSource
+    {
+      VdbNodePageFileSource(const std::string &filename,
+                            const Ref<const DataT<uint64_t>> &offsets,
+                            uint32_t numAttributes);
+      ~VdbNodePageFileSource() override;
+
+      void read(uint64_t nodeIndex,
+                uint32_t attributeIndex,
+                size_t numBytes,
+                void *buffer) override;
+
+     private:
+      std::string filename;
+      Ref<const DataT<uint64_t>> offsets;
+      uint32_t numAttributes{0};
+
+#ifdef _WIN32
+      void *file{nullptr};
+#else
+      int fd{-1};
+#endif
+    };
+
+    /*
+     * Keeps the data of dense leaf nodes resident within a memory budget.
+     *
+     * Nodes are paged in on first access, from any thread, through load().
+     * If the budget is exhausted, load() first pages out other nodes, picked
+     * by a clock sweep over their last access epoch. Samplers may still be
+     * reading a node that is paged out this way, so its buffer is retired
+     * rather than freed: all sampling calls run in a read section
+     * (beginRead() / endRead()), and retired buffers are freed once every
+     * read section that might have seen them has ended. Retired buffers are
+     * not accounted for in the budget, but only live for the duration of
+     * concurrent sampling calls.
+     *
+     * maintain() must not run concurrently with sampling. It frees all
+     * retired buffers, and pages out least recently used nodes in bulk.
+     *
+     * The pager publishes its residency and access time arrays in the grid;
+     * tile nodes are small and always resident.
+     */
+    class VdbLeafPager
+    {
+     public:
+      VdbLeafPager(std::unique_ptr<VdbNodePageSource> source,
+                   VdbGrid &grid,
+                   const DataT<uint32_t> &leafFormat,
+                   uint64_t budget);
+      ~VdbLeafPager();
+
+      VdbLeafPager(const VdbLeafPager &) = delete;
+      VdbLeafPager &operator=(const VdbLeafPager &) = delete;
+
+      /*
+       * Make the given node resident, paging out other nodes if necessary.
+       * Returns false only if the node could not be read. Must be called
+       * within a read section. Thread safe.
+       */
+      bool load(uint64_t leafIndex);
+
+      /*
+       * Page out least recently used nodes until the cache is below its low
+       * water mark, then page in the given nodes while they fit into the
+       * budget, and start a new access epoch. Not thread safe.
+       */
+      void maintain(const DataT<uint32_t> *prefetch, uint64_t newBudget);
+
+      /*
+       * Node data may only be accessed between beginRead() and endRead(),
+       * which receives the return value of beginRead(). Thread safe.
+       */
+      uint64_t beginRead();
+      void endRead(uint64_t readEpoch);
+
+      uint64_t getMemoryUsage() const
+      {
+        return bytesUsed.load();
+      }
+
+      uint64_t getNumFailedLoads() const
+      {
+        return numFailedLoads.load();
+      }
+
+     private:
+      enum : uint8_t
+      {
+        NOT_RESIDENT = 0,
+        RESIDENT     = 1,
+        LOADING      = 2
+      };
+
+      void evict(uint64_t leafIndex);
+
+      // These require evictionMutex to be held. reserve() accounts for a
+      // node to be paged in, retiring other nodes as necessary.
+      void reserve();
+      bool retireOne();
+      void reclaim();
+      void freeRetired(std::vector<uint8_t *> &buffers);
+
+      std::unique_ptr<VdbNodePageSource> source;
+      VdbGrid &grid;
+      uint64_t budget{0};
+
+      // Byte offset of each attribute within a dense node buffer, and the
+      // total size of a dense node buffer.
+      std::vector<size_t> attributeOffset;
+      size_t denseNodeBytes{0};
+
+      std::vector<uint8_t> isDense;
+      std::unique_ptr<std::atomic<uint8_t>[]> state;
+      std::vector<vkl_uint32> lastAccess;
+      std::vector<uint8_t *> buffers;
+      std::vector<uint8_t> tileData;
+
+      std::atomic<uint64_t> bytesUsed{0};
+      std::atomic<uint64_t> numFailedLoads{0};
+      vkl_uint32 epoch{0};
+
+      // Read sections are counted per parity of the read epoch. Buffers
+      // retired in read epoch e are freed when the read epoch advances past
+      // e + 1, which requires all read sections of epoch e to have ended.
+      std::atomic<uint64_t> readEpoch{0};
+      std::atomic<uint64_t> numReaders[2];
+      std::vector<uint8_t *> retired[2];
+
+      std::mutex evictionMutex;
+      uint64_t clockHand{0};
+    };
+
+    /*
+     * Scoped read section on an optional pager.
+     */
+    class VdbLeafPagerReadSection
+    {
+     public:
+      explicit VdbLeafPagerReadSection(VdbLeafPager *pager)
+          : pager(pager), readEpoch(pager ? pager->beginRead() : 0)
+      {
+      }
+
+      ~VdbLeafPagerReadSection()
+      {
+        if (pager) {
+          pager->endRead(readEpoch);
+        }
+      }
+
+      VdbLeafPagerReadSection(const VdbLeafPagerReadSection &) = delete;
+      VdbLeafPagerReadSection &operator=(const VdbLeafPagerReadSection &) =
+          delete;
+
+     private:
+      VdbLeafPager *pager{nullptr};
+      uint64_t readEpoch{0};
+    };
+
+  }  // namespace cpu_device
+}  // namespace openvkl
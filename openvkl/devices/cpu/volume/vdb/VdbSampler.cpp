@@ -2,6 +2,9 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "VdbSampler.h"
+#include <atomic>
+#include "../../common/runtime_error.h"
+#include "../../sampler/SortedSampling.h"
 #include "VdbLeafAccessObserver.h"
 #include "VdbSampler_ispc.h"
 #include "VdbVolume.h"
@@ -9,6 +12,32 @@
 namespace openvkl {
   namespace cpu_device {
 
+    /*
+     * Each thread keeps the nodes it visited last in an accessor, across
+     * sampling calls. This is what makes sampling along rays cheap: most
+     * consecutive queries do not leave the leaf node of the previous one.
+     * Accessors are tagged with the id of the sampler and the commit
+     * generation of the grid they were filled for, so that they are
+     * invalidated when a thread switches samplers, or the sampler or its
+     * volume is recommitted.
+     */
+    static ispc::VdbAccessor *getThreadAccessor()
+    {
+      static thread_local ispc::VdbAccessor accessor = {};
+      return &accessor;
+    }
+
+    static uint64_t newAccessorId(bool traversalCache)
+    {
+      // Zero disables the accessor, and marks an empty accessor.
+      static std::atomic<uint64_t> nextId{1};
+      return traversalCache ? nextId++ : 0;
+    }
+
+    // For paged node data, the sampling functions below run in a read
+    // section of the pager, so that nodes found resident are not freed
+    // before we return, even if other threads page them out.
+
     template <int W>
     VdbSampler<W>::VdbSampler(VdbVolume<W> &volume)
         : AddStructShared<VdbSamplerBase<W>, ispc::VdbSamplerShared>(volume)
@@ -17,11 +46,14 @@ namespace openvkl {
                 volume.getSh(),
                 leafAccessObservers.getIE(),
                 this->getSh());
+      this->getSh()->accessorId = newAccessorId(volume.getTraversalCache());
+      volume.registerSampler(this);
     }
 
     template <int W>
     VdbSampler<W>::~VdbSampler()
     {
+      volume->unregisterSampler(this);
       CALL_ISPC(VdbSampler_destroy, this->getSh());
     }
 
@@ -42,11 +74,42 @@ namespace openvkl {
       const uint32_t maxSamplingDepth = this->template getParam<int>(
           "maxSamplingDepth", volume->getMaxSamplingDepth());
 
+      const bool traversalCache = this->template getParam<bool>(
+          "traversalCache", volume->getTraversalCache());
+
+      const float lod = this->template getParam<float>("lod", 0.f);
+      if (!(lod >= 0.f)) {
+        runtimeError("lod must be non-negative, but is ", lod);
+      }
+
       CALL_ISPC(VdbSampler_set,
                 this->getSh(),
                 (ispc::VKLFilter)filter,
                 (ispc::VKLFilter)gradientFilter,
-                maxSamplingDepth);
+                maxSamplingDepth,
+                lod);
+
+      // Traversal results depend on maxSamplingDepth, so accessors filled
+      // before this commit must not be used.
+      this->getSh()->accessorId = newAccessorId(traversalCache);
+
+      sortQueries = this->template getParam<bool>("sortQueries", false);
+    }
+
+    template <int W>
+    void VdbSampler<W>::updateGrid()
+    {
+      // Sampling functions for dense data depend on the grid, so we set them
+      // up again with the parameters of the last commit. Accessors notice the
+      // new grid through its commit generation.
+      ispc::VdbSamplerShared *sh = this->getSh();
+      CALL_ISPC(VdbSampler_updateGrid, sh);
+      CALL_ISPC(VdbSampler_set,
+                sh,
+                (ispc::VKLFilter)sh->super.super.filter,
+                (ispc::VKLFilter)sh->super.super.gradientFilter,
+                sh->maxSamplingDepth,
+                sh->lod);
     }
 
     template <int W>
@@ -57,12 +120,14 @@ namespace openvkl {
     {
       assert(attributeIndex < volume->getNumAttributes());
       assertValidTime(time[0]);
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
       CALL_ISPC(VdbSampler_computeSample_uniform,
                 this->getSh(),
                 &objectCoordinates,
                 static_cast<const float *>(time),
                 attributeIndex,
-                static_cast<float *>(samples));
+                static_cast<float *>(samples),
+                getThreadAccessor());
     }
 
     template <int W>
@@ -74,13 +139,15 @@ namespace openvkl {
     {
       assert(attributeIndex < volume->getNumAttributes());
       assertValidTimes(valid, time);
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
       CALL_ISPC(VdbSampler_computeSample,
                 static_cast<const int *>(valid),
                 this->getSh(),
                 &objectCoordinates,
                 static_cast<const float *>(time),
                 attributeIndex,
-                static_cast<float *>(samples));
+                static_cast<float *>(samples),
+                getThreadAccessor());
     }
 
     template <int W>
@@ -92,13 +159,32 @@ namespace openvkl {
     {
       assert(attributeIndex < volume->getNumAttributes());
       assertAllValidTimes(N, times);
-      CALL_ISPC(VdbSampler_computeSample_stream,
-                this->getSh(),
-                N,
-                (const ispc::vec3f *)objectCoordinates,
-                times,
-                attributeIndex,
-                samples);
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
+
+      auto sampleN = [&](unsigned int n,
+                         const vvec3fn<1> *coordinates,
+                         const float *t,
+                         float *s) {
+        CALL_ISPC(VdbSampler_computeSample_stream,
+                  this->getSh(),
+                  n,
+                  (const ispc::vec3f *)coordinates,
+                  t,
+                  attributeIndex,
+                  s,
+                  getThreadAccessor());
+      };
+
+      if (sortQueries) {
+        computeSortedN(volume->getBoundingBox(),
+                       N,
+                       objectCoordinates,
+                       times,
+                       samples,
+                       sampleN);
+      } else {
+        sampleN(N, objectCoordinates, times, samples);
+      }
     }
 
     template <int W>
@@ -110,13 +196,15 @@ namespace openvkl {
     {
       assert(attributeIndex < volume->getNumAttributes());
       assertValidTimes(valid, time);
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
       CALL_ISPC(VdbSampler_computeGradient,
                 static_cast<const int *>(valid),
                 this->getSh(),
                 &objectCoordinates,
                 static_cast<const float *>(time),
                 attributeIndex,
-                &gradients);
+                &gradients,
+                getThreadAccessor());
     }
 
     template <int W>
@@ -128,13 +216,97 @@ namespace openvkl {
     {
       assert(attributeIndex < volume->getNumAttributes());
       assertAllValidTimes(N, times);
-      CALL_ISPC(VdbSampler_computeGradient_stream,
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
+
+      auto gradientN = [&](unsigned int n,
+                           const vvec3fn<1> *coordinates,
+                           const float *t,
+                           vvec3fn<1> *g) {
+        CALL_ISPC(VdbSampler_computeGradient_stream,
+                  this->getSh(),
+                  n,
+                  (const ispc::vec3f *)coordinates,
+                  t,
+                  attributeIndex,
+                  (ispc::vec3f *)g,
+                  getThreadAccessor());
+      };
+
+      if (sortQueries) {
+        computeSortedN(volume->getBoundingBox(),
+                       N,
+                       objectCoordinates,
+                       times,
+                       gradients,
+                       gradientN);
+      } else {
+        gradientN(N, objectCoordinates, times, gradients);
+      }
+    }
+
+    template <int W>
+    void VdbSampler<W>::computeSampleAndGradientV(
+        const vintn<W> &valid,
+        const vvec3fn<W> &objectCoordinates,
+        vfloatn<W> &samples,
+        vvec3fn<W> &gradients,
+        unsigned int attributeIndex,
+        const vfloatn<W> &time) const
+    {
+      assert(attributeIndex < volume->getNumAttributes());
+      assertValidTimes(valid, time);
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
+      CALL_ISPC(VdbSampler_computeSampleAndGradient,
+                static_cast<const int *>(valid),
                 this->getSh(),
-                N,
-                (const ispc::vec3f *)objectCoordinates,
-                times,
+                &objectCoordinates,
+                static_cast<const float *>(time),
                 attributeIndex,
-                (ispc::vec3f *)gradients);
+                static_cast<float *>(samples),
+                &gradients,
+                getThreadAccessor());
+    }
+
+    template <int W>
+    void VdbSampler<W>::computeSampleAndGradientN(
+        unsigned int N,
+        const vvec3fn<1> *objectCoordinates,
+        float *samples,
+        vvec3fn<1> *gradients,
+        unsigned int attributeIndex,
+        const float *times) const
+    {
+      assert(attributeIndex < volume->getNumAttributes());
+      assertAllValidTimes(N, times);
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
+
+      auto sampleAndGradientN = [&](unsigned int n,
+                                    const vvec3fn<1> *coordinates,
+                                    const float *t,
+                                    float *s,
+                                    vvec3fn<1> *g) {
+        CALL_ISPC(VdbSampler_computeSampleAndGradient_stream,
+                  this->getSh(),
+                  n,
+                  (const ispc::vec3f *)coordinates,
+                  t,
+                  attributeIndex,
+                  s,
+                  (ispc::vec3f *)g,
+                  getThreadAccessor());
+      };
+
+      if (sortQueries) {
+        computeSortedN(volume->getBoundingBox(),
+                       N,
+                       objectCoordinates,
+                       times,
+                       samples,
+                       gradients,
+                       sampleAndGradientN);
+      } else {
+        sampleAndGradientN(N, objectCoordinates, times, samples, gradients);
+      }
     }
 
     template <int W>
@@ -147,6 +319,7 @@ namespace openvkl {
     {
       assertValidAttributeIndices(volume, M, attributeIndices);
       assertValidTime(time[0]);
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
       CALL_ISPC(VdbSampler_computeSampleM_uniform,
                 this->getSh(),
                 &objectCoordinates,
@@ -167,6 +340,7 @@ namespace openvkl {
     {
       assertValidAttributeIndices(volume, M, attributeIndices);
       assertValidTimes(valid, time);
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
       CALL_ISPC(VdbSampler_computeSampleM,
                 static_cast<const int *>(valid),
                 this->getSh(),
@@ -188,6 +362,7 @@ namespace openvkl {
     {
       assertValidAttributeIndices(volume, M, attributeIndices);
       assertAllValidTimes(N, times);
+      VdbLeafPagerReadSection readSection(volume->getLeafPager());
       CALL_ISPC(VdbSampler_computeSampleM_stream,
                 this->getSh(),
                 N,
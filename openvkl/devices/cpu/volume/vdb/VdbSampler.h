@@ -31,6 +31,12 @@ namespace openvkl {
 
       void commit() override;
 
+      /*
+       * Point the sampler to the current grid of the volume. Called by the
+       * volume on every commit.
+       */
+      void updateGrid();
+
       // single attribute /////////////////////////////////////////////////////
 
       void computeSample(const vvec3fn<1> &objectCoordinates,
@@ -62,6 +68,22 @@ namespace openvkl {
                             unsigned int attributeIndex,
                             const float *times) const override final;
 
+      void computeSampleAndGradientV(
+          const vintn<W> &valid,
+          const vvec3fn<W> &objectCoordinates,
+          vfloatn<W> &samples,
+          vvec3fn<W> &gradients,
+          unsigned int attributeIndex,
+          const vfloatn<W> &time) const override final;
+
+      void computeSampleAndGradientN(
+          unsigned int N,
+          const vvec3fn<1> *objectCoordinates,
+          float *samples,
+          vvec3fn<1> *gradients,
+          unsigned int attributeIndex,
+          const float *times) const override final;
+
       // multi-attribute //////////////////////////////////////////////////////
 
       void computeSampleM(const vvec3fn<1> &objectCoordinates,
@@ -95,6 +117,8 @@ namespace openvkl {
       using VdbSamplerBase<W>::volume;
 
       ObserverRegistry<W> leafAccessObservers;
+
+      bool sortQueries{false};
     };
 
   }  // namespace cpu_device
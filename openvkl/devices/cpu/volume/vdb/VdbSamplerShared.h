@@ -31,6 +31,33 @@ typedef uniform float (*uniform DenseLeafSamplingUniformFunc)(
     uniform float time);
 #endif
 
+#ifndef __ISPC_STRUCT_VdbAccessor__
+#define __ISPC_STRUCT_VdbAccessor__
+
+  /*
+   * Remembers the last leaf node and the last inner node on the level above
+   * the leaves that traversal visited, so that coherent queries (e.g. along a
+   * ray) can skip the walk from the root node. An accessor must only be used
+   * by one thread at a time. Its content is only valid for the sampler
+   * (accessorId), grid commit generation and paging epoch it was filled for.
+   */
+  struct VdbAccessor
+  {
+    vkl_uint64 samplerId;
+    vkl_uint64 gridGeneration;
+    vkl_uint32 pagerEpoch;
+
+    vkl_uint32 leafValid;
+    vec3ui leafOrigin;
+    vkl_uint64 leafVoxel;
+
+    vkl_uint32 innerValid;
+    vec3ui innerOrigin;
+    vkl_uint64 innerNodeIndex;
+  };
+
+#endif
+
 #ifndef __ISPC_STRUCT_VdbSamplerShared__
 #define __ISPC_STRUCT_VdbSamplerShared__
 
@@ -42,6 +69,14 @@ typedef uniform float (*uniform DenseLeafSamplingUniformFunc)(
     const void *VKL_INTEROP_UNIFORM leafAccessObservers;
     vkl_uint32 maxSamplingDepth;
 
+    // Level of detail for dense volumes with mip levels; 0 samples the full
+    // resolution.
+    float lod;
+
+    // Unique for every committed sampler, used to validate VdbAccessors.
+    // Zero if the traversal cache is disabled.
+    vkl_uint64 accessorId;
+
     DenseLeafSamplingVaryingFunc *VKL_INTEROP_UNIFORM denseLeafSample_varying;
     DenseLeafSamplingUniformFunc *VKL_INTEROP_UNIFORM denseLeafSample_uniform;
   };
@@ -4,12 +4,19 @@
 #include "VdbVolume.h"
 #include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cmath>
 #include <cstring>
+#include <limits>
 #include <set>
+#include <sstream>
+#include <unordered_map>
 #include "../../common/export_util.h"
+#include "../../common/morton.h"
 #include "../../common/runtime_error.h"
 #include "../../common/temporal_data_verification.h"
 #include "../common/logging.h"
+#include "VdbGridSerialization.h"
 #include "VdbInnerNodeObserver.h"
 #include "openvkl/vdb.h"
 #include "rkcommon/math/AffineSpace.h"
@@ -28,27 +35,46 @@ namespace openvkl {
     template <int W>
     void VdbVolume<W>::cleanup()
     {
-      if (grid) {
+      // The pager refers to the grid, so it must go first.
+      leafPager.reset();
+
+      if (grid && mappedGridFile) {
+        detachMappedVdbGrid(*grid);
+      }
+      deallocateGrid(grid);
+      mappedGridFile.reset();
+
+      // other Data members are cleared in commit() as they are replaced, or on
+      // destruction
+    }
+
+    template <int W>
+    void VdbVolume<W>::deallocateGrid(VdbGrid *&g)
+    {
+      if (g) {
         // Note: There are VKL_VDB_NUM_LEVELS-1 slots for the
         //       level buffers! Leaves are not stored in the hierarchy!
         for (uint32_t l = 0; (l + 1) < vklVdbNumLevels(); ++l) {
-          VdbLevel &level = grid->levels[l];
+          VdbLevel &level = g->levels[l];
           allocator.deallocate(level.origin);
           allocator.deallocate(level.voxels);
           allocator.deallocate(level.valueRange);
+          allocator.deallocate(level.average);
         }
-        allocator.deallocate(grid->attributeTypes);
-        allocator.deallocate(grid->leafUnstructuredIndices);
-        allocator.deallocate(grid->leafUnstructuredTimes);
-        allocator.deallocate(grid->denseData);
-        allocator.deallocate(grid->leafData);
-        allocator.deallocate(grid->nodesPackedDense);
-        allocator.deallocate(grid->nodesPackedTile);
-        allocator.deallocate(grid);
+        allocator.deallocate(g->attributeTypes);
+        allocator.deallocate(g->leafUnstructuredIndices);
+        allocator.deallocate(g->leafUnstructuredTimes);
+        allocator.deallocate(g->denseData);
+        allocator.deallocate(g->denseBlockQuantization);
+        allocator.deallocate(g->denseMipData);
+        allocator.deallocate(g->leafData);
+        allocator.deallocate(g->leafQuantization);
+        allocator.deallocate(g->nodesPackedDenseQuantization);
+        allocator.deallocate(g->nodesPackedTileQuantization);
+        allocator.deallocate(g->nodesPackedDense);
+        allocator.deallocate(g->nodesPackedTile);
+        allocator.deallocate(g);
       }
-
-      // other Data members are cleared in commit() as they are replaced, or on
-      // destruction
     }
 
     template <int W>
@@ -144,6 +170,51 @@ namespace openvkl {
              ((uint64_t)vi.z);
     }
 
+    /*
+     * Remove duplicates from sorted keys, in parallel.
+     */
+    void parallelUnique(std::vector<uint64_t> &keys)
+    {
+      const size_t n = keys.size();
+
+      if (n <= sortBlockSize) {
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return;
+      }
+
+      const size_t numBlocks = (n + sortBlockSize - 1) / sortBlockSize;
+      std::vector<size_t> offsets(numBlocks + 1, 0);
+
+      const auto isFirst = [&](size_t i) {
+        return i == 0 || keys[i] != keys[i - 1];
+      };
+
+      tasking::parallel_for(numBlocks, [&](size_t b) {
+        const size_t end = std::min(n, (b + 1) * sortBlockSize);
+        for (size_t i = b * sortBlockSize; i < end; ++i) {
+          offsets[b + 1] += isFirst(i);
+        }
+      });
+
+      for (size_t b = 0; b < numBlocks; ++b) {
+        offsets[b + 1] += offsets[b];
+      }
+
+      std::vector<uint64_t> unique(offsets[numBlocks]);
+
+      tasking::parallel_for(numBlocks, [&](size_t b) {
+        size_t o         = offsets[b];
+        const size_t end = std::min(n, (b + 1) * sortBlockSize);
+        for (size_t i = b * sortBlockSize; i < end; ++i) {
+          if (isFirst(i)) {
+            unique[o++] = keys[i];
+          }
+        }
+      });
+
+      keys.swap(unique);
+    }
+
     /*
      * Initialize all (inner) levels. To do this, we must
      * count the number of inner nodes per level, and allocate buffers for
@@ -156,14 +227,17 @@ namespace openvkl {
         VdbGrid *grid,
         Allocator &allocator)
     {
-      // Comparator for voxel coordinates. We use this for sorting.
-      const auto isLess = [](const vec3i &a, const vec3i &b) {
-        return (a.x < b.x) || ((a.x == b.x) && (a.y < b.y)) ||
-               ((a.x == b.x) && (a.y == b.y) && (a.z < b.z));
-      };
+      // Nodes are identified by the Morton code of their origin, in units of
+      // the leaf level node resolution. Offsets from the root origin are
+      // smaller than twice the root node resolution.
+      const uint32_t leafLogRes = vklVdbLevelTotalLogRes(vklVdbNumLevels() - 1);
+      const uint32_t offsetBits = vklVdbLevelTotalLogRes(0) + 1;
+      if (offsetBits - leafLogRes > 21) {
+        runtimeError("vdb topology is too large for node keys");
+      }
 
-      // Origins on the previous level. These are offsets from grid->rootOrigin.
-      std::vector<vec3ui> oldInnerOrigins;
+      // Keys of nodes on the previous level.
+      std::vector<uint64_t> oldInnerKeys;
 
       // From the leaf level, go upwards quantizing leaf origins
       // to the respective level storage resolution, and count all
@@ -174,26 +248,37 @@ namespace openvkl {
         const int l = vklVdbNumLevels() - i - 1;
 
         // Quantize all of this level's leaf origins to the node size, mapping
-        // offsets to inner node origins. We can do this using simple masking
+        // offsets to inner node keys. We can do this using simple shifting
         // because node resolutions are powers of two.
-        std::vector<vec3ui> innerOrigins;
-        innerOrigins.reserve(oldInnerOrigins.size() + binnedLeaves[l].size());
-        for (uint64_t leaf : binnedLeaves[l])
-          innerOrigins.push_back(offsetToNodeOrigin(leafOffsets[leaf], l - 1));
-
-        // Also quanitize the child level's inner node origins.
-        for (const vec3ui &org : oldInnerOrigins) {
-          innerOrigins.push_back(offsetToNodeOrigin(org, l - 1));
-        }
-
-        // We now have a list of inner node origins on level l-1, but it
+        const uint32_t leafShift =
+            3 * (vklVdbLevelTotalLogRes(l - 1) - leafLogRes);
+        const uint32_t innerShift =
+            3 * (vklVdbLevelTotalLogRes(l - 1) - vklVdbLevelTotalLogRes(l));
+
+        const std::vector<uint64_t> &leaves = binnedLeaves[l];
+        std::vector<uint64_t> innerKeys(oldInnerKeys.size() + leaves.size());
+
+        tasking::parallel_for(leaves.size(), [&](size_t j) {
+          const vec3ui &offset = leafOffsets[leaves[j]];
+          innerKeys[j] = mortonEncode(vec3ui(offset.x >> leafLogRes,
+                                             offset.y >> leafLogRes,
+                                             offset.z >> leafLogRes)) >>
+                         leafShift;
+        });
+
+        // Also quanitize the child level's inner node keys.
+        tasking::parallel_for(oldInnerKeys.size(), [&](size_t j) {
+          innerKeys[leaves.size() + j] = oldInnerKeys[j] >> innerShift;
+        });
+
+        // We now have a list of inner node keys on level l-1, but it
         // contains duplicates. Sort and remove duplicates, and store for next
         // iterations.
-        std::sort(innerOrigins.begin(), innerOrigins.end(), isLess);
-        const auto end = std::unique(innerOrigins.begin(), innerOrigins.end());
-        const uint64_t levelNumInner = end - innerOrigins.begin();
-        innerOrigins.resize(levelNumInner);
-        oldInnerOrigins = std::move(innerOrigins);
+        parallelRadixSort(innerKeys,
+                          3 * (offsetBits - vklVdbLevelTotalLogRes(l - 1)));
+        parallelUnique(innerKeys);
+        const uint64_t levelNumInner = innerKeys.size();
+        oldInnerKeys                 = std::move(innerKeys);
 
         if (levelNumInner > 0) {
           assert(l > 1 ||
@@ -239,116 +324,289 @@ namespace openvkl {
       return range;
     }
 
+    /*
+     * Compute the average value of a leaf, at time 0.
+     */
+    float computeAverage(const void *volumeISPC,
+                         const VdbGrid *grid,
+                         const vec3ui &offset,
+                         unsigned int attributeIndex)
+    {
+      float average = 0.f;
+
+      CALL_ISPC(VdbSampler_computeAverage,
+                volumeISPC,
+                grid,
+                reinterpret_cast<const ispc::vec3ui *>(&offset),
+                attributeIndex,
+                &average);
+
+      return average;
+    }
+
+    /*
+     * Grow the buffers of inner level l so that they hold at least
+     * requiredCapacity nodes. Existing nodes are preserved.
+     */
+    void growInnerLevel(uint32_t l,
+                        uint64_t requiredCapacity,
+                        std::vector<uint64_t> &capacity,
+                        VdbGrid *grid,
+                        Allocator &allocator)
+    {
+      if (requiredCapacity <= capacity[l]) {
+        return;
+      }
+
+      // Grow geometrically so that repeated insertions amortize.
+      const uint64_t newCapacity =
+          std::max(requiredCapacity, capacity[l] + capacity[l] / 2);
+
+      VdbLevel &level              = grid->levels[l];
+      const uint64_t numVoxels     = vklVdbLevelNumVoxels(l);
+      const uint64_t numAttributes = grid->numAttributes;
+      const uint64_t numOldRanges  = level.numNodes * numVoxels * numAttributes;
+      const uint64_t numNewRanges  = newCapacity * numVoxels * numAttributes;
+
+      vec3ui *origin   = allocator.allocate<vec3ui>(newCapacity);
+      uint64_t *voxels = allocator.allocate<uint64_t>(newCapacity * numVoxels);
+      range1f *valueRange = allocator.allocate<range1f>(numNewRanges);
+
+      if (level.numNodes > 0) {
+        std::memcpy(origin, level.origin, level.numNodes * sizeof(vec3ui));
+        std::memcpy(voxels,
+                    level.voxels,
+                    level.numNodes * numVoxels * sizeof(uint64_t));
+        std::memcpy(
+            valueRange, level.valueRange, numOldRanges * sizeof(range1f));
+      }
+
+      range1f empty;
+      std::fill(valueRange + numOldRanges, valueRange + numNewRanges, empty);
+
+      allocator.deallocate(level.origin);
+      allocator.deallocate(level.voxels);
+      allocator.deallocate(level.valueRange);
+
+      level.origin     = origin;
+      level.voxels     = voxels;
+      level.valueRange = valueRange;
+      capacity[l]      = newCapacity;
+    }
+
+    /*
+     * Does the given inner node (and its children) contain no leaf nodes?
+     */
+    bool isEmptySubtree(const VdbGrid *grid, uint32_t l, uint64_t nodeIndex)
+    {
+      const uint64_t numVoxels = vklVdbLevelNumVoxels(l);
+      const uint64_t *voxels   = grid->levels[l].voxels + nodeIndex * numVoxels;
+      for (uint64_t v = 0; v < numVoxels; ++v) {
+        if (vklVdbVoxelIsLeafPtr(voxels[v]) ||
+            (vklVdbVoxelIsChildPtr(voxels[v]) &&
+             !isEmptySubtree(
+                 grid, l + 1, vklVdbVoxelChildGetIndex(voxels[v])))) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /*
+     * Insert a single leaf node into the tree, creating inner nodes as needed.
+     * Inner levels are grown if their capacity is exceeded.
+     */
+    void insertLeaf(const vec3ui &offset,
+                    uint32_t leafLevel,
+                    uint64_t leafPtr,
+                    std::vector<uint64_t> &capacity,
+                    VdbGrid *grid,
+                    Allocator &allocator)
+    {
+      uint64_t nodeIndex = 0;
+      for (size_t l = 0; l < leafLevel; ++l) {
+        VdbLevel &level = grid->levels[l];
+        // PRECOND: nodeIndex is valid.
+        assert(nodeIndex < level.numNodes);
+
+        const uint64_t voxelIndex = offsetToLinearVoxelIndex(offset, l);
+        // NOTE: If this is every greater than 2^32-1 then we will have to
+        // use 64 bit addressing.
+        const uint64_t v = nodeIndex * vklVdbLevelNumVoxels(l) + voxelIndex;
+        assert(v < ((uint64_t)1) << 32);
+
+        uint64_t &voxel = level.voxels[v];
+        if (vklVdbVoxelIsLeafPtr(voxel)) {
+          assert(false);
+          runtimeError(
+              "Attempted to insert a leaf node into a leaf node (level ",
+              l + 1,
+              ", origin ",
+              offsetToNodeOrigin(offset, l),
+              ")");
+
+        } else if (vklVdbVoxelIsEmpty(voxel)) {
+          const size_t nl = l + 1;
+          if (nl < leafLevel) {
+            VdbLevel &nextLevel = grid->levels[nl];
+            growInnerLevel(
+                nl, nextLevel.numNodes + 1, capacity, grid, allocator);
+            nodeIndex = nextLevel.numNodes++;
+            voxel     = vklVdbVoxelMakeChildPtr(nodeIndex);
+            nextLevel.origin[nodeIndex] = offsetToNodeOrigin(offset, nl);
+          } else {
+            voxel = leafPtr;
+          }
+        } else if (l + 1 == leafLevel &&
+                   isEmptySubtree(
+                       grid, l + 1, vklVdbVoxelChildGetIndex(voxel))) {
+          // Inner nodes may be left empty when leaf nodes are removed in
+          // incremental commits. Tiles replace them.
+          voxel = leafPtr;
+        } else {
+          nodeIndex = vklVdbVoxelChildGetIndex(voxel);
+          assert(nodeIndex < grid->levels[l + 1].numNodes);
+        }
+      }
+    }
+
     /*
      * Insert leaf nodes into the tree, creating inner nodes as needed.
-     * This function does not allocate anything; allocateInnerLevels() has done
-     * this already.
+     * allocateInnerLevels() has allocated all buffers already, so this does
+     * not allocate anything.
      */
     void insertLeaves(const std::vector<vec3ui> &leafOffsets,
                       const DataT<uint32_t> &leafFormat,
                       const DataT<uint32_t> &leafTemporalFormat,
                       const std::vector<std::vector<uint64_t>> &binnedLeaves,
-                      const std::vector<uint64_t> &capacity,
+                      std::vector<uint64_t> &capacity,
                       VdbGrid *grid,
+                      Allocator &allocator,
                       std::map<size_t, size_t> &nodeToDenseNodeIndex,
                       std::map<size_t, size_t> &nodeToTileNodeIndex)
     {
       assert(capacity[0] == 1);
       grid->levels[0].numNodes = 1;
 
+      const bool packed =
+          !(nodeToDenseNodeIndex.empty() && nodeToTileNodeIndex.empty());
+
       for (size_t leafLevel = 0; leafLevel < binnedLeaves.size(); ++leafLevel) {
         const auto &leaves = binnedLeaves[leafLevel];
         for (uint64_t idx : leaves) {
           const auto format = static_cast<VKLFormat>(leafFormat[idx]);
           const auto temporalFormat =
               static_cast<VKLTemporalFormat>(leafTemporalFormat[idx]);
+          assert(format == VKL_FORMAT_TILE || format == VKL_FORMAT_DENSE_ZYX);
 
-          const vec3ui &offset = leafOffsets[idx];
-          uint64_t nodeIndex   = 0;
-          for (size_t l = 0; l < leafLevel; ++l) {
-            VdbLevel &level = grid->levels[l];
-            // PRECOND: nodeIndex is valid.
-            assert(nodeIndex < level.numNodes);
-
-            const uint64_t voxelIndex = offsetToLinearVoxelIndex(offset, l);
-            // NOTE: If this is every greater than 2^32-1 then we will have to
-            // use 64 bit addressing.
-            const uint64_t v = nodeIndex * vklVdbLevelNumVoxels(l) + voxelIndex;
-            assert(v < ((uint64_t)1) << 32);
-
-            uint64_t &voxel = level.voxels[v];
-            if (vklVdbVoxelIsLeafPtr(voxel)) {
-              assert(false);
-              runtimeError(
-                  "Attempted to insert a leaf node into a leaf node (level ",
-                  l + 1,
-                  ", origin ",
-                  offsetToNodeOrigin(offset, l),
-                  ")");
-
-            } else if (vklVdbVoxelIsEmpty(voxel)) {
-              const size_t nl = l + 1;
-              if (nl < leafLevel) {
-                nodeIndex = grid->levels[nl].numNodes++;
-                assert(grid->levels[nl].numNodes <= capacity[nl]);
-                voxel = vklVdbVoxelMakeChildPtr(nodeIndex);
-                grid->levels[nl].origin[nodeIndex] =
-                    offsetToNodeOrigin(offset, nl);
-              } else {
-                if (format == VKL_FORMAT_TILE ||
-                    format == VKL_FORMAT_DENSE_ZYX) {
-                  if (nodeToDenseNodeIndex.empty() &&
-                      nodeToTileNodeIndex.empty()) {
-                    voxel = vklVdbVoxelMakeLeafPtr(idx, format, temporalFormat);
-                  } else {
-                    if (format == VKL_FORMAT_DENSE_ZYX) {
-                      voxel = vklVdbVoxelMakeLeafPtr(
-                          nodeToDenseNodeIndex[idx], format, temporalFormat);
-                    } else {
-                      voxel = vklVdbVoxelMakeLeafPtr(
-                          nodeToTileNodeIndex[idx], format, temporalFormat);
-                    }
-                  }
-                } else {
-                  assert(false);
-                }
-              }
-            } else {
-              nodeIndex = vklVdbVoxelChildGetIndex(voxel);
-              assert(nodeIndex < grid->levels[l + 1].numNodes);
-            }
+          uint64_t leafIndex = idx;
+          if (packed) {
+            leafIndex = (format == VKL_FORMAT_DENSE_ZYX)
+                            ? nodeToDenseNodeIndex[idx]
+                            : nodeToTileNodeIndex[idx];
           }
+
+          insertLeaf(leafOffsets[idx],
+                     leafLevel,
+                     vklVdbVoxelMakeLeafPtr(leafIndex, format, temporalFormat),
+                     capacity,
+                     grid,
+                     allocator);
         }
       }
     }
 
     /*
-     * Compute the value range for the given nodes.
-     * The tree must be fully initialized before calling this!
-     * This function takes into account filter radius.
+     * Find the voxel that holds the pointer to the leaf node at the given
+     * offset and level. Returns nullptr if there is no such leaf node.
      */
-    void computeValueRanges(const std::vector<vec3ui> &leafOffsets,
-                            const DataT<uint32_t> &leafLevel,
-                            const DataT<uint32_t> &leafFormat,
-                            const void *volumeISPC,
-                            VdbGrid *grid)
+    uint64_t *findLeafVoxel(VdbGrid *grid,
+                            const vec3ui &offset,
+                            uint32_t leafLevel)
     {
-      const uint64_t numLeaves = leafOffsets.size();
+      uint64_t nodeIndex = 0;
+      for (uint32_t l = 0; l < leafLevel; ++l) {
+        VdbLevel &level = grid->levels[l];
+        assert(nodeIndex < level.numNodes);
 
-      // The value range computation is a big part of commit() cost. We
-      // do it in parallel to make up for that as much as possible.
-      std::vector<std::vector<range1f>> valueRanges(
-          numLeaves, std::vector<range1f>(grid->numAttributes));
+        const uint64_t v = nodeIndex * vklVdbLevelNumVoxels(l) +
+                           offsetToLinearVoxelIndex(offset, l);
+        uint64_t &voxel = level.voxels[v];
 
-      tasking::parallel_for(numLeaves, [&](uint64_t idx) {
-        const auto format    = static_cast<VKLFormat>(leafFormat[idx]);
-        const vec3ui &offset = leafOffsets[idx];
+        if (l + 1 == leafLevel) {
+          return vklVdbVoxelIsLeafPtr(voxel) ? &voxel : nullptr;
+        }
 
-        for (unsigned int j = 0; j < grid->numAttributes; j++) {
-          valueRanges[idx][j] = computeValueRange(
-              volumeISPC, grid, format, leafLevel[idx], offset, j);
+        if (!vklVdbVoxelIsChildPtr(voxel)) {
+          return nullptr;
         }
-      });
+
+        nodeIndex = vklVdbVoxelChildGetIndex(voxel);
+      }
+      return nullptr;
+    }
+
+    /*
+     * Collect the indices of all leaf nodes below the given node whose origin
+     * is inside [lower, upper] (inclusive, root-relative offsets).
+     */
+    void collectLeavesInRange(const VdbGrid *grid,
+                              uint32_t l,
+                              uint64_t nodeIndex,
+                              const vec3l &lower,
+                              const vec3l &upper,
+                              std::vector<uint64_t> &leaves)
+    {
+      const VdbLevel &level   = grid->levels[l];
+      const vec3l nodeOrigin  = vec3l(level.origin[nodeIndex]);
+      const int64_t childRes  = vklVdbLevelRes(l + 1);
+      const int64_t resShift  = vklVdbLevelResShift(l);
+      const int64_t maxVoxel  = (int64_t(1) << resShift) - 1;
+      const vec3l voxelLower  = max(vec3l(0), (lower - nodeOrigin) / childRes);
+      const vec3l upperOffset = upper - nodeOrigin;
+
+      if (upperOffset.x < 0 || upperOffset.y < 0 || upperOffset.z < 0) {
+        return;
+      }
+
+      const vec3l voxelUpper = min(vec3l(maxVoxel), upperOffset / childRes);
+
+      for (int64_t x = voxelLower.x; x <= voxelUpper.x; ++x) {
+        for (int64_t y = voxelLower.y; y <= voxelUpper.y; ++y) {
+          for (int64_t z = voxelLower.z; z <= voxelUpper.z; ++z) {
+            const uint64_t v = nodeIndex * vklVdbLevelNumVoxels(l) +
+                               (x << (2 * resShift)) + (y << resShift) + z;
+            const uint64_t voxel = level.voxels[v];
+
+            if (vklVdbVoxelIsChildPtr(voxel)) {
+              collectLeavesInRange(grid,
+                                   l + 1,
+                                   vklVdbVoxelChildGetIndex(voxel),
+                                   lower,
+                                   upper,
+                                   leaves);
+            } else if (vklVdbVoxelIsLeafPtr(voxel)) {
+              const vec3l leafOrigin = nodeOrigin + childRes * vec3l(x, y, z);
+              if (leafOrigin.x >= lower.x && leafOrigin.y >= lower.y &&
+                  leafOrigin.z >= lower.z) {
+                leaves.push_back(vklVdbVoxelLeafGetIndex(voxel));
+              }
+            }
+          }
+        }
+      }
+    }
+
+    /*
+     * Store the given per-node value ranges in the inner levels, and extend
+     * all inner voxels on the path to each node.
+     */
+    void propagateValueRanges(const std::vector<vec3ui> &leafOffsets,
+                              const DataT<uint32_t> &leafLevel,
+                              const std::vector<range1f> &leafValueRanges,
+                              VdbGrid *grid)
+    {
+      const uint64_t numLeaves = leafOffsets.size();
 
       for (uint64_t idx = 0; idx < numLeaves; ++idx) {
         const vec3ui &offset = leafOffsets[idx];
@@ -367,7 +625,7 @@ namespace openvkl {
 
           for (unsigned int j = 0; j < grid->numAttributes; j++) {
             level.valueRange[v * grid->numAttributes + j].extend(
-                valueRanges[idx][j]);
+                leafValueRanges[idx * grid->numAttributes + j]);
           }
 
           uint64_t &voxel = level.voxels[v];
@@ -383,6 +641,212 @@ namespace openvkl {
       }
     }
 
+    /*
+     * Compute the value range for the given nodes.
+     * The tree must be fully initialized before calling this!
+     * This function takes into account filter radius.
+     *
+     * Per-node value ranges are returned in leafValueRanges, for all
+     * attributes: (range0, range1, ..., rangeNumAttributes)_0, [...]
+     */
+    void computeValueRanges(const std::vector<vec3ui> &leafOffsets,
+                            const DataT<uint32_t> &leafLevel,
+                            const DataT<uint32_t> &leafFormat,
+                            const void *volumeISPC,
+                            VdbGrid *grid,
+                            std::vector<range1f> &leafValueRanges)
+    {
+      const uint64_t numLeaves = leafOffsets.size();
+
+      // The value range computation is a big part of commit() cost. We
+      // do it in parallel to make up for that as much as possible.
+      leafValueRanges.resize(numLeaves * grid->numAttributes);
+
+      tasking::parallel_for(numLeaves, [&](uint64_t idx) {
+        const auto format    = static_cast<VKLFormat>(leafFormat[idx]);
+        const vec3ui &offset = leafOffsets[idx];
+
+        for (unsigned int j = 0; j < grid->numAttributes; j++) {
+          leafValueRanges[idx * grid->numAttributes + j] = computeValueRange(
+              volumeISPC, grid, format, leafLevel[idx], offset, j);
+        }
+      });
+
+      propagateValueRanges(leafOffsets, leafLevel, leafValueRanges, grid);
+    }
+
+    /*
+     * The value range of whatever covers the given root-relative offset:
+     * a node, according to nodeValueRange, or the background.
+     */
+    range1f findNodeValueRange(const VdbGrid *grid,
+                               const vec3l &offset,
+                               const DataT<box1f> &nodeValueRange,
+                               float backgroundOutOfBounds,
+                               uint32_t attributeIndex)
+    {
+      const vec3l activeSize(grid->activeSize);
+      if (offset.x < 0 || offset.y < 0 || offset.z < 0 ||
+          offset.x >= activeSize.x || offset.y >= activeSize.y ||
+          offset.z >= activeSize.z) {
+        return std::isnan(backgroundOutOfBounds)
+                   ? range1f()
+                   : range1f(backgroundOutOfBounds, backgroundOutOfBounds);
+      }
+
+      uint64_t nodeIndex = 0;
+      for (uint32_t l = 0; l + 1 < vklVdbNumLevels(); ++l) {
+        const uint64_t v = nodeIndex * vklVdbLevelNumVoxels(l) +
+                           offsetToLinearVoxelIndex(vec3ui(offset), l);
+        const uint64_t voxel = grid->levels[l].voxels[v];
+
+        if (vklVdbVoxelIsChildPtr(voxel)) {
+          nodeIndex = vklVdbVoxelChildGetIndex(voxel);
+        } else if (vklVdbVoxelIsLeafPtr(voxel)) {
+          const uint64_t leafIndex = vklVdbVoxelLeafGetIndex(voxel);
+          return nodeValueRange[leafIndex * grid->numAttributes +
+                                attributeIndex];
+        } else {
+          break;
+        }
+      }
+
+      // Empty voxels inside the domain have value zero, as in
+      // VdbSampler_computeValueRange.
+      return range1f(0.f, 0.f);
+    }
+
+    /*
+     * Compute the value range for the given nodes from user provided ranges,
+     * without accessing node data. Like computeValueRanges(), this accounts
+     * for filter support by including the 26 neighboring leaf-sized regions
+     * of each node.
+     */
+    void computePagedValueRanges(const std::vector<vec3ui> &leafOffsets,
+                                 const DataT<uint32_t> &leafLevel,
+                                 const DataT<box1f> &nodeValueRange,
+                                 const float *background,
+                                 VdbGrid *grid,
+                                 std::vector<range1f> &leafValueRanges)
+    {
+      const uint64_t numLeaves     = leafOffsets.size();
+      const uint32_t numAttributes = grid->numAttributes;
+      const int64_t res            = vklVdbLevelRes(vklVdbNumLevels() - 1);
+
+      leafValueRanges.resize(numLeaves * numAttributes);
+
+      tasking::parallel_for(numLeaves, [&](uint64_t idx) {
+        const vec3l center(leafOffsets[idx]);
+        const int64_t nodeRes = vklVdbLevelRes(leafLevel[idx]);
+
+        for (uint32_t a = 0; a < numAttributes; ++a) {
+          range1f range = nodeValueRange[idx * numAttributes + a];
+
+          for (int ix = -1; ix <= 1; ++ix) {
+            for (int iy = -1; iy <= 1; ++iy) {
+              for (int iz = -1; iz <= 1; ++iz) {
+                // Neighbors are one leaf resolution beyond the node bounds.
+                const vec3l neighbor(
+                    center.x + (ix < 0 ? -res : ix * nodeRes),
+                    center.y + (iy < 0 ? -res : iy * nodeRes),
+                    center.z + (iz < 0 ? -res : iz * nodeRes));
+                range.extend(findNodeValueRange(
+                    grid, neighbor, nodeValueRange, background[a], a));
+              }
+            }
+          }
+
+          leafValueRanges[idx * numAttributes + a] = range;
+        }
+      });
+
+      propagateValueRanges(leafOffsets, leafLevel, leafValueRanges, grid);
+    }
+
+    /*
+     * Collect the flat indices of all inner voxels on the path to the given
+     * (leaf level, offset) locations, per level. Paths end early where a
+     * voxel is no longer a child pointer, e.g. for leaf nodes that have been
+     * removed.
+     */
+    void collectVoxelsOnPaths(
+        const std::vector<std::pair<uint32_t, vec3ui>> &locations,
+        const VdbGrid *grid,
+        std::vector<std::vector<uint64_t>> &dirtyVoxels)
+    {
+      for (const auto &location : locations) {
+        const vec3ui &offset = location.second;
+
+        uint64_t nodeIndex = 0;
+        for (uint32_t l = 0; l < location.first; ++l) {
+          const VdbLevel &level = grid->levels[l];
+          const uint64_t v      = nodeIndex * vklVdbLevelNumVoxels(l) +
+                             offsetToLinearVoxelIndex(offset, l);
+          dirtyVoxels[l].push_back(v);
+
+          const uint64_t voxel = level.voxels[v];
+          if (!vklVdbVoxelIsChildPtr(voxel)) {
+            break;
+          }
+          nodeIndex = vklVdbVoxelChildGetIndex(voxel);
+        }
+      }
+    }
+
+    /*
+     * Recompute the value ranges of all inner voxels on the path to the given
+     * (leaf level, offset) locations, bottom up. Voxels are recomputed from
+     * their children, so this also handles leaf nodes that have been removed.
+     */
+    void updateInnerValueRanges(
+        const std::vector<std::pair<uint32_t, vec3ui>> &locations,
+        const std::vector<range1f> &leafValueRanges,
+        VdbGrid *grid)
+    {
+      const uint32_t numAttributes = grid->numAttributes;
+
+      // Flat voxel indices to update, per level.
+      std::vector<std::vector<uint64_t>> dirtyVoxels(vklVdbNumLevels() - 1);
+      collectVoxelsOnPaths(locations, grid, dirtyVoxels);
+
+      // Children must be up to date before their parents.
+      for (int l = vklVdbNumLevels() - 2; l >= 0; --l) {
+        std::vector<uint64_t> &voxels = dirtyVoxels[l];
+        std::sort(voxels.begin(), voxels.end());
+        voxels.erase(std::unique(voxels.begin(), voxels.end()), voxels.end());
+
+        VdbLevel &level = grid->levels[l];
+
+        tasking::parallel_for(voxels.size(), [&](size_t i) {
+          const uint64_t v     = voxels[i];
+          const uint64_t voxel = level.voxels[v];
+          range1f *range       = level.valueRange + v * numAttributes;
+
+          for (uint32_t a = 0; a < numAttributes; ++a) {
+            range[a] = range1f();
+          }
+
+          if (vklVdbVoxelIsLeafPtr(voxel)) {
+            const uint64_t leafIndex = vklVdbVoxelLeafGetIndex(voxel);
+            for (uint32_t a = 0; a < numAttributes; ++a) {
+              range[a] = leafValueRanges[leafIndex * numAttributes + a];
+            }
+          } else if (vklVdbVoxelIsChildPtr(voxel)) {
+            const VdbLevel &childLevel = grid->levels[l + 1];
+            const uint64_t numVoxels   = vklVdbLevelNumVoxels(l + 1);
+            const range1f *childRange =
+                childLevel.valueRange + vklVdbVoxelChildGetIndex(voxel) *
+                                            numVoxels * numAttributes;
+            for (uint64_t cv = 0; cv < numVoxels; ++cv) {
+              for (uint32_t a = 0; a < numAttributes; ++a) {
+                range[a].extend(childRange[cv * numAttributes + a]);
+              }
+            }
+          }
+        });
+      }
+    }
+
     template <int W>
     void VdbVolume<W>::initIndexSpaceTransforms()
     {
@@ -401,6 +865,10 @@ namespace openvkl {
     template <int W>
     void VdbVolume<W>::initLeafNodeData()
     {
+      const bool hasPagedData =
+          this->template getParam<void *>("nodePageCallback", nullptr) ||
+          !this->template getParam<std::string>("nodePageFile", "").empty();
+
       if (this->template hasParamDataT<Data *>("node.data") &&
           this->template hasParamDataT<Data *>("nodesPackedDense")) {
         throw std::runtime_error(
@@ -408,7 +876,25 @@ namespace openvkl {
             "not both");
       }
 
-      if (this->template hasParamDataT<Data *>("node.data")) {
+      nodePageAttributeTypes = nullptr;
+      nodeValueRange         = nullptr;
+
+      if (hasPagedData) {
+        if (this->template hasParamDataT<Data *>("node.data") ||
+            this->template hasParamDataT<Data *>("nodesPackedDense")) {
+          throw std::runtime_error(
+              "paged node data cannot be combined with node.data or "
+              "nodesPackedDense / nodesPackedTile");
+        }
+        if (prefilterInnerLevels) {
+          throw std::runtime_error(
+              "prefilterInnerLevels cannot be combined with paged node data");
+        }
+        nodePageAttributeTypes =
+            this->template getParamDataT<uint32_t>("nodePageAttributeTypes");
+        nodeValueRange =
+            this->template getParamDataT<box1f>("node.valueRange");
+      } else if (this->template hasParamDataT<Data *>("node.data")) {
         leafData = this->template getParamDataT<Data *>("node.data");
       } else if (this->template hasParamDataT<Data *>("nodesPackedDense")) {
         nodesPackedDense =
@@ -444,44 +930,264 @@ namespace openvkl {
           "node.temporallyUnstructuredIndices", nullptr);
       leafUnstructuredTimes = this->template getParamDataT<Data *>(
           "node.temporallyUnstructuredTimes", nullptr);
+
+      leafQuantizationScale = this->template getParamDataT<float>(
+          "node.quantizationScale", nullptr);
+      leafQuantizationOffset = this->template getParamDataT<float>(
+          "node.quantizationOffset", nullptr);
     }
 
     /*
-     * Extract the lef node data type, and verify that it is valid for all
-     * nodes.
+     * Quantized attributes store integer voxel values, which are decoded as
+     * offset + scale * value using per-node, per-attribute parameters.
      */
-    inline VKLDataType getLeafDataType(const Ref<const DataT<Data *>> &leafData)
+    inline bool isQuantizedDataType(VKLDataType dataType)
     {
-      assert(leafData->size() > 0);
-      const VKLDataType dataType = (*leafData)[0]->dataType;
-      for (size_t i = 1; i < leafData->size(); ++i) {
-        const VKLDataType curDataType = (*leafData)[i]->dataType;
-        if (curDataType != dataType) {
-          runtimeError("All nodes must have the same VKLDataType ",
-                       "in vdb volumes.");
-        }
+      return dataType == VKL_UCHAR || dataType == VKL_USHORT;
+    }
+
+    /*
+     * Gather the per-node dequantization parameters into the grid. For packed
+     * node data, parameters are stored in packed node order.
+     */
+    template <int W>
+    void VdbVolume<W>::initLeafQuantization(
+        const std::map<size_t, size_t> &nodeToDenseNodeIndex,
+        const std::map<size_t, size_t> &nodeToTileNodeIndex)
+    {
+      const uint64_t numAttributes = grid->numAttributes;
+
+      if (!leafQuantizationScale || !leafQuantizationOffset) {
+        runtimeError(
+            "node.quantizationScale and node.quantizationOffset must be set "
+            "for vdb volumes with quantized attributes");
       }
 
-      if (dataType != VKL_HALF && dataType != VKL_FLOAT &&
-          dataType != VKL_DATA) {
-        runtimeError("node.data arrays have data type ",
-                     dataType,
-                     " but only ",
-                     VKL_HALF,
-                     " (VKL_HALF), ",
-                     VKL_FLOAT,
-                     " (VKL_FLOAT), or ",
-                     VKL_DATA,
-                     " (VKL_DATA) is supported for vdb volumes.");
+      if (leafQuantizationScale->size() != grid->numLeaves * numAttributes ||
+          leafQuantizationOffset->size() != grid->numLeaves * numAttributes) {
+        runtimeError(
+            "node.quantizationScale and node.quantizationOffset must have "
+            "numNodes * numAttributes elements");
       }
 
-      return dataType;
-    }
+      const auto copyParameters = [&](VdbLeafQuantization *quantization,
+                                      size_t dstNode,
+                                      size_t srcNode) {
+        for (uint64_t a = 0; a < numAttributes; ++a) {
+          VdbLeafQuantization &q = quantization[dstNode * numAttributes + a];
+          q.scale  = (*leafQuantizationScale)[srcNode * numAttributes + a];
+          q.offset = (*leafQuantizationOffset)[srcNode * numAttributes + a];
+        }
+      };
 
-    /*
-     * Initialize a single node, and verify attribute types in the process.
-     *
-     * nodeData: an array with numAttributes entries.
+      if (leafData) {
+        grid->leafQuantization = allocator.allocate<VdbLeafQuantization>(
+            grid->numLeaves * numAttributes);
+        for (uint64_t n = 0; n < grid->numLeaves; ++n) {
+          copyParameters(grid->leafQuantization, n, n);
+        }
+      }
+
+      if (nodesPackedDense) {
+        grid->nodesPackedDenseQuantization =
+            allocator.allocate<VdbLeafQuantization>(
+                nodeToDenseNodeIndex.size() * numAttributes);
+        for (const auto &n : nodeToDenseNodeIndex) {
+          copyParameters(grid->nodesPackedDenseQuantization, n.second, n.first);
+        }
+      }
+
+      if (nodesPackedTile) {
+        grid->nodesPackedTileQuantization =
+            allocator.allocate<VdbLeafQuantization>(
+                nodeToTileNodeIndex.size() * numAttributes);
+        for (const auto &n : nodeToTileNodeIndex) {
+          copyParameters(grid->nodesPackedTileQuantization, n.second, n.first);
+        }
+      }
+    }
+
+    /*
+     * Copy packed node data, moving the node at packed index n to
+     * newIndex[n]. data is set up to refer to the copy.
+     */
+    inline void copyPackedNodes(const Data &source,
+                                const std::vector<size_t> &newIndex,
+                                size_t itemsPerNode,
+                                AlignedVector16<uint8_t> &destination,
+                                ispc::Data1D &data)
+    {
+      const size_t itemSize    = sizeOf(source.dataType);
+      const size_t nodeBytes   = itemsPerNode * itemSize;
+      const uint8_t *src       = source.ispc.addr;
+      const size_t srcStride   = source.ispc.byteStride;
+      const bool sourceCompact = source.compact();
+
+      destination.resize(newIndex.size() * nodeBytes);
+
+      tasking::parallel_for(newIndex.size(), [&](size_t n) {
+        uint8_t *dst = destination.data() + newIndex[n] * nodeBytes;
+        if (sourceCompact) {
+          std::memcpy(dst, src + n * nodeBytes, nodeBytes);
+        } else {
+          for (size_t i = 0; i < itemsPerNode; ++i) {
+            std::memcpy(dst + i * itemSize,
+                        src + (n * itemsPerNode + i) * srcStride,
+                        itemSize);
+          }
+        }
+      });
+
+      data            = source.ispc;
+      data.addr       = destination.data();
+      data.byteStride = itemSize;
+      data.compact    = true;
+    }
+
+    /*
+     * Reorder packed dense and tile node data along a Z-order curve, so that
+     * spatially adjacent nodes are close in memory. The packed index maps are
+     * updated in place, so leaf pointers inserted later refer to the
+     * reordered data.
+     */
+    template <int W>
+    void VdbVolume<W>::reorderPackedNodeData(
+        std::map<size_t, size_t> &nodeToDenseNodeIndex,
+        std::map<size_t, size_t> &nodeToTileNodeIndex)
+    {
+      const uint32_t leafLogRes = vklVdbLevelTotalLogRes(vklVdbNumLevels() - 1);
+
+      const auto reorder = [&](std::map<size_t, size_t> &nodeToPackedIndex,
+                               const Ref<const DataT<Data *>> &nodesPacked,
+                               size_t itemsPerNode,
+                               std::vector<AlignedVector16<uint8_t>> &reordered,
+                               ispc::Data1D *data) {
+        // Node origins in units of the leaf node resolution, relative to the
+        // root origin.
+        std::vector<size_t> nodes;
+        std::vector<vec3ui> offsets;
+        nodes.reserve(nodeToPackedIndex.size());
+        offsets.reserve(nodeToPackedIndex.size());
+
+        uint32_t maxOffset = 0;
+        for (const auto &n : nodeToPackedIndex) {
+          const vec3ui offset =
+              static_cast<vec3ui>((*leafOrigin)[n.first] - grid->rootOrigin);
+          nodes.push_back(n.first);
+          offsets.emplace_back(offset.x >> leafLogRes,
+                               offset.y >> leafLogRes,
+                               offset.z >> leafLogRes);
+          maxOffset = std::max(maxOffset, reduce_max(offsets.back()));
+        }
+
+        const auto numBits = [](uint64_t v) -> uint32_t {
+          uint32_t bits = 0;
+          for (; v; v >>= 1) {
+            bits++;
+          }
+          return bits;
+        };
+
+        // Keys hold the index into nodes in the upper bits, and the Morton
+        // code of the node origin in the lower bits. For very large grids,
+        // origins are coarsened so that both fit; nodes in the same coarse
+        // cell then keep their relative order.
+        const uint32_t indexBits  = numBits(nodes.size());
+        const uint32_t offsetBits = numBits(maxOffset);
+        const uint32_t mortonAxisBits =
+            std::min(offsetBits, std::min(21u, (64 - indexBits) / 3));
+        const uint32_t mortonBits = 3 * mortonAxisBits;
+        const uint32_t shift      = offsetBits - mortonAxisBits;
+
+        std::vector<uint64_t> keys(nodes.size());
+        tasking::parallel_for(nodes.size(), [&](size_t i) {
+          const vec3ui &o = offsets[i];
+          keys[i]         = (uint64_t(i) << mortonBits) |
+                    mortonEncode(
+                        vec3ui(o.x >> shift, o.y >> shift, o.z >> shift));
+        });
+
+        parallelRadixSort(keys, mortonBits);
+
+        // New packed index, by current packed index.
+        std::vector<size_t> newIndex(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+          const size_t node     = nodes[keys[i] >> mortonBits];
+          size_t &packedIndex   = nodeToPackedIndex[node];
+          newIndex[packedIndex] = i;
+          packedIndex           = i;
+        }
+
+        if (!nodesPacked) {
+          return;
+        }
+
+        reordered.resize(grid->numAttributes);
+        for (uint32_t a = 0; a < grid->numAttributes; ++a) {
+          copyPackedNodes(*(*nodesPacked)[a],
+                          newIndex,
+                          itemsPerNode,
+                          reordered[a],
+                          data[a]);
+        }
+      };
+
+      reorder(nodeToDenseNodeIndex,
+              nodesPackedDense,
+              vklVdbLevelNumVoxels(VKL_VDB_NUM_LEVELS - 1),
+              reorderedNodesPackedDense,
+              grid->nodesPackedDense);
+
+      reorder(nodeToTileNodeIndex,
+              nodesPackedTile,
+              1,
+              reorderedNodesPackedTile,
+              grid->nodesPackedTile);
+
+      postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+          << "VDB: reordered packed node data along a Z-order curve";
+    }
+
+    /*
+     * Extract the lef node data type, and verify that it is valid for all
+     * nodes.
+     */
+    inline VKLDataType getLeafDataType(const Ref<const DataT<Data *>> &leafData)
+    {
+      assert(leafData->size() > 0);
+      const VKLDataType dataType = (*leafData)[0]->dataType;
+      for (size_t i = 1; i < leafData->size(); ++i) {
+        const VKLDataType curDataType = (*leafData)[i]->dataType;
+        if (curDataType != dataType) {
+          runtimeError("All nodes must have the same VKLDataType ",
+                       "in vdb volumes.");
+        }
+      }
+
+      if (dataType != VKL_HALF && dataType != VKL_FLOAT &&
+          !isQuantizedDataType(dataType) && dataType != VKL_DATA) {
+        runtimeError("node.data arrays have data type ",
+                     dataType,
+                     " but only ",
+                     VKL_HALF,
+                     " (VKL_HALF), ",
+                     VKL_FLOAT,
+                     " (VKL_FLOAT), ",
+                     VKL_UCHAR,
+                     " (VKL_UCHAR), ",
+                     VKL_USHORT,
+                     " (VKL_USHORT), or ",
+                     VKL_DATA,
+                     " (VKL_DATA) is supported for vdb volumes.");
+      }
+
+      return dataType;
+    }
+
+    /*
+     * Initialize a single node, and verify attribute types in the process.
+     *
+     * nodeData: an array with numAttributes entries.
      * expectedNumDataElements: The number of elements expected for each
      *                          attribute buffer.
      * attributeTypes: an array with numAttributes entries.
@@ -570,10 +1276,87 @@ namespace openvkl {
               (int)std::floor(bbox.lower.z / (float)vklVdbLevelRes(1)));
     }
 
+    /*
+     * Measures wall clock time of consecutive commit phases, for reporting
+     * at VKL_LOG_DEBUG level.
+     */
+    struct CommitPhaseTimer
+    {
+      using Clock = std::chrono::steady_clock;
+
+      // End the current phase, and start the next one.
+      void endPhase(const char *name)
+      {
+        const Clock::time_point now = Clock::now();
+        const std::chrono::duration<double, std::milli> duration = now - start;
+        phases.emplace_back(name, duration.count());
+        start = now;
+      }
+
+      std::string toString() const
+      {
+        std::stringstream ss;
+        for (const auto &phase : phases) {
+          ss << "\n  " << phase.first << ": " << phase.second << " ms";
+        }
+        return ss.str();
+      }
+
+      Clock::time_point start{Clock::now()};
+      std::vector<std::pair<const char *, double>> phases;
+    };
+
     template <int W>
     void VdbVolume<W>::commit()
     {
-      cleanup();
+      // Samplers must follow the grid even if the commit failed, as the
+      // previous grid is gone then.
+      try {
+        commitGrid();
+      } catch (...) {
+        updateSamplers();
+        throw;
+      }
+      updateSamplers();
+    }
+
+    template <int W>
+    void VdbVolume<W>::registerSampler(VdbSampler<W> *sampler)
+    {
+      std::lock_guard<std::mutex> lock(samplersMutex);
+      samplers.push_back(sampler);
+    }
+
+    template <int W>
+    void VdbVolume<W>::unregisterSampler(VdbSampler<W> *sampler)
+    {
+      std::lock_guard<std::mutex> lock(samplersMutex);
+      samplers.erase(std::remove(samplers.begin(), samplers.end(), sampler),
+                     samplers.end());
+    }
+
+    template <int W>
+    void VdbVolume<W>::updateSamplers()
+    {
+      // Zero is never used, so that zero-initialized accessors are invalid.
+      static std::atomic<uint64_t> nextCommitGeneration{1};
+      if (grid) {
+        grid->commitGeneration = nextCommitGeneration++;
+      }
+
+      std::lock_guard<std::mutex> lock(samplersMutex);
+      for (VdbSampler<W> *sampler : samplers) {
+        sampler->updateGrid();
+      }
+    }
+
+    template <int W>
+    void VdbVolume<W>::commitGrid()
+    {
+      CommitPhaseTimer timer;
+
+      incrementalCommit =
+          this->template getParam<bool>("incrementalCommit", false);
 
       filter = (VKLFilter)this->template getParam<int>("filter", filter);
       gradientFilter =
@@ -581,6 +1364,59 @@ namespace openvkl {
       maxSamplingDepth =
           this->template getParam<int>("maxSamplingDepth", maxSamplingDepth);
       maxSamplingDepth = std::min(maxSamplingDepth, VKL_VDB_NUM_LEVELS - 1u);
+      traversalCache =
+          this->template getParam<bool>("traversalCache", traversalCache);
+      reorderPackedNodes =
+          this->template getParam<bool>("reorderPackedNodes", false);
+      prefilterInnerLevels =
+          this->template getParam<bool>("prefilterInnerLevels", false);
+
+      // For paged node data, re-commits with an unchanged node configuration
+      // are where the node cache is maintained: we page out least recently
+      // used nodes, and page in requested nodes. This is safe because
+      // sampling must not run concurrently with commit().
+      if (leafPager && isPagedNodeConfigurationUnchanged()) {
+        leafPager->maintain(
+            this->template getParamDataT<uint32_t>("nodePagePrefetch", nullptr)
+                .ptr,
+            this->template getParam<uint64_t>("nodePageBudget",
+                                              vdbDefaultNodePageBudget));
+        timer.endPhase("node cache maintenance");
+
+        postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+            << "VDB: node cache holds " << leafPager->getMemoryUsage()
+            << " bytes, " << leafPager->getNumFailedLoads()
+            << " failed page-ins so far, time per phase:" << timer.toString();
+        return;
+      }
+
+      // For incremental commits, keep the previous tree around until we know
+      // if it can be updated in place.
+      VdbGrid *previousGrid = nullptr;
+      if (incrementalCommit && incrementalState.valid) {
+        std::swap(previousGrid, grid);
+      }
+
+      cleanup();
+
+      const std::string serializedGridFile =
+          this->template getParam<std::string>("serializedGridFile", "");
+
+      if (!dense && !serializedGridFile.empty()) {
+        deallocateGrid(previousGrid);
+        incrementalState = IncrementalState();
+        if (prefilterInnerLevels) {
+          runtimeError("prefilterInnerLevels cannot be combined with "
+                       "serializedGridFile");
+        }
+        try {
+          mapSerializedGrid(serializedGridFile);
+        } catch (...) {
+          cleanup();
+          throw;
+        }
+        return;
+      }
 
       // Set up the grid data structure.
       // We use exceptions for error reporting, so make sure to release
@@ -625,6 +1461,26 @@ namespace openvkl {
           } else {
             grid->denseTemporallyUnstructuredTimes = Data::emptyData1D;
           }
+
+          if (denseBrickLog2 > 0) {
+            brickDenseData();
+          } else {
+            brickedDenseData.clear();
+            brickedDenseIndices.clear();
+            brickedDenseTimes.clear();
+          }
+
+          if (denseCompressionBits > 0) {
+            compressDenseData();
+          } else {
+            compressedDenseData.clear();
+          }
+
+          if (denseMipLevels > 0) {
+            buildDenseMipLevels();
+          } else {
+            denseMipData.clear();
+          }
         }
 
         initLeafNodeData();
@@ -665,6 +1521,26 @@ namespace openvkl {
             } else {
               grid->attributeTypes[0] = leafDataType;
             }
+          } else if (nodePageAttributeTypes) {
+            grid->numAttributes = nodePageAttributeTypes->size();
+
+            grid->attributeTypes =
+                allocator.allocate<uint32_t>(grid->numAttributes);
+
+            for (uint32_t i = 0; i < grid->numAttributes; ++i) {
+              const VKLDataType dataType =
+                  static_cast<VKLDataType>((*nodePageAttributeTypes)[i]);
+              if (dataType != VKL_HALF && dataType != VKL_FLOAT) {
+                runtimeError("nodePageAttributeTypes has data type ",
+                             dataType,
+                             " but only ",
+                             VKL_HALF,
+                             " (VKL_HALF) or ",
+                             VKL_FLOAT,
+                             " (VKL_FLOAT) is supported for paged node data.");
+              }
+              grid->attributeTypes[i] = dataType;
+            }
           } else if (nodesPackedDense) {
             grid->numAttributes = nodesPackedDense->size();
 
@@ -680,6 +1556,16 @@ namespace openvkl {
           }
         }
 
+        // Quantized attributes are only supported for sparse volumes; dense
+        // volumes interpret integer data types directly.
+        bool hasQuantizedAttributes = false;
+        if (!grid->dense) {
+          for (uint32_t i = 0; i < grid->numAttributes; ++i) {
+            hasQuantizedAttributes |= isQuantizedDataType(
+                static_cast<VKLDataType>(grid->attributeTypes[i]));
+          }
+        }
+
         background = this->template getParamDataT<float>(
             "background", grid->numAttributes, VKL_BACKGROUND_UNDEFINED);
 
@@ -697,6 +1583,12 @@ namespace openvkl {
           runtimeError("node.data has incorrect size");
         }
 
+        if (nodeValueRange &&
+            nodeValueRange->size() != numLeafDataPointers) {
+          runtimeError(
+              "node.valueRange must have one entry per node and attribute");
+        }
+
         if (leafLevel->size() != grid->numLeaves ||
             leafOrigin->size() != grid->numLeaves ||
             leafFormat->size() != grid->numLeaves ||
@@ -795,12 +1687,14 @@ namespace openvkl {
           bounds.extend(xfmPoint(grid->indexToObject, v));
         }
 
+        timer.endPhase("setup");
+
         // Initialize and verify all nodes for sparse / non-dense volumes.
         if (!dense) {
           std::atomic_int allLeavesCompact(true);
           std::atomic_int allLeavesConstant(true);
 
-          if (leafData) {
+          if (leafData || nodePageAttributeTypes) {
             grid->leafData = allocator.allocate<ispc::Data1D>(
                 grid->numLeaves * grid->numAttributes);
           }
@@ -849,6 +1743,13 @@ namespace openvkl {
             allLeavesConstant &= static_cast<int>(temporalFormat ==
                                                   VKL_TEMPORAL_FORMAT_CONSTANT);
 
+            if (hasQuantizedAttributes &&
+                temporalFormat != VKL_TEMPORAL_FORMAT_CONSTANT) {
+              runtimeError(
+                  "quantized attributes are only supported for temporally "
+                  "constant nodes");
+            }
+
             const int structuredTimesteps =
                 leafStructuredTimesteps ? (*leafStructuredTimesteps)[i] : 0;
             const Data *unstructuredIndices =
@@ -875,6 +1776,26 @@ namespace openvkl {
                            grid->attributeTypes,
                            grid->numAttributes,
                            grid->leafData + i * grid->numAttributes));
+            } else if (nodePageAttributeTypes) {
+              if (temporalFormat != VKL_TEMPORAL_FORMAT_CONSTANT) {
+                runtimeError(
+                    "paged node data is only supported for temporally "
+                    "constant nodes");
+              }
+
+              // Data pointers are set by the pager once the node is
+              // resident.
+              for (uint32_t a = 0; a < grid->numAttributes; ++a) {
+                const VKLDataType dataType =
+                    static_cast<VKLDataType>(grid->attributeTypes[a]);
+                ispc::Data1D &data =
+                    grid->leafData[i * grid->numAttributes + a];
+                data.addr       = nullptr;
+                data.byteStride = sizeOf(dataType);
+                data.numItems   = expectedNumDataElements;
+                data.dataType   = dataType;
+                data.compact    = true;
+              }
             }
 
             if (unstructuredIndices && unstructuredTimes) {
@@ -891,6 +1812,8 @@ namespace openvkl {
           grid->allLeavesConstant = false;
         }
 
+        timer.endPhase("node verification");
+
         // For packed dense / tile node data: verify provided data sizes, set
         // addressing mode, and generate mapping of nodeIndex ->
         // [denseNodeIndex, tileNodeIndex]
@@ -983,53 +1906,1202 @@ namespace openvkl {
           }
         }
 
+        reorderedNodesPackedDense.clear();
+        reorderedNodesPackedTile.clear();
+
+        if (reorderPackedNodes && (nodesPackedDense || nodesPackedTile)) {
+          reorderPackedNodeData(nodeToDenseNodeIndex, nodeToTileNodeIndex);
+        }
+
+        if (hasQuantizedAttributes) {
+          initLeafQuantization(nodeToDenseNodeIndex, nodeToTileNodeIndex);
+        }
+
+        timer.endPhase("packed layout and quantization");
+
         // Build the data structure.
-        const auto binnedLeaves =
-            binLeavesPerLevel(grid->numLeaves, *leafLevel);
-        const auto leafOffsets =
+        auto leafOffsets =
             computeLeafOffsets(grid->numLeaves, *leafOrigin, grid->rootOrigin);
 
-        // Allocate buffers for all levels now, all in one go. This makes
-        // inserting the nodes (below) much faster.
         std::vector<uint64_t> capacity(vklVdbNumLevels() - 1, 0);
-        allocateInnerLevels(
-            leafOffsets, binnedLeaves, capacity, grid, allocator);
-
-        // This is where the magic happens. Insert leaves into the data
-        // structure top down.
-        insertLeaves(leafOffsets,
-                     *leafFormat,
-                     *leafTemporalFormat,
-                     binnedLeaves,
-                     capacity,
-                     grid,
-                     nodeToDenseNodeIndex,
-                     nodeToTileNodeIndex);
+        std::vector<range1f> leafValueRanges;
+        std::vector<float> leafAverages;
+
+        IncrementalChanges changes;
+        const bool incremental =
+            canUpdateIncrementally(previousGrid, hasQuantizedAttributes);
+
+        if (incremental) {
+          updateInnerLevels(
+              previousGrid, leafOffsets, capacity, leafValueRanges, changes);
+          timer.endPhase("incremental update");
+        } else {
+          const auto binnedLeaves =
+              binLeavesPerLevel(grid->numLeaves, *leafLevel);
+
+          // Allocate buffers for all levels now, all in one go. This makes
+          // inserting the nodes (below) much faster.
+          allocateInnerLevels(
+              leafOffsets, binnedLeaves, capacity, grid, allocator);
+          timer.endPhase("inner level allocation");
+
+          // This is where the magic happens. Insert leaves into the data
+          // structure top down.
+          insertLeaves(leafOffsets,
+                       *leafFormat,
+                       *leafTemporalFormat,
+                       binnedLeaves,
+                       capacity,
+                       grid,
+                       allocator,
+                       nodeToDenseNodeIndex,
+                       nodeToTileNodeIndex);
+          timer.endPhase("leaf insertion");
+
+          CALL_ISPC(VdbVolume_setGrid,
+                    this->getSh(),
+                    reinterpret_cast<const ispc::VdbGrid *>(grid));
+
+          if (nodePageAttributeTypes) {
+            initLeafPager();
+            timer.endPhase("pager setup");
+
+            computePagedValueRanges(leafOffsets,
+                                    *leafLevel,
+                                    *nodeValueRange,
+                                    background->data(),
+                                    grid,
+                                    leafValueRanges);
+          } else {
+            computeValueRanges(leafOffsets,
+                               *leafLevel,
+                               *leafFormat,
+                               this->getSh(),
+                               grid,
+                               leafValueRanges);
+          }
+          timer.endPhase("value ranges");
+        }
+
+        computeInnerAverages(
+            leafOffsets, incremental ? &changes : nullptr, leafAverages);
+        timer.endPhase("inner level prefiltering");
+
+        deallocateGrid(previousGrid);
+
+        computeVolumeValueRanges();
+
+        // Remember the node configuration for the next incremental commit.
+        incrementalState = IncrementalState();
+
+        if (incrementalCommit && !grid->dense && leafData &&
+            !hasQuantizedAttributes && grid->allLeavesConstant) {
+          IncrementalState &state = incrementalState;
+          state.rootOrigin        = grid->rootOrigin;
+          state.activeSize        = grid->activeSize;
+          state.attributeTypes.assign(
+              grid->attributeTypes,
+              grid->attributeTypes + grid->numAttributes);
+          state.background.assign(background->data(),
+                                  background->data() + grid->numAttributes);
+          state.capacity        = std::move(capacity);
+          state.leafData        = leafData;
+          state.leafOffsets     = std::move(leafOffsets);
+          state.leafValueRanges = std::move(leafValueRanges);
+          state.leafAverages    = std::move(leafAverages);
+
+          state.numInnerNodes.resize(vklVdbNumLevels() - 1);
+          for (uint32_t l = 0; (l + 1) < vklVdbNumLevels(); ++l) {
+            state.numInnerNodes[l] = grid->levels[l].numNodes;
+          }
+
+          state.leafLevel.resize(grid->numLeaves);
+          state.leafFormat.resize(grid->numLeaves);
+          for (uint64_t i = 0; i < grid->numLeaves; ++i) {
+            state.leafLevel[i]  = (*leafLevel)[i];
+            state.leafFormat[i] = (*leafFormat)[i];
+          }
+
+          state.valid = true;
+        }
 
-        CALL_ISPC(VdbVolume_setGrid,
-                  this->getSh(),
-                  reinterpret_cast<const ispc::VdbGrid *>(grid));
+        // Remember the node configuration for cache maintenance.
+        pagingState = PagingState();
+
+        if (leafPager) {
+          PagingState &state   = pagingState;
+          state.leafLevel      = leafLevel;
+          state.leafOrigin     = leafOrigin;
+          state.leafFormat     = leafFormat;
+          state.attributeTypes = nodePageAttributeTypes;
+          state.valueRange     = nodeValueRange;
+          state.pageOffset     = this->template getParamDataT<uint64_t>(
+              "node.pageOffset", nullptr);
+          state.callback =
+              this->template getParam<void *>("nodePageCallback", nullptr);
+          state.userData =
+              this->template getParam<void *>("nodePageUserData", nullptr);
+          state.file =
+              this->template getParam<std::string>("nodePageFile", "");
+          state.indexClippingBounds =
+              this->template getParam<box3i>("indexClippingBounds", empty);
+          state.indexToObject.assign(grid->indexToObject,
+                                     grid->indexToObject + 12);
+          state.background.assign(background->data(),
+                                  background->data() + grid->numAttributes);
+        }
 
-        computeValueRanges(
-            leafOffsets, *leafLevel, *leafFormat, this->getSh(), grid);
+        timer.endPhase("finalization");
 
-        // Aggregate value ranges for all attributes
-        valueRanges.clear();
-        valueRanges.resize(getNumAttributes());
+        const std::string exportFile = this->template getParam<std::string>(
+            "exportSerializedGridFile", "");
 
-        for (unsigned int a = 0; a < getNumAttributes(); ++a) {
-          valueRanges[a] = range1f();
-          for (size_t i = 0; i < vklVdbLevelNumVoxels(0); ++i) {
-            valueRanges[a].extend(
-                grid->levels[0].valueRange[i * grid->numAttributes + a]);
+        if (!exportFile.empty()) {
+          if (leafPager) {
+            runtimeError("vdb volumes with paged node data cannot be exported");
           }
+          exportVdbGrid(*grid, bounds, exportFile);
+          timer.endPhase("export");
         }
+
+        postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+            << "VDB: commit of " << grid->numLeaves
+            << " nodes, time per phase:" << timer.toString();
       } catch (...) {
+        deallocateGrid(previousGrid);
+        incrementalState = IncrementalState();
         cleanup();
         throw;
       }
     }
 
+    /*
+     * Copy the given range of items of source to the compact buffer dst.
+     */
+    inline void copyDataItems(const Data &source,
+                              uint64_t sourceBegin,
+                              uint64_t numItems,
+                              uint8_t *dst)
+    {
+      const size_t itemSize = sizeOf(source.dataType);
+      const uint8_t *src =
+          source.ispc.addr + sourceBegin * source.ispc.byteStride;
+
+      if (source.compact()) {
+        std::memcpy(dst, src, numItems * itemSize);
+      } else {
+        for (uint64_t i = 0; i < numItems; ++i) {
+          std::memcpy(
+              dst + i * itemSize, src + i * source.ispc.byteStride, itemSize);
+        }
+      }
+    }
+
+    // Marks padding voxels in forEachVoxelInBrick().
+    static constexpr uint64_t invalidBrickVoxel = uint64_t(-1);
+
+    /*
+     * Call f(slot, voxel) for all voxels in brick b of a bricked dense volume,
+     * in increasing slot order. slot is the bricked index and voxel is the
+     * linear index, or invalidBrickVoxel for padding.
+     */
+    template <typename Func>
+    inline void forEachVoxelInBrick(uint64_t b,
+                                    uint32_t log2,
+                                    const vec3ui &numBricks,
+                                    const vec3ui &dimensions,
+                                    Func &&f)
+    {
+      const uint32_t mask = (1u << log2) - 1;
+      const vec3ui brickOrigin(
+          uint32_t(b % numBricks.x) << log2,
+          uint32_t((b / numBricks.x) % numBricks.y) << log2,
+          uint32_t(b / (uint64_t(numBricks.x) * numBricks.y)) << log2);
+
+      uint64_t slot = b << (3 * log2);
+      for (uint32_t z = brickOrigin.z; z <= (brickOrigin.z | mask); ++z) {
+        for (uint32_t y = brickOrigin.y; y <= (brickOrigin.y | mask); ++y) {
+          for (uint32_t x = brickOrigin.x; x <= (brickOrigin.x | mask);
+               ++x, ++slot) {
+            const bool inside =
+                x < dimensions.x && y < dimensions.y && z < dimensions.z;
+            f(slot,
+              inside ? (uint64_t(z) * dimensions.y + y) * dimensions.x + x
+                     : invalidBrickVoxel);
+          }
+        }
+      }
+    }
+
+    /*
+     * Copy dense data into cubic bricks. The layout must match
+     * VdbSampler_denseVoxelIndex(): bricks are stored in x-fastest order, and
+     * so are the voxels within each brick. Bricks at the upper domain boundary
+     * may be partially filled; the remaining voxels are padding and never
+     * accessed.
+     *
+     * For temporally structured data, the time steps of each voxel remain
+     * contiguous. For temporally unstructured data, the time samples of each
+     * voxel are moved along with the voxel, and indices and times are
+     * rewritten accordingly.
+     */
+    template <int W>
+    void VdbVolume<W>::brickDenseData()
+    {
+      const uint32_t log2      = denseBrickLog2;
+      const uint32_t mask      = (1u << log2) - 1;
+      const uint64_t brickSize = uint64_t(1) << (3 * log2);
+
+      const vec3ui dimensions(denseDimensions);
+      const vec3ui numBricks((dimensions.x + mask) >> log2,
+                             (dimensions.y + mask) >> log2,
+                             (dimensions.z + mask) >> log2);
+      const uint64_t totalNumBricks = numBricks.long_product();
+
+      grid->denseBrickLog2 = log2;
+      grid->denseNumBricks = numBricks;
+
+      const size_t numAttributes = denseData.size();
+      const uint64_t numSlots    = totalNumBricks * brickSize;
+      brickedDenseData.resize(numAttributes);
+
+      if (denseTemporalFormat != VKL_TEMPORAL_FORMAT_UNSTRUCTURED) {
+        const uint64_t itemsPerVoxel =
+            denseTemporalFormat == VKL_TEMPORAL_FORMAT_STRUCTURED
+                ? denseTemporallyStructuredNumTimesteps
+                : 1;
+
+        for (size_t a = 0; a < numAttributes; ++a) {
+          const Data &source      = *denseData[a];
+          const size_t itemSize   = sizeOf(source.dataType);
+          const uint64_t numItems = numSlots * itemsPerVoxel;
+
+          AlignedVector16<uint8_t> &buffer = brickedDenseData[a];
+          buffer.assign(numItems * itemSize, 0);
+
+          tasking::parallel_for(totalNumBricks, [&](uint64_t b) {
+            forEachVoxelInBrick(
+                b,
+                log2,
+                numBricks,
+                dimensions,
+                [&](uint64_t slot, uint64_t voxel) {
+                  if (voxel != invalidBrickVoxel) {
+                    copyDataItems(
+                        source,
+                        voxel * itemsPerVoxel,
+                        itemsPerVoxel,
+                        buffer.data() + slot * itemsPerVoxel * itemSize);
+                  }
+                });
+          });
+
+          ispc::Data1D &data = grid->denseData[a];
+          data.addr          = buffer.data();
+          data.byteStride    = itemSize;
+          data.numItems      = numItems;
+          data.compact       = true;
+        }
+
+        brickedDenseIndices.clear();
+        brickedDenseTimes.clear();
+      } else {
+        const Data &indices    = *denseTemporallyUnstructuredIndices;
+        const size_t indexSize = sizeOf(indices.dataType);
+        const bool indices32   = (indices.dataType == VKL_UINT);
+
+        const auto readIndex = [&](uint64_t i) -> uint64_t {
+          const uint8_t *p = indices.ispc.addr + i * indices.ispc.byteStride;
+          return indices32 ? *reinterpret_cast<const uint32_t *>(p)
+                           : *reinterpret_cast<const uint64_t *>(p);
+        };
+
+        const auto numTimeSamples = [&](uint64_t voxel) -> uint64_t {
+          return voxel == invalidBrickVoxel
+                     ? 0
+                     : readIndex(voxel + 1) - readIndex(voxel);
+        };
+
+        // The first time sample of each brick in the bricked data.
+        std::vector<uint64_t> brickBegin(totalNumBricks + 1, 0);
+        tasking::parallel_for(totalNumBricks, [&](uint64_t b) {
+          uint64_t n = 0;
+          forEachVoxelInBrick(
+              b, log2, numBricks, dimensions, [&](uint64_t, uint64_t voxel) {
+                n += numTimeSamples(voxel);
+              });
+          brickBegin[b + 1] = n;
+        });
+        for (uint64_t b = 0; b < totalNumBricks; ++b) {
+          brickBegin[b + 1] += brickBegin[b];
+        }
+        const uint64_t numItems = brickBegin[totalNumBricks];
+
+        // The first time sample of each voxel, in the bricked and in the
+        // source data. Padding voxels have no time samples.
+        std::vector<uint64_t> slotBegin(numSlots + 1);
+        std::vector<uint64_t> sourceBegin(numSlots, 0);
+        tasking::parallel_for(totalNumBricks, [&](uint64_t b) {
+          uint64_t n = brickBegin[b];
+          forEachVoxelInBrick(b,
+                              log2,
+                              numBricks,
+                              dimensions,
+                              [&](uint64_t slot, uint64_t voxel) {
+                                slotBegin[slot] = n;
+                                if (voxel != invalidBrickVoxel) {
+                                  sourceBegin[slot] = readIndex(voxel);
+                                }
+                                n += numTimeSamples(voxel);
+                              });
+        });
+        slotBegin[numSlots] = numItems;
+
+        brickedDenseIndices.resize((numSlots + 1) * indexSize);
+        tasking::parallel_for(numSlots + 1, [&](uint64_t s) {
+          uint8_t *p = brickedDenseIndices.data() + s * indexSize;
+          if (indices32) {
+            *reinterpret_cast<uint32_t *>(p) = uint32_t(slotBegin[s]);
+          } else {
+            *reinterpret_cast<uint64_t *>(p) = slotBegin[s];
+          }
+        });
+
+        const auto copyTimeSamples = [&](const Data &source,
+                                         AlignedVector16<uint8_t> &buffer,
+                                         ispc::Data1D &data) {
+          const size_t itemSize = sizeOf(source.dataType);
+          buffer.resize(numItems * itemSize);
+          tasking::parallel_for(numSlots, [&](uint64_t s) {
+            copyDataItems(source,
+                          sourceBegin[s],
+                          slotBegin[s + 1] - slotBegin[s],
+                          buffer.data() + slotBegin[s] * itemSize);
+          });
+
+          data.addr       = buffer.data();
+          data.byteStride = itemSize;
+          data.numItems   = numItems;
+          data.compact    = true;
+        };
+
+        copyTimeSamples(*denseTemporallyUnstructuredTimes,
+                        brickedDenseTimes,
+                        grid->denseTemporallyUnstructuredTimes);
+
+        for (size_t a = 0; a < numAttributes; ++a) {
+          copyTimeSamples(
+              *denseData[a], brickedDenseData[a], grid->denseData[a]);
+        }
+
+        ispc::Data1D &indexData = grid->denseTemporallyUnstructuredIndices;
+        indexData.addr          = brickedDenseIndices.data();
+        indexData.byteStride    = indexSize;
+        indexData.numItems      = numSlots + 1;
+        indexData.compact       = true;
+      }
+
+      postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+          << "VDB: copied dense data into bricks of " << (mask + 1) << "^3"
+          << " voxels";
+    }
+
+    // IEEE 754 binary16 to float conversion.
+    inline float halfToFloat(uint16_t h)
+    {
+      const uint32_t sign     = uint32_t(h & 0x8000) << 16;
+      const uint32_t exponent = (h >> 10) & 0x1f;
+      const uint32_t mantissa = h & 0x3ff;
+
+      if (exponent == 0) {
+        // zero or subnormal
+        const float f = std::ldexp(float(mantissa), -24);
+        return sign ? -f : f;
+      }
+
+      const uint32_t bits =
+          sign | (exponent == 0x1f ? (0xffu << 23) : ((exponent + 112) << 23)) |
+          (mantissa << 13);
+
+      float f;
+      std::memcpy(&f, &bits, sizeof(float));
+      return f;
+    }
+
+    /*
+     * Read item i of source, which must have a voxel data type, as float.
+     */
+    inline float readDataItemAsFloat(const Data &source, uint64_t i)
+    {
+      const uint8_t *p = source.ispc.addr + i * source.ispc.byteStride;
+
+      switch (source.dataType) {
+      case VKL_UCHAR:
+        return *p;
+      case VKL_SHORT:
+        return *reinterpret_cast<const int16_t *>(p);
+      case VKL_USHORT:
+        return *reinterpret_cast<const uint16_t *>(p);
+      case VKL_HALF:
+        return halfToFloat(*reinterpret_cast<const uint16_t *>(p));
+      case VKL_FLOAT:
+        return *reinterpret_cast<const float *>(p);
+      case VKL_DOUBLE:
+        return float(*reinterpret_cast<const double *>(p));
+      default:
+        runtimeError("unsupported voxel data type ", source.dataType);
+      }
+      return 0.f;
+    }
+
+    /*
+     * Compress dense data with a fixed rate of denseCompressionBits per voxel.
+     * Voxels are grouped into blocks of 4^3, which are stored in the bricked
+     * layout expected by VdbSampler_denseVoxelIndex(). Each block is
+     * quantized uniformly between its minimum and maximum value, so that
+     * every voxel decodes independently of its neighbours. Quantization
+     * cannot represent non-finite values, so these are rejected.
+     */
+    template <int W>
+    void VdbVolume<W>::compressDenseData()
+    {
+      assert(denseBrickLog2 == 0);
+      assert(denseTemporalFormat == VKL_TEMPORAL_FORMAT_CONSTANT);
+
+      constexpr uint32_t log2      = 2;
+      constexpr uint32_t mask      = (1u << log2) - 1;
+      constexpr uint64_t blockSize = uint64_t(1) << (3 * log2);
+      const uint32_t bits          = denseCompressionBits;
+      const uint32_t maxCode       = (1u << bits) - 1;
+
+      const vec3ui dimensions(denseDimensions);
+      const vec3ui numBlocks((dimensions.x + mask) >> log2,
+                             (dimensions.y + mask) >> log2,
+                             (dimensions.z + mask) >> log2);
+      const uint64_t totalNumBlocks = numBlocks.long_product();
+
+      grid->denseBrickLog2         = log2;
+      grid->denseNumBricks         = numBlocks;
+      grid->denseCompressionBits   = bits;
+      grid->denseBlockQuantization = allocator.allocate<VdbLeafQuantization>(
+          totalNumBlocks * denseData.size());
+
+      const size_t numAttributes = denseData.size();
+      const uint64_t numBytes    = totalNumBlocks * blockSize * bits / 8;
+      compressedDenseData.resize(numAttributes);
+
+      for (size_t a = 0; a < numAttributes; ++a) {
+        const Data &source = *denseData[a];
+        AlignedVector16<uint8_t> &buffer = compressedDenseData[a];
+        buffer.assign(numBytes, 0);
+
+        VdbLeafQuantization *quantization =
+            grid->denseBlockQuantization + a * totalNumBlocks;
+
+        std::atomic_int allFinite(true);
+
+        tasking::parallel_for(totalNumBlocks, [&](uint64_t b) {
+          // Padding voxels are marked with NaN.
+          float values[blockSize];
+          float lower = std::numeric_limits<float>::infinity();
+          float upper = -std::numeric_limits<float>::infinity();
+
+          forEachVoxelInBrick(
+              b,
+              log2,
+              numBlocks,
+              dimensions,
+              [&](uint64_t slot, uint64_t voxel) {
+                float &v = values[slot & (blockSize - 1)];
+                if (voxel == invalidBrickVoxel) {
+                  v = std::numeric_limits<float>::quiet_NaN();
+                  return;
+                }
+                v = readDataItemAsFloat(source, voxel);
+                if (!std::isfinite(v)) {
+                  allFinite = false;
+                  v         = std::numeric_limits<float>::quiet_NaN();
+                  return;
+                }
+                lower = std::min(lower, v);
+                upper = std::max(upper, v);
+              });
+
+          // Every block contains at least one voxel, but all of them may
+          // have been rejected.
+          if (lower > upper) {
+            lower = upper = 0.f;
+          }
+
+          VdbLeafQuantization &q = quantization[b];
+          q.offset               = lower;
+          q.scale = (upper > lower) ? (upper - lower) / maxCode : 0.f;
+
+          uint8_t *codes = buffer.data() + b * blockSize * bits / 8;
+
+          for (uint32_t i = 0; i < blockSize; ++i) {
+            uint32_t code = 0;
+            if (q.scale > 0.f && !std::isnan(values[i])) {
+              const float c = std::round((values[i] - q.offset) / q.scale);
+              code = uint32_t(std::min(std::max(c, 0.f), float(maxCode)));
+            }
+
+            if (bits == 8) {
+              codes[i] = uint8_t(code);
+            } else {
+              codes[i >> 1] |= uint8_t(code << ((i & 1) << 2));
+            }
+          }
+        });
+
+        if (!allFinite) {
+          runtimeError("compressionBitsPerVoxel requires finite voxel values, "
+                       "but attribute ",
+                       a,
+                       " contains NaN or infinity");
+        }
+
+        ispc::Data1D &data = grid->denseData[a];
+        data.addr          = buffer.data();
+        data.byteStride    = 1;
+        data.numItems      = numBytes;
+        data.compact       = true;
+      }
+
+      postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+          << "VDB: compressed dense data to " << bits << " bits per voxel";
+    }
+
+    /*
+     * Build mip levels by averaging blocks of 2^3 voxels of the next finer
+     * level. Blocks at the upper domain boundary may be partial, and only
+     * average the voxels they contain. Mip levels are built from the
+     * application's data, so they are unaffected by compression.
+     */
+    template <int W>
+    void VdbVolume<W>::buildDenseMipLevels()
+    {
+      assert(denseTemporalFormat == VKL_TEMPORAL_FORMAT_CONSTANT);
+
+      // There is no point in going beyond a single voxel.
+      std::vector<vec3ui> levelDimensions(1, vec3ui(denseDimensions));
+      while (levelDimensions.size() <= denseMipLevels &&
+             reduce_max(levelDimensions.back()) > 1) {
+        levelDimensions.push_back((levelDimensions.back() + 1u) / 2u);
+      }
+
+      const uint32_t numLevels   = levelDimensions.size() - 1;
+      const size_t numAttributes = denseData.size();
+
+      grid->denseNumMipLevels = numLevels;
+      grid->denseMipData =
+          allocator.allocate<ispc::Data1D>(numLevels * numAttributes);
+
+      denseMipData.resize(numLevels * numAttributes);
+
+      for (size_t a = 0; a < numAttributes; ++a) {
+        const Data &source = *denseData[a];
+
+        for (uint32_t l = 1; l <= numLevels; ++l) {
+          const vec3ui &fine   = levelDimensions[l - 1];
+          const vec3ui &coarse = levelDimensions[l];
+
+          const float *finer =
+              l > 1 ? denseMipData[(l - 2) * numAttributes + a].data()
+                    : nullptr;
+          const auto readFine =
+              [&](uint32_t x, uint32_t y, uint32_t z) -> float {
+            const uint64_t i = (uint64_t(z) * fine.y + y) * fine.x + x;
+            return finer ? finer[i] : readDataItemAsFloat(source, i);
+          };
+
+          AlignedVector16<float> &buffer =
+              denseMipData[(l - 1) * numAttributes + a];
+          buffer.resize(coarse.long_product());
+
+          tasking::parallel_for(uint64_t(coarse.y) * coarse.z, [&](uint64_t r) {
+            const uint32_t y = uint32_t(r % coarse.y);
+            const uint32_t z = uint32_t(r / coarse.y);
+
+            const uint32_t zEnd = std::min(2 * z + 2, fine.z);
+            const uint32_t yEnd = std::min(2 * y + 2, fine.y);
+
+            for (uint32_t x = 0; x < coarse.x; ++x) {
+              const uint32_t xEnd = std::min(2 * x + 2, fine.x);
+
+              float sum         = 0.f;
+              uint32_t numItems = 0;
+              for (uint32_t fz = 2 * z; fz < zEnd; ++fz) {
+                for (uint32_t fy = 2 * y; fy < yEnd; ++fy) {
+                  for (uint32_t fx = 2 * x; fx < xEnd; ++fx, ++numItems) {
+                    sum += readFine(fx, fy, fz);
+                  }
+                }
+              }
+              buffer[r * coarse.x + x] = sum / numItems;
+            }
+          });
+
+          ispc::Data1D &data =
+              grid->denseMipData[(l - 1) * numAttributes + a];
+          data.addr       = reinterpret_cast<uint8_t *>(buffer.data());
+          data.byteStride = sizeof(float);
+          data.numItems   = buffer.size();
+          data.compact    = true;
+        }
+      }
+
+      postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+          << "VDB: built " << numLevels << " dense mip levels";
+    }
+
+    template <int W>
+    void VdbVolume<W>::mapSerializedGrid(const std::string &filename)
+    {
+      CommitPhaseTimer timer;
+
+      mappedGridFile = std::unique_ptr<MappedFile>(new MappedFile(filename));
+      grid           = mapVdbGrid(*mappedGridFile, allocator, bounds);
+
+      background = this->template getParamDataT<float>(
+          "background", grid->numAttributes, VKL_BACKGROUND_UNDEFINED);
+
+      this->setBackground(background->data());
+
+      CALL_ISPC(VdbVolume_setGrid,
+                this->getSh(),
+                reinterpret_cast<const ispc::VdbGrid *>(grid));
+
+      computeVolumeValueRanges();
+
+      timer.endPhase("mapping");
+
+      postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+          << "VDB: mapped serialized grid " << filename << " with "
+          << grid->numLeaves << " nodes, time per phase:" << timer.toString();
+    }
+
+    template <int W>
+    void VdbVolume<W>::initLeafPager()
+    {
+      const uint32_t numAttributes = grid->numAttributes;
+
+      std::unique_ptr<VdbNodePageSource> source;
+
+      auto callback = reinterpret_cast<VKLVdbNodePageCallback>(
+          this->template getParam<void *>("nodePageCallback", nullptr));
+
+      if (callback) {
+        source = std::unique_ptr<VdbNodePageSource>(
+            new VdbNodePageCallbackSource(
+                callback,
+                this->template getParam<void *>("nodePageUserData",
+                                                nullptr)));
+      } else {
+        Ref<const DataT<uint64_t>> pageOffset =
+            this->template getParamDataT<uint64_t>("node.pageOffset");
+
+        if (pageOffset->size() != grid->numLeaves * numAttributes) {
+          runtimeError(
+              "node.pageOffset must have one entry per node and attribute");
+        }
+
+        source = std::unique_ptr<VdbNodePageSource>(new VdbNodePageFileSource(
+            this->template getParam<std::string>("nodePageFile"),
+            pageOffset,
+            numAttributes));
+      }
+
+      const uint64_t budget = this->template getParam<uint64_t>(
+          "nodePageBudget", vdbDefaultNodePageBudget);
+
+      leafPager = std::unique_ptr<VdbLeafPager>(
+          new VdbLeafPager(std::move(source), *grid, *leafFormat, budget));
+
+      leafPager->maintain(
+          this->template getParamDataT<uint32_t>("nodePagePrefetch", nullptr)
+              .ptr,
+          budget);
+    }
+
+    template <int W>
+    bool VdbVolume<W>::isPagedNodeConfigurationUnchanged()
+    {
+      const PagingState &state = pagingState;
+
+      // The node configuration is immutable as long as the same data objects
+      // are used.
+      if (state.leafLevel.ptr !=
+              this->template getParamDataT<uint32_t>("node.level").ptr ||
+          state.leafOrigin.ptr !=
+              this->template getParamDataT<vec3i>("node.origin").ptr ||
+          state.leafFormat.ptr !=
+              this->template getParamDataT<uint32_t>("node.format").ptr ||
+          state.attributeTypes.ptr !=
+              this->template getParamDataT<uint32_t>("nodePageAttributeTypes",
+                                                     nullptr)
+                  .ptr ||
+          state.valueRange.ptr !=
+              this->template getParamDataT<box1f>("node.valueRange", nullptr)
+                  .ptr ||
+          state.pageOffset.ptr !=
+              this->template getParamDataT<uint64_t>("node.pageOffset",
+                                                     nullptr)
+                  .ptr) {
+        return false;
+      }
+
+      if (state.callback !=
+              this->template getParam<void *>("nodePageCallback", nullptr) ||
+          state.userData !=
+              this->template getParam<void *>("nodePageUserData", nullptr) ||
+          state.file !=
+              this->template getParam<std::string>("nodePageFile", "")) {
+        return false;
+      }
+
+      // Parameters that affect the tree or value ranges.
+      float indexToObject[12];
+      writeTransform(getParamAffineSpace3f(this, "indexToObject"),
+                     indexToObject);
+
+      const box3i indexClippingBounds =
+          this->template getParam<box3i>("indexClippingBounds", empty);
+
+      Ref<const DataT<float>> newBackground =
+          this->template getParamDataT<float>(
+              "background", grid->numAttributes, VKL_BACKGROUND_UNDEFINED);
+
+      return std::equal(state.indexToObject.begin(),
+                        state.indexToObject.end(),
+                        indexToObject) &&
+             indexClippingBounds == state.indexClippingBounds &&
+             std::equal(state.background.begin(),
+                        state.background.end(),
+                        newBackground->data(),
+                        [](float a, float b) {
+                          return a == b || (std::isnan(a) && std::isnan(b));
+                        });
+    }
+
+    /*
+     * Aggregate value ranges for all attributes from the root level.
+     */
+    template <int W>
+    void VdbVolume<W>::computeVolumeValueRanges()
+    {
+      valueRanges.clear();
+      valueRanges.resize(getNumAttributes());
+
+      for (unsigned int a = 0; a < getNumAttributes(); ++a) {
+        valueRanges[a] = range1f();
+        for (size_t i = 0; i < vklVdbLevelNumVoxels(0); ++i) {
+          valueRanges[a].extend(
+              grid->levels[0].valueRange[i * grid->numAttributes + a]);
+        }
+      }
+    }
+
+    /*
+     * Prefilter inner levels bottom up: each inner voxel stores the average of
+     * the leaf voxels it covers. On incremental commits, averages of nodes
+     * with unchanged data are reused, and only inner voxels on the paths to
+     * changed nodes (and in newly created inner nodes) are recomputed.
+     */
+    template <int W>
+    void VdbVolume<W>::computeInnerAverages(
+        const std::vector<vec3ui> &leafOffsets,
+        const IncrementalChanges *changes,
+        std::vector<float> &leafAverages)
+    {
+      const IncrementalState &state = incrementalState;
+      const uint64_t invalidIndex   = std::numeric_limits<uint64_t>::max();
+
+      // The weights below depend on the active domain, so all averages must
+      // be recomputed if it changed.
+      const bool incremental = changes && prefilterInnerLevels &&
+                               !grid->dense && !state.leafAverages.empty() &&
+                               state.activeSize == grid->activeSize;
+
+      leafAverages.clear();
+
+      if (!incremental) {
+        for (uint32_t l = 0; (l + 1) < vklVdbNumLevels(); ++l) {
+          allocator.deallocate(grid->levels[l].average);
+        }
+      }
+
+      if (!prefilterInnerLevels || grid->dense) {
+        return;
+      }
+
+      const uint64_t numLeaves     = grid->numLeaves;
+      const uint32_t numAttributes = grid->numAttributes;
+
+      leafAverages.resize(numLeaves * numAttributes);
+      tasking::parallel_for(numLeaves, [&](uint64_t idx) {
+        const uint64_t p =
+            incremental ? changes->unchangedIndex[idx] : invalidIndex;
+        for (uint32_t a = 0; a < numAttributes; ++a) {
+          leafAverages[idx * numAttributes + a] =
+              p == invalidIndex
+                  ? computeAverage(this->getSh(), grid, leafOffsets[idx], a)
+                  : state.leafAverages[p * numAttributes + a];
+        }
+      });
+
+      // The fraction of a voxel that is inside the active domain. Voxels on
+      // the domain boundary only average the values inside.
+      const vec3l activeSize(grid->activeSize);
+      const auto domainFraction = [&](const vec3ui &origin,
+                                      uint32_t res) -> float {
+        float fraction = 1.f;
+        for (int i = 0; i < 3; ++i) {
+          const int64_t inside = activeSize[i] - int64_t(origin[i]);
+          fraction *= std::min(std::max(inside, int64_t(0)), int64_t(res)) /
+                      float(res);
+        }
+        return fraction;
+      };
+
+      // Recompute the average of voxel v on inner level l from the leaf or
+      // child node it points to.
+      const auto computeVoxelAverage = [&](uint32_t l, uint64_t v) {
+        const VdbLevel &level = grid->levels[l];
+        const uint64_t voxel  = level.voxels[v];
+        float *average        = level.average + v * numAttributes;
+
+        // Empty voxels inside the domain have value zero, as in
+        // VdbSampler_computeValueRange.
+        std::fill_n(average, numAttributes, 0.f);
+
+        if (vklVdbVoxelIsLeafPtr(voxel)) {
+          const uint64_t leafIndex = vklVdbVoxelLeafGetIndex(voxel);
+          std::copy_n(leafAverages.begin() + leafIndex * numAttributes,
+                      numAttributes,
+                      average);
+        } else if (vklVdbVoxelIsChildPtr(voxel)) {
+          const VdbLevel &childLevel    = grid->levels[l + 1];
+          const uint64_t childIndex     = vklVdbVoxelChildGetIndex(voxel);
+          const uint64_t childNumVoxels = vklVdbLevelNumVoxels(l + 1);
+          const uint32_t childLogRes    = vklVdbLevelLogRes(l + 1);
+          const uint32_t childMask      = (1u << childLogRes) - 1;
+          const uint32_t childVoxelRes  = vklVdbLevelRes(l + 2);
+          const vec3ui &childOrigin     = childLevel.origin[childIndex];
+          const float *childAverage =
+              childLevel.average + childIndex * childNumVoxels * numAttributes;
+
+          float weightSum = 0.f;
+          for (uint64_t cv = 0; cv < childNumVoxels; ++cv) {
+            // Voxels are stored in z-fastest order, see
+            // offsetToLinearVoxelIndex().
+            const vec3ui cvIndex(uint32_t(cv >> (2 * childLogRes)),
+                                 uint32_t(cv >> childLogRes) & childMask,
+                                 uint32_t(cv) & childMask);
+            const float weight = domainFraction(
+                childOrigin + childVoxelRes * cvIndex, childVoxelRes);
+            weightSum += weight;
+            for (uint32_t a = 0; a < numAttributes; ++a) {
+              average[a] += weight * childAverage[cv * numAttributes + a];
+            }
+          }
+
+          if (weightSum > 0.f) {
+            for (uint32_t a = 0; a < numAttributes; ++a) {
+              average[a] /= weightSum;
+            }
+          }
+        }
+      };
+
+      if (!incremental) {
+        // Children must be prefiltered before their parents.
+        for (int l = vklVdbNumLevels() - 2; l >= 0; --l) {
+          VdbLevel &level          = grid->levels[l];
+          const uint64_t numVoxels = vklVdbLevelNumVoxels(l);
+
+          level.average = allocator.allocate<float>(
+              level.numNodes * numVoxels * numAttributes);
+
+          tasking::parallel_for(level.numNodes, [&](uint64_t n) {
+            for (uint64_t i = 0; i < numVoxels; ++i) {
+              computeVoxelAverage(l, n * numVoxels + i);
+            }
+          });
+        }
+        return;
+      }
+
+      // The tree (including averages) was taken over from the previous
+      // commit. Inner nodes are never removed, but new ones may have been
+      // appended; all of their voxels are recomputed.
+      std::vector<std::vector<uint64_t>> dirtyVoxels(vklVdbNumLevels() - 1);
+      collectVoxelsOnPaths(changes->locations, grid, dirtyVoxels);
+
+      for (uint32_t l = 0; (l + 1) < vklVdbNumLevels(); ++l) {
+        VdbLevel &level          = grid->levels[l];
+        const uint64_t numVoxels = vklVdbLevelNumVoxels(l);
+        const uint64_t numPreviousNodes =
+            std::min(state.numInnerNodes[l], level.numNodes);
+
+        float *average = allocator.allocate<float>(level.numNodes * numVoxels *
+                                                   numAttributes);
+        std::copy_n(level.average,
+                    numPreviousNodes * numVoxels * numAttributes,
+                    average);
+        allocator.deallocate(level.average);
+        level.average = average;
+
+        for (uint64_t v = numPreviousNodes * numVoxels;
+             v < level.numNodes * numVoxels;
+             ++v) {
+          dirtyVoxels[l].push_back(v);
+        }
+      }
+
+      for (int l = vklVdbNumLevels() - 2; l >= 0; --l) {
+        std::vector<uint64_t> &voxels = dirtyVoxels[l];
+        std::sort(voxels.begin(), voxels.end());
+        voxels.erase(std::unique(voxels.begin(), voxels.end()), voxels.end());
+
+        tasking::parallel_for(voxels.size(), [&](size_t i) {
+          computeVoxelAverage(l, voxels[i]);
+        });
+      }
+    }
+
+    template <int W>
+    bool VdbVolume<W>::canUpdateIncrementally(const VdbGrid *previousGrid,
+                                              bool hasQuantizedAttributes) const
+    {
+      const IncrementalState &state = incrementalState;
+
+      // Node offsets are packed into 64 bit keys, see updateInnerLevels().
+      if (!previousGrid || !state.valid || vklVdbLevelTotalLogRes(0) > 20) {
+        return false;
+      }
+
+      // Value ranges of unchanged nodes can only be reused if all inputs to
+      // the value range computation (other than node data) are unchanged.
+      if (grid->dense || !leafData || hasQuantizedAttributes ||
+          !grid->allLeavesConstant || grid->rootOrigin != state.rootOrigin ||
+          grid->numAttributes != state.attributeTypes.size()) {
+        return false;
+      }
+
+      if (!std::equal(state.attributeTypes.begin(),
+                      state.attributeTypes.end(),
+                      grid->attributeTypes)) {
+        return false;
+      }
+
+      // Compare bit patterns, the background may be NaN.
+      return std::memcmp(state.background.data(),
+                         background->data(),
+                         grid->numAttributes * sizeof(float)) == 0;
+    }
+
+    template <int W>
+    void VdbVolume<W>::updateInnerLevels(VdbGrid *previousGrid,
+                                         const std::vector<vec3ui> &leafOffsets,
+                                         std::vector<uint64_t> &capacity,
+                                         std::vector<range1f> &leafValueRanges,
+                                         IncrementalChanges &changes)
+    {
+      const IncrementalState &state = incrementalState;
+      const uint64_t numLeaves      = grid->numLeaves;
+      const uint64_t numPrevLeaves  = state.leafOffsets.size();
+      const uint32_t numAttributes  = grid->numAttributes;
+      const uint64_t invalidIndex   = std::numeric_limits<uint64_t>::max();
+      const uint32_t keyShift       = 21;
+
+      // Take over the tree of the previous commit.
+      for (uint32_t l = 0; (l + 1) < vklVdbNumLevels(); ++l) {
+        grid->levels[l]         = previousGrid->levels[l];
+        previousGrid->levels[l] = VdbLevel();
+      }
+      capacity = state.capacity;
+
+      // Nodes with data in shared buffers may be modified in place, in which
+      // case the application must flag them explicitly.
+      std::vector<char> flaggedModified(numLeaves, 0);
+      if (this->template hasParamDataT<uint32_t>("modifiedNodes")) {
+        const auto modifiedNodes =
+            this->template getParamDataT<uint32_t>("modifiedNodes");
+        for (uint32_t n : *modifiedNodes) {
+          if (n >= numLeaves) {
+            runtimeError("modifiedNodes contains invalid node index ", n);
+          }
+          flaggedModified[n] = 1;
+        }
+      }
+
+      // Match nodes to the previous commit by their origin. Node arrays are
+      // usually reused across commits, so try the same index first.
+      const auto key = [&](const vec3ui &offset) {
+        return (uint64_t(offset.x) << (2 * keyShift)) |
+               (uint64_t(offset.y) << keyShift) | uint64_t(offset.z);
+      };
+
+      std::unordered_map<uint64_t, uint64_t> previousIndexByKey;
+
+      std::vector<uint64_t> previousIndex(numLeaves, invalidIndex);
+      std::vector<char> previousMatched(numPrevLeaves, 0);
+
+      for (uint64_t i = 0; i < numLeaves; ++i) {
+        if ((*leafLevel)[i] == 0) {
+          runtimeError("there must not be any leaf nodes on level 0");
+        }
+
+        uint64_t p = invalidIndex;
+        if (i < numPrevLeaves && state.leafOffsets[i] == leafOffsets[i]) {
+          p = i;
+        } else {
+          if (previousIndexByKey.empty()) {
+            previousIndexByKey.reserve(numPrevLeaves);
+            for (uint64_t j = 0; j < numPrevLeaves; ++j) {
+              previousIndexByKey[key(state.leafOffsets[j])] = j;
+            }
+          }
+          const auto it = previousIndexByKey.find(key(leafOffsets[i]));
+          if (it != previousIndexByKey.end()) {
+            p = it->second;
+          }
+        }
+
+        // Duplicate nodes are treated as new, so that inserting them fails
+        // as it would in a full rebuild.
+        if (p != invalidIndex && !previousMatched[p] &&
+            state.leafLevel[p] == (*leafLevel)[i]) {
+          previousIndex[i]   = p;
+          previousMatched[p] = 1;
+        }
+      }
+
+      // Remove nodes that no longer exist.
+      std::vector<uint64_t> removedLeaves;
+      for (uint64_t p = 0; p < numPrevLeaves; ++p) {
+        if (!previousMatched[p]) {
+          uint64_t *voxel =
+              findLeafVoxel(grid, state.leafOffsets[p], state.leafLevel[p]);
+          assert(voxel);
+          *voxel = vklVdbVoxelMakeEmpty();
+          removedLeaves.push_back(p);
+        }
+      }
+
+      // Update pointers for nodes that were kept; their index or format may
+      // have changed. Nodes without a previous match are inserted.
+      std::vector<uint64_t> changedLeaves;
+      for (uint64_t i = 0; i < numLeaves; ++i) {
+        const uint64_t p = previousIndex[i];
+        const auto format = static_cast<VKLFormat>((*leafFormat)[i]);
+        const uint64_t leafPtr =
+            vklVdbVoxelMakeLeafPtr(i, format, VKL_TEMPORAL_FORMAT_CONSTANT);
+
+        if (p == invalidIndex) {
+          insertLeaf(leafOffsets[i],
+                     (*leafLevel)[i],
+                     leafPtr,
+                     capacity,
+                     grid,
+                     allocator);
+          changedLeaves.push_back(i);
+          continue;
+        }
+
+        if (p != i || state.leafFormat[p] != (*leafFormat)[i]) {
+          uint64_t *voxel =
+              findLeafVoxel(grid, leafOffsets[i], (*leafLevel)[i]);
+          assert(voxel);
+          *voxel = leafPtr;
+        }
+
+        if (flaggedModified[i] || state.leafFormat[p] != (*leafFormat)[i] ||
+            (*state.leafData)[p] != (*leafData)[i]) {
+          changedLeaves.push_back(i);
+        }
+      }
+
+      CALL_ISPC(VdbVolume_setGrid,
+                this->getSh(),
+                reinterpret_cast<const ispc::VdbGrid *>(grid));
+
+      // The value range of a node depends on a neighborhood of one leaf node
+      // in each direction (see VdbSampler_computeValueRange), so a change in
+      // [origin, origin + res) affects all nodes with origins in
+      // [origin - (VKL_VDB_RES_LEAF + 1), origin + res].
+      std::vector<uint64_t> dirtyLeaves;
+      const auto collectDependentLeaves = [&](const vec3ui &offset,
+                                              uint32_t level) {
+        const vec3l lower = vec3l(offset) - int64_t(VKL_VDB_RES_LEAF + 1);
+        const vec3l upper = vec3l(offset) + int64_t(vklVdbLevelRes(level));
+        collectLeavesInRange(grid, 0, 0, lower, upper, dirtyLeaves);
+      };
+
+      for (uint64_t i : changedLeaves) {
+        collectDependentLeaves(leafOffsets[i], (*leafLevel)[i]);
+      }
+      for (uint64_t p : removedLeaves) {
+        collectDependentLeaves(state.leafOffsets[p], state.leafLevel[p]);
+      }
+
+      std::sort(dirtyLeaves.begin(), dirtyLeaves.end());
+      dirtyLeaves.erase(std::unique(dirtyLeaves.begin(), dirtyLeaves.end()),
+                        dirtyLeaves.end());
+
+      postLogMessage(this->device.ptr, VKL_LOG_DEBUG)
+          << "VDB: incremental commit, " << changedLeaves.size()
+          << " nodes added or modified, " << removedLeaves.size()
+          << " nodes removed, " << dirtyLeaves.size() << " of " << numLeaves
+          << " value ranges recomputed";
+
+      // Reuse value ranges of all other nodes.
+      leafValueRanges.resize(numLeaves * numAttributes);
+      tasking::parallel_for(numLeaves, [&](uint64_t i) {
+        const uint64_t p = previousIndex[i];
+        if (p != invalidIndex) {
+          std::copy_n(
+              state.leafValueRanges.begin() + p * numAttributes,
+              numAttributes,
+              leafValueRanges.begin() + i * numAttributes);
+        }
+      });
+
+      tasking::parallel_for(dirtyLeaves.size(), [&](size_t j) {
+        const uint64_t i = dirtyLeaves[j];
+        const auto format = static_cast<VKLFormat>((*leafFormat)[i]);
+        for (uint32_t a = 0; a < numAttributes; ++a) {
+          leafValueRanges[i * numAttributes + a] = computeValueRange(
+              this->getSh(), grid, format, (*leafLevel)[i], leafOffsets[i], a);
+        }
+      });
+
+      // Finally, propagate to all affected inner voxels.
+      std::vector<std::pair<uint32_t, vec3ui>> locations;
+      locations.reserve(dirtyLeaves.size() + removedLeaves.size());
+      for (uint64_t i : dirtyLeaves) {
+        locations.emplace_back((*leafLevel)[i], leafOffsets[i]);
+      }
+      for (uint64_t p : removedLeaves) {
+        locations.emplace_back(state.leafLevel[p], state.leafOffsets[p]);
+      }
+
+      updateInnerValueRanges(locations, leafValueRanges, grid);
+
+      // Unlike value ranges, averages only depend on the node itself.
+      changes.unchangedIndex = std::move(previousIndex);
+      changes.locations.clear();
+      for (uint64_t i : changedLeaves) {
+        changes.unchangedIndex[i] = invalidIndex;
+        changes.locations.emplace_back((*leafLevel)[i], leafOffsets[i]);
+      }
+      for (uint64_t p : removedLeaves) {
+        changes.locations.emplace_back(state.leafLevel[p],
+                                       state.leafOffsets[p]);
+      }
+    }
+
     template <int W>
     Observer<W> *VdbVolume<W>::newObserver(const char *type)
     {
@@ -4,13 +4,19 @@
 #pragma once
 
 #include <openvkl/vdb.h>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include "../../common/Allocator.h"
 #include "../../observer/ObserverRegistry.h"
 #include "../Volume.h"
 #include "../common/Data.h"
 #include "VdbGrid.h"
+#include "VdbGridSerialization.h"
 #include "VdbIterator.h"
+#include "VdbLeafPager.h"
 #include "VdbVolume_ispc.h"
 #include "rkcommon/containers/aligned_allocator.h"
 #include "rkcommon/memory/RefCount.h"
@@ -82,6 +88,9 @@ namespace openvkl {
     // VdbVolume //////////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////////////
 
+    template <int W>
+    struct VdbSampler;
+
     template <int W>
     struct VdbVolume : public AddStructShared<Volume<W>, ispc::VdbVolume>
     {
@@ -136,9 +145,24 @@ namespace openvkl {
         return grid;
       }
 
+      /*
+       * The pager for paged node data, or nullptr.
+       */
+      VdbLeafPager *getLeafPager() const
+      {
+        return leafPager.get();
+      }
+
       Observer<W> *newObserver(const char *type) override;
       Sampler<W> *newSampler() override;
 
+      /*
+       * Samplers refer to the grid directly, so all live samplers are
+       * registered here and follow the grid on every commit.
+       */
+      void registerSampler(VdbSampler<W> *sampler);
+      void unregisterSampler(VdbSampler<W> *sampler);
+
       VKLFilter getFilter() const
       {
         return filter;
@@ -154,12 +178,115 @@ namespace openvkl {
         return maxSamplingDepth;
       }
 
+      bool getTraversalCache() const
+      {
+        return traversalCache;
+      }
+
      protected:
       virtual void initIndexSpaceTransforms();
       virtual void initLeafNodeData();
 
      private:
+      /*
+       * Build or update the grid from the current parameters.
+       */
+      void commitGrid();
+
+      /*
+       * Give the grid a new commit generation, and point all registered
+       * samplers to it.
+       */
+      void updateSamplers();
+
       void cleanup();
+      void deallocateGrid(VdbGrid *&g);
+
+      /*
+       * Can the tree of previousGrid be updated in place, rather than
+       * rebuilding it from scratch? This is only possible if
+       * incrementalCommit is set, and the volume configuration (other than
+       * the set of nodes) did not change since the previous commit.
+       */
+      bool canUpdateIncrementally(const VdbGrid *previousGrid,
+                                  bool hasQuantizedAttributes) const;
+
+      // Nodes that changed in an incremental commit, see updateInnerLevels().
+      struct IncrementalChanges
+      {
+        // For each node, the index of the same node in the previous commit
+        // if its data did not change, and max() otherwise.
+        std::vector<uint64_t> unchangedIndex;
+
+        // (leaf level, offset) of all nodes that were added, removed or
+        // modified.
+        std::vector<std::pair<uint32_t, vec3ui>> locations;
+      };
+
+      /*
+       * Move the tree of previousGrid into grid, and update it for nodes that
+       * have been added, removed or modified since the previous commit.
+       */
+      void updateInnerLevels(VdbGrid *previousGrid,
+                             const std::vector<vec3ui> &leafOffsets,
+                             std::vector<uint64_t> &capacity,
+                             std::vector<range1f> &leafValueRanges,
+                             IncrementalChanges &changes);
+
+      void initLeafQuantization(
+          const std::map<size_t, size_t> &nodeToDenseNodeIndex,
+          const std::map<size_t, size_t> &nodeToTileNodeIndex);
+
+      void reorderPackedNodeData(
+          std::map<size_t, size_t> &nodeToDenseNodeIndex,
+          std::map<size_t, size_t> &nodeToTileNodeIndex);
+
+      /*
+       * Copy dense data into bricks, and point the grid to the copies.
+       */
+      void brickDenseData();
+
+      /*
+       * Compress dense data into blocks of 4^3 voxels, and point the grid to
+       * the compressed data.
+       */
+      void compressDenseData();
+
+      /*
+       * Build prefiltered mip levels for dense data.
+       */
+      void buildDenseMipLevels();
+
+      /*
+       * Use the serialized grid in the given file, rather than building the
+       * grid from node parameters.
+       */
+      void mapSerializedGrid(const std::string &filename);
+
+      void computeVolumeValueRanges();
+
+      /*
+       * Compute the average value of all inner voxels, for level of detail
+       * sampling. Must be called after the tree has been built. For
+       * incremental commits, changes are those found by updateInnerLevels(),
+       * and only affected averages are recomputed; otherwise, changes must be
+       * null.
+       */
+      void computeInnerAverages(const std::vector<vec3ui> &leafOffsets,
+                                const IncrementalChanges *changes,
+                                std::vector<float> &leafAverages);
+
+      /*
+       * Create the pager for paged node data. Must be called after the tree
+       * has been built.
+       */
+      void initLeafPager();
+
+      /*
+       * Is the node configuration (other than the page budget and prefetch
+       * list) unchanged since the commit that created leafPager?
+       */
+      bool isPagedNodeConfigurationUnchanged();
 
      protected:
       box3f bounds;
@@ -178,12 +305,49 @@ namespace openvkl {
       Ref<const DataT<Data *>> leafUnstructuredIndices;
       Ref<const DataT<Data *>> leafUnstructuredTimes;
 
+      // populated in initLeafNodeData(), only for sparse (non-dense) volumes
+      // with quantized (VKL_UCHAR, VKL_USHORT) attributes
+      Ref<const DataT<float>> leafQuantizationScale;
+      Ref<const DataT<float>> leafQuantizationOffset;
+
       // optional: re-packed dense and tile node data in single contiguous
       // arrays (per attribute) for improved performance, only for sparse
       // volumes
       Ref<const DataT<Data *>> nodesPackedDense;
       Ref<const DataT<Data *>> nodesPackedTile;
 
+      // optional: node data that is paged in on demand from
+      // nodePageCallback or nodePageFile, within a memory budget, for sparse
+      // volumes only
+      Ref<const DataT<uint32_t>> nodePageAttributeTypes;
+      Ref<const DataT<box1f>> nodeValueRange;
+      std::unique_ptr<VdbLeafPager> leafPager;
+
+      // The parameters leafPager was created for.
+      struct PagingState
+      {
+        Ref<const DataT<uint32_t>> leafLevel;
+        Ref<const DataT<vec3i>> leafOrigin;
+        Ref<const DataT<uint32_t>> leafFormat;
+        Ref<const DataT<uint32_t>> attributeTypes;
+        Ref<const DataT<box1f>> valueRange;
+        Ref<const DataT<uint64_t>> pageOffset;
+        void *callback{nullptr};
+        void *userData{nullptr};
+        std::string file;
+        box3i indexClippingBounds;
+        std::vector<float> indexToObject;
+        std::vector<float> background;
+      };
+
+      PagingState pagingState;
+
+      // optional: copies of the packed node data (per attribute), reordered
+      // along a Z-order curve for spatial locality
+      bool reorderPackedNodes{false};
+      std::vector<AlignedVector16<uint8_t>> reorderedNodesPackedDense;
+      std::vector<AlignedVector16<uint8_t>> reorderedNodesPackedTile;
+
       // populated for dense volumes only on commit
       bool dense{false};
       vec3i denseDimensions;
@@ -194,9 +358,31 @@ namespace openvkl {
       Ref<const Data> denseTemporallyUnstructuredIndices;
       Ref<const DataT<float>> denseTemporallyUnstructuredTimes;
 
+      // optional: dense data is copied into cubic bricks of
+      // (1 << denseBrickLog2) voxels per dimension on commit, which improves
+      // locality of sampling stencils
+      uint32_t denseBrickLog2{0};
+      std::vector<AlignedVector16<uint8_t>> brickedDenseData;
+      AlignedVector16<uint8_t> brickedDenseIndices;
+      AlignedVector16<uint8_t> brickedDenseTimes;
+
+      // optional: dense data is compressed on commit to denseCompressionBits
+      // (4 or 8) bits per voxel, with a quantization range per block of 4^3
+      // voxels
+      uint32_t denseCompressionBits{0};
+      std::vector<AlignedVector16<uint8_t>> compressedDenseData;
+
+      // optional: number of prefiltered mip levels built on commit, for level
+      // of detail sampling
+      uint32_t denseMipLevels{0};
+      std::vector<AlignedVector16<float>> denseMipData;
+
       VdbGrid *grid{nullptr};
       Allocator allocator;
 
+      // Set if grid refers to a memory mapped serialized grid.
+      std::unique_ptr<MappedFile> mappedGridFile;
+
       // Data can either be interpreted as constant cell data, or
       // vertex-centered data. Note that the vertex-centered interpretation is
       // only legal for the dense configuration.
@@ -205,8 +391,48 @@ namespace openvkl {
       VKLFilter filter{VKL_FILTER_TRILINEAR};
       VKLFilter gradientFilter{VKL_FILTER_TRILINEAR};
       uint32_t maxSamplingDepth{VKL_VDB_NUM_LEVELS - 1};
+      bool traversalCache{true};
+
+      // If set, commit() prefilters inner levels for level of detail
+      // sampling.
+      bool prefilterInnerLevels{false};
 
       Ref<const DataT<float>> background;
+
+      // If set, commit() updates the existing tree for nodes that changed
+      // since the previous commit, rather than rebuilding it.
+      bool incrementalCommit{false};
+
+      // The node configuration of the previous commit. Only valid if that
+      // commit could be followed by an incremental commit.
+      struct IncrementalState
+      {
+        bool valid{false};
+        vec3i rootOrigin;
+        vec3ui activeSize;
+        std::vector<uint32_t> attributeTypes;
+        std::vector<float> background;
+        std::vector<uint64_t> capacity;
+
+        // Per inner level.
+        std::vector<uint64_t> numInnerNodes;
+
+        // Per node.
+        Ref<const DataT<Data *>> leafData;
+        std::vector<vec3ui> leafOffsets;
+        std::vector<uint32_t> leafLevel;
+        std::vector<uint32_t> leafFormat;
+
+        // Per node and attribute. leafAverages is empty if inner levels
+        // were not prefiltered.
+        std::vector<range1f> leafValueRanges;
+        std::vector<float> leafAverages;
+      };
+
+      IncrementalState incrementalState;
+
+      std::mutex samplersMutex;
+      std::vector<VdbSampler<W> *> samplers;
     };
 
     // Inlined definitions ////////////////////////////////////////////////////
@@ -133,6 +133,7 @@ typedef struct
   vkl_range1f tRange;
   vkl_range1f valueRange;
   float nominalDeltaT;
+  float majorant;
 } VKLInterval;
 
 typedef struct VKL_ALIGN(16)
@@ -140,6 +141,7 @@ typedef struct VKL_ALIGN(16)
   vkl_vrange1f4 tRange;
   vkl_vrange1f4 valueRange;
   float nominalDeltaT[4];
+  float majorant[4];
 } VKLInterval4;
 
 typedef struct VKL_ALIGN(32)
@@ -147,6 +149,7 @@ typedef struct VKL_ALIGN(32)
   vkl_vrange1f8 tRange;
   vkl_vrange1f8 valueRange;
   float nominalDeltaT[8];
+  float majorant[8];
 } VKLInterval8;
 
 typedef struct VKL_ALIGN(64)
@@ -154,12 +157,20 @@ typedef struct VKL_ALIGN(64)
   vkl_vrange1f16 tRange;
   vkl_vrange1f16 valueRange;
   float nominalDeltaT[16];
+  float majorant[16];
 } VKLInterval16;
 
 // returns true while the iterator is still within the volume
 OPENVKL_INTERFACE
 int vklIterateInterval(VKLIntervalIterator iterator, VKLInterval *interval);
 
+// iterates up to maxCount intervals at once, returning the number of intervals
+// written; fewer than maxCount means the iterator has left the volume
+OPENVKL_INTERFACE
+unsigned int vklIterateIntervals(VKLIntervalIterator iterator,
+                                 VKLInterval *intervals,
+                                 unsigned int maxCount);
+
 OPENVKL_INTERFACE
 void vklIterateInterval4(const int *valid,
                          VKLIntervalIterator4 iterator,
@@ -178,6 +189,24 @@ void vklIterateInterval16(const int *valid,
                           VKLInterval16 *interval,
                           int *result);
 
+/*
+ * Stream interval iteration over N rays. Up to maxIntervals intervals of ray
+ * i are written to intervals[i * maxIntervals], and their count to
+ * numIntervals[i]. Iterators are managed internally, and diverging rays are
+ * compacted into full packets of the native SIMD width. times may be NULL, in
+ * which case all times are zero.
+ */
+OPENVKL_INTERFACE
+void vklIterateIntervalsN(VKLIntervalIteratorContext context,
+                          unsigned int N,
+                          const vkl_vec3f *origins,
+                          const vkl_vec3f *directions,
+                          const vkl_range1f *tRanges,
+                          const float *times,
+                          unsigned int maxIntervals,
+                          VKLInterval *intervals,
+                          unsigned int *numIntervals);
+
 ///////////////////////////////////////////////////////////////////////////////
 // Hit iterators //////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -304,6 +333,12 @@ typedef struct VKL_ALIGN(64)
 OPENVKL_INTERFACE
 int vklIterateHit(VKLHitIterator iterator, VKLHit *hit);
 
+// iterates up to maxCount hits at once, returning the number of hits written
+OPENVKL_INTERFACE
+unsigned int vklIterateHits(VKLHitIterator iterator,
+                            VKLHit *hits,
+                            unsigned int maxCount);
+
 OPENVKL_INTERFACE
 void vklIterateHit4(const int *valid,
                     VKLHitIterator4 iterator,
@@ -322,6 +357,20 @@ void vklIterateHit16(const int *valid,
                      VKLHit16 *hit,
                      int *result);
 
+/*
+ * Stream hit iteration over N rays; see vklIterateIntervalsN().
+ */
+OPENVKL_INTERFACE
+void vklIterateHitsN(VKLHitIteratorContext context,
+                     unsigned int N,
+                     const vkl_vec3f *origins,
+                     const vkl_vec3f *directions,
+                     const vkl_range1f *tRanges,
+                     const float *times,
+                     unsigned int maxHits,
+                     VKLHit *hits,
+                     unsigned int *numHits);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
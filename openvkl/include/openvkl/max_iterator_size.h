@@ -16,9 +16,9 @@
 #else
   #define VKL_MAX_INTERVAL_ITERATOR_SIZE VKL_MAX_INTERVAL_ITERATOR_SIZE_16
 #endif
-#define VKL_MAX_HIT_ITERATOR_SIZE_4 1279
-#define VKL_MAX_HIT_ITERATOR_SIZE_8 2463
-#define VKL_MAX_HIT_ITERATOR_SIZE_16 4927
+#define VKL_MAX_HIT_ITERATOR_SIZE_4 1295
+#define VKL_MAX_HIT_ITERATOR_SIZE_8 2495
+#define VKL_MAX_HIT_ITERATOR_SIZE_16 4991
 
 #if defined(TARGET_WIDTH) && (TARGET_WIDTH == 4)
   #define VKL_MAX_HIT_ITERATOR_SIZE VKL_MAX_HIT_ITERATOR_SIZE_4
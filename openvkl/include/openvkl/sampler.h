@@ -154,6 +154,58 @@ void vklComputeGradientN(VKLSampler sampler,
                          unsigned int attributeIndex VKL_DEFAULT_VAL(= 0),
                          const float *times VKL_DEFAULT_VAL(= nullptr));
 
+// Compute the sample value and the gradient at the same position(s). Volumes
+// may compute both from the same filter stencil, which is cheaper than
+// calling vklComputeSample*() and vklComputeGradient*() separately.
+
+OPENVKL_INTERFACE
+float vklComputeSampleAndGradient(
+    VKLSampler sampler,
+    const vkl_vec3f *objectCoordinates,
+    vkl_vec3f *gradient,
+    unsigned int attributeIndex VKL_DEFAULT_VAL(= 0),
+    float time VKL_DEFAULT_VAL(= 0));
+
+OPENVKL_INTERFACE
+void vklComputeSampleAndGradient4(
+    const int *valid,
+    VKLSampler sampler,
+    const vkl_vvec3f4 *objectCoordinates,
+    float *samples,
+    vkl_vvec3f4 *gradients,
+    unsigned int attributeIndex VKL_DEFAULT_VAL(= 0),
+    const float *times VKL_DEFAULT_VAL(= nullptr));
+
+OPENVKL_INTERFACE
+void vklComputeSampleAndGradient8(
+    const int *valid,
+    VKLSampler sampler,
+    const vkl_vvec3f8 *objectCoordinates,
+    float *samples,
+    vkl_vvec3f8 *gradients,
+    unsigned int attributeIndex VKL_DEFAULT_VAL(= 0),
+    const float *times VKL_DEFAULT_VAL(= nullptr));
+
+OPENVKL_INTERFACE
+void vklComputeSampleAndGradient16(
+    const int *valid,
+    VKLSampler sampler,
+    const vkl_vvec3f16 *objectCoordinates,
+    float *samples,
+    vkl_vvec3f16 *gradients,
+    unsigned int attributeIndex VKL_DEFAULT_VAL(= 0),
+    const float *times VKL_DEFAULT_VAL(= nullptr));
+
+OPENVKL_INTERFACE
+void vklComputeSampleAndGradientN(
+    VKLSampler sampler,
+    unsigned int N,
+    const vkl_vec3f *objectCoordinates,
+    float *samples,
+    vkl_vec3f *gradients,
+    unsigned int attributeIndex VKL_DEFAULT_VAL(= 0),
+    const float *times VKL_DEFAULT_VAL(= nullptr));
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
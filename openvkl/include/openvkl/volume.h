@@ -47,6 +47,14 @@ typedef enum
   VKL_AMR_OCTANT
 } VKLAMRMethod;
 
+// Callback providing node data for vdb volumes with paged node data. Must
+// write the compact data of the given node and attribute to buffer, and may
+// be called concurrently from multiple threads.
+typedef void (*VKLVdbNodePageCallback)(void *userData,
+                                       uint64_t nodeIndex,
+                                       unsigned int attributeIndex,
+                                       void *buffer);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <random>
 #include "../common/simd.h"
 #include "openvkl_testing.h"
@@ -176,6 +177,98 @@ namespace coordinate_generator {
     Dist distZ;
   };
 
+  /*
+   * The Coherent coordinate generator marches along rays through the volume
+   * bounding box with a small step, similar to a ray marching renderer.
+   * Rays restart at a random position and direction when they leave the
+   * bounding box.
+   * Note: This is currently non-deterministic!
+   */
+  struct Coherent
+  {
+    using Dist = rkcommon::utility::pcg32_biased_float_distribution;
+
+    inline static constexpr const char *name()
+    {
+      return "Coherent";
+    }
+
+    explicit inline Coherent(vkl_box3f const &bbox)
+        : bbox(bbox),
+          rd(),
+          distX(rd(), 0, bbox.lower.x, bbox.upper.x),
+          distY(rd(), 0, bbox.lower.y, bbox.upper.y),
+          distZ(rd(), 0, bbox.lower.z, bbox.upper.z),
+          distDir(rd(), 0, -1.f, 1.f)
+    {
+      // Roughly 512 steps across the smallest extent.
+      const float minExtent = std::min({bbox.upper.x - bbox.lower.x,
+                                        bbox.upper.y - bbox.lower.y,
+                                        bbox.upper.z - bbox.lower.z});
+      stepSize              = minExtent / 512.f;
+      restart();
+    }
+
+    template <unsigned int N>
+    inline void getNextN(vkl_vec3f *pos)
+    {
+      for (unsigned int i = 0; i < N; ++i) {
+        pos[i] = next();
+      }
+    }
+
+    template <int W>
+    inline void getNextV(vvec3fn<W> *pos)
+    {
+      for (int i = 0; i < W; ++i) {
+        const vkl_vec3f p = next();
+        pos->x[i]         = p.x;
+        pos->y[i]         = p.y;
+        pos->z[i]         = p.z;
+      }
+    }
+
+   private:
+    inline void restart()
+    {
+      current = vkl_vec3f{distX(), distY(), distZ()};
+
+      float len = 0.f;
+      while (len < 1e-3f) {
+        step = vkl_vec3f{distDir(), distDir(), distDir()};
+        len  = std::sqrt(step.x * step.x + step.y * step.y + step.z * step.z);
+      }
+      step.x *= stepSize / len;
+      step.y *= stepSize / len;
+      step.z *= stepSize / len;
+    }
+
+    inline vkl_vec3f next()
+    {
+      current.x += step.x;
+      current.y += step.y;
+      current.z += step.z;
+
+      if (current.x < bbox.lower.x || current.x > bbox.upper.x ||
+          current.y < bbox.lower.y || current.y > bbox.upper.y ||
+          current.z < bbox.lower.z || current.z > bbox.upper.z) {
+        restart();
+      }
+
+      return current;
+    }
+
+    vkl_box3f bbox;
+    std::random_device rd;  // Generate seeds randomly.
+    Dist distX;
+    Dist distY;
+    Dist distZ;
+    Dist distDir;
+    float stepSize{0.f};
+    vkl_vec3f current;
+    vkl_vec3f step;
+  };
+
 }  // namespace coordinate_generator
 
 /*
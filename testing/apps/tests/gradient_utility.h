@@ -210,3 +210,148 @@ inline void test_stream_gradients(std::shared_ptr<TestingVolume> v,
   }
   vklRelease(vklSampler);
 }
+
+inline bool sameOrBothNaN(float a, float b, float tolerance)
+{
+  return (a == Approx(b).margin(tolerance)) || (std::isnan(a) && std::isnan(b));
+}
+
+// vklComputeSampleAndGradient*() must agree with separate vklComputeSample()
+// and vklComputeGradient() calls, for all APIs
+inline void test_sample_and_gradient(std::shared_ptr<TestingVolume> v,
+                                     VKLFilter filter,
+                                     const unsigned int attributeIndex = 0)
+{
+  VKLVolume vklVolume   = v->getVKLVolume(getOpenVKLDevice());
+  VKLSampler vklSampler = vklNewSampler(vklVolume);
+  vklSetInt(vklSampler, "filter", filter);
+  vklSetInt(vklSampler, "gradientFilter", filter);
+  vklCommit(vklSampler);
+
+  vkl_box3f bbox = vklGetBoundingBox(vklVolume);
+
+  std::mt19937 eng(42);
+
+  std::uniform_real_distribution<float> distX(bbox.lower.x, bbox.upper.x);
+  std::uniform_real_distribution<float> distY(bbox.lower.y, bbox.upper.y);
+  std::uniform_real_distribution<float> distZ(bbox.lower.z, bbox.upper.z);
+
+  // the fused path may evaluate in a different order
+  static constexpr float tolerance = 1e-4f;
+
+  const int N = 1000;
+
+  std::vector<vec3f> objectCoordinates(N);
+  for (auto &oc : objectCoordinates) {
+    oc = vec3f(distX(eng), distY(eng), distZ(eng));
+  }
+
+  std::vector<float> samples(N);
+  std::vector<vec3f> gradients(N);
+
+  for (int i = 0; i < N; i++) {
+    samples[i] = vklComputeSample(vklSampler,
+                                  (const vkl_vec3f *)&objectCoordinates[i],
+                                  attributeIndex);
+    const vkl_vec3f gradient =
+        vklComputeGradient(vklSampler,
+                           (const vkl_vec3f *)&objectCoordinates[i],
+                           attributeIndex);
+    gradients[i] = vec3f(gradient.x, gradient.y, gradient.z);
+  }
+
+  const auto check = [&](int i, float sample, const vec3f &gradient) {
+    INFO("objectCoordinates = " << objectCoordinates[i].x << " "
+                                << objectCoordinates[i].y << " "
+                                << objectCoordinates[i].z);
+    REQUIRE(sameOrBothNaN(sample, samples[i], tolerance));
+    REQUIRE(sameOrBothNaN(gradient.x, gradients[i].x, tolerance));
+    REQUIRE(sameOrBothNaN(gradient.y, gradients[i].y, tolerance));
+    REQUIRE(sameOrBothNaN(gradient.z, gradients[i].z, tolerance));
+  };
+
+  // scalar
+  for (int i = 0; i < N; i++) {
+    vkl_vec3f gradient;
+    float sample =
+        vklComputeSampleAndGradient(vklSampler,
+                                    (const vkl_vec3f *)&objectCoordinates[i],
+                                    &gradient,
+                                    attributeIndex);
+    check(i, sample, vec3f(gradient.x, gradient.y, gradient.z));
+  }
+
+  // vector, all lanes active
+  std::vector<int> valid(16, 1);
+
+  for (int i = 0; i + 16 <= N; i += 16) {
+    std::vector<vec3f> block(objectCoordinates.begin() + i,
+                             objectCoordinates.begin() + i + 16);
+
+    std::vector<vec3f> block4(block.begin(), block.begin() + 4);
+    AlignedVector<float> soa4 = AOStoSOA_vec3f(block4, 4);
+    float samples_4[4];
+    vkl_vvec3f4 gradients_4;
+    vklComputeSampleAndGradient4(valid.data(),
+                                 vklSampler,
+                                 (const vkl_vvec3f4 *)soa4.data(),
+                                 samples_4,
+                                 &gradients_4,
+                                 attributeIndex,
+                                 nullptr);
+    for (int j = 0; j < 4; j++) {
+      check(i + j,
+            samples_4[j],
+            vec3f(gradients_4.x[j], gradients_4.y[j], gradients_4.z[j]));
+    }
+
+    std::vector<vec3f> block8(block.begin(), block.begin() + 8);
+    AlignedVector<float> soa8 = AOStoSOA_vec3f(block8, 8);
+    float samples_8[8];
+    vkl_vvec3f8 gradients_8;
+    vklComputeSampleAndGradient8(valid.data(),
+                                 vklSampler,
+                                 (const vkl_vvec3f8 *)soa8.data(),
+                                 samples_8,
+                                 &gradients_8,
+                                 attributeIndex,
+                                 nullptr);
+    for (int j = 0; j < 8; j++) {
+      check(i + j,
+            samples_8[j],
+            vec3f(gradients_8.x[j], gradients_8.y[j], gradients_8.z[j]));
+    }
+
+    AlignedVector<float> soa16 = AOStoSOA_vec3f(block, 16);
+    float samples_16[16];
+    vkl_vvec3f16 gradients_16;
+    vklComputeSampleAndGradient16(valid.data(),
+                                  vklSampler,
+                                  (const vkl_vvec3f16 *)soa16.data(),
+                                  samples_16,
+                                  &gradients_16,
+                                  attributeIndex,
+                                  nullptr);
+    for (int j = 0; j < 16; j++) {
+      check(i + j,
+            samples_16[j],
+            vec3f(gradients_16.x[j], gradients_16.y[j], gradients_16.z[j]));
+    }
+  }
+
+  // stream
+  std::vector<float> streamSamples(N);
+  std::vector<vec3f> streamGradients(N);
+  vklComputeSampleAndGradientN(vklSampler,
+                               N,
+                               (const vkl_vec3f *)objectCoordinates.data(),
+                               streamSamples.data(),
+                               (vkl_vec3f *)streamGradients.data(),
+                               attributeIndex,
+                               nullptr);
+  for (int i = 0; i < N; i++) {
+    check(i, streamSamples[i], streamGradients[i]);
+  }
+
+  vklRelease(vklSampler);
+}
@@ -0,0 +1,128 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include "../../external/catch.hpp"
+#include "openvkl_testing.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+static std::vector<VKLHit> iterateHits(VKLSampler sampler,
+                                       const std::vector<float> &values,
+                                       bool analyticHits,
+                                       const vkl_vec3f &origin,
+                                       const vkl_vec3f &direction)
+{
+  VKLData valuesData = vklNewData(
+      getOpenVKLDevice(), values.size(), VKL_FLOAT, values.data());
+
+  VKLHitIteratorContext context = vklNewHitIteratorContext(sampler);
+  vklSetData(context, "values", valuesData);
+  vklSetBool(context, "analyticHits", analyticHits);
+  vklCommit(context);
+  vklRelease(valuesData);
+
+  const vkl_range1f tRange{0.f, inf};
+
+  std::vector<char> buffer(vklGetHitIteratorSize(context));
+
+  VKLHitIterator iterator = vklInitHitIterator(
+      context, &origin, &direction, &tRange, 0.f, buffer.data());
+
+  std::vector<VKLHit> hits;
+  VKLHit hit;
+  while (vklIterateHit(iterator, &hit)) {
+    hits.push_back(hit);
+  }
+
+  vklRelease(context);
+
+  return hits;
+}
+
+static void analytic_hits_are_exact(VKLVolume volume)
+{
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  const vkl_range1f valueRange = vklGetValueRange(volume);
+  const float valueWidth       = valueRange.upper - valueRange.lower;
+
+  std::vector<float> values;
+  for (int i = 1; i < 8; i++) {
+    values.push_back(valueRange.lower + 0.125f * i * valueWidth);
+  }
+
+  const vec3f d = normalize(vec3f(1.f, 0.1f, -0.05f));
+
+  const vkl_vec3f origin{-1.f, 0.37f, 0.61f};
+  const vkl_vec3f direction{d.x, d.y, d.z};
+
+  const std::vector<VKLHit> analytic =
+      iterateHits(sampler, values, true, origin, direction);
+  const std::vector<VKLHit> bisection =
+      iterateHits(sampler, values, false, origin, direction);
+
+  REQUIRE(!analytic.empty());
+
+  for (size_t i = 0; i < analytic.size(); i++) {
+    INFO("hit " << i << " t = " << analytic[i].t);
+
+    if (i > 0) {
+      REQUIRE(analytic[i].t > analytic[i - 1].t);
+    }
+
+    // the interpolated value at the hit is the isovalue
+    const vec3f p = vec3f(origin.x, origin.y, origin.z) + analytic[i].t * d;
+    REQUIRE(vklComputeSample(sampler, (const vkl_vec3f *)&p, 0, 0.f) ==
+            Approx(analytic[i].sample).margin(1e-4f * valueWidth));
+  }
+
+  // every hit found by sampling is also found analytically
+  for (const VKLHit &expected : bisection) {
+    INFO("bisection hit t = " << expected.t);
+
+    bool found = false;
+    for (const VKLHit &hit : analytic) {
+      found |= hit.sample == expected.sample &&
+               std::abs(hit.t - expected.t) <= expected.epsilon;
+    }
+
+    REQUIRE(found);
+  }
+
+  vklRelease(sampler);
+}
+
+TEST_CASE("Analytic hit iterator", "[hit_iterators]")
+{
+  initializeOpenVKL();
+
+  // unit cube physical grid [(0,0,0), (1,1,1)]
+  const vec3i dimensions(64);
+  const vec3f gridOrigin(0.f);
+  const vec3f gridSpacing(1.f / (64.f - 1.f));
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
+  SECTION("structured volumes")
+  {
+    auto v = rkcommon::make_unique<WaveletStructuredRegularVolume<float>>(
+        dimensions, gridOrigin, gridSpacing);
+
+    analytic_hits_are_exact(v->getVKLVolume(getOpenVKLDevice()));
+  }
+#endif
+
+#if OPENVKL_DEVICE_CPU_VDB
+  SECTION("VDB volumes")
+  {
+    auto v = rkcommon::make_unique<WaveletVdbVolumeFloat>(
+        getOpenVKLDevice(), dimensions, gridOrigin, gridSpacing);
+
+    analytic_hits_are_exact(v->getVKLVolume(getOpenVKLDevice()));
+  }
+#endif
+
+  shutdownOpenVKL();
+}
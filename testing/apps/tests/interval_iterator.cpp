@@ -272,6 +272,165 @@ void scalar_interval_nominalDeltaT(VKLVolume volume,
   vklRelease(sampler);
 }
 
+static std::vector<VKLInterval> iterateIntervals(
+    VKLIntervalIteratorContext intervalContext,
+    const vec3f &origin,
+    const vec3f &direction,
+    float time)
+{
+  vkl_range1f tRange{0.f, inf};
+
+  std::vector<char> buffer(vklGetIntervalIteratorSize(intervalContext));
+  VKLIntervalIterator iterator =
+      vklInitIntervalIterator(intervalContext,
+                              (const vkl_vec3f *)&origin,
+                              (const vkl_vec3f *)&direction,
+                              &tRange,
+                              time,
+                              buffer.data());
+
+  std::vector<VKLInterval> intervals;
+
+  VKLInterval interval;
+
+  while (vklIterateInterval(iterator, &interval)) {
+    intervals.push_back(interval);
+  }
+
+  return intervals;
+}
+
+// culling must only drop intervals whose value range does not overlap the
+// requested value range: the culled intervals must be exactly the overlapping
+// subset of the intervals returned without value ranges. additionally, every
+// sample along the ray with a value inside the value range must be covered by
+// a returned interval, no matter how many cells are skipped
+void scalar_interval_value_range_culling(VKLVolume volume,
+                                         const vec3f &origin,
+                                         const vec3f &direction,
+                                         const vkl_range1f &valueRange)
+{
+  const float time = 0.f;
+
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  VKLData valueRangesData =
+      vklNewData(getOpenVKLDevice(), 1, VKL_BOX1F, &valueRange);
+
+  VKLIntervalIteratorContext intervalContext =
+      vklNewIntervalIteratorContext(sampler);
+
+  vklSetData(intervalContext, "valueRanges", valueRangesData);
+  vklRelease(valueRangesData);
+
+  vklCommit(intervalContext);
+
+  // reference without value ranges, i.e. with culling disabled
+  VKLIntervalIteratorContext referenceContext =
+      vklNewIntervalIteratorContext(sampler);
+  vklCommit(referenceContext);
+
+  const std::vector<VKLInterval> intervals =
+      iterateIntervals(intervalContext, origin, direction, time);
+
+  std::vector<VKLInterval> expectedIntervals;
+  for (const VKLInterval &r :
+       iterateIntervals(referenceContext, origin, direction, time)) {
+    if (r.valueRange.lower <= valueRange.upper &&
+        r.valueRange.upper >= valueRange.lower) {
+      expectedIntervals.push_back(r);
+    }
+  }
+
+  REQUIRE(intervals.size() == expectedIntervals.size());
+
+  for (size_t i = 0; i < intervals.size(); i++) {
+    INFO("interval " << i);
+
+    const VKLInterval &interval = intervals[i];
+    const VKLInterval &expected = expectedIntervals[i];
+
+    REQUIRE(interval.tRange.lower ==
+            Approx(expected.tRange.lower).margin(1e-4f));
+    REQUIRE(interval.tRange.upper ==
+            Approx(expected.tRange.upper).margin(1e-4f));
+    REQUIRE(interval.valueRange.lower == expected.valueRange.lower);
+    REQUIRE(interval.valueRange.upper == expected.valueRange.upper);
+    REQUIRE(interval.nominalDeltaT == Approx(expected.nominalDeltaT));
+  }
+
+  const vkl_box3f vklBoundingBox = vklGetBoundingBox(volume);
+  const box3f boundingBox        = (const box3f &)vklBoundingBox;
+
+  const range1f bboxTRange = intersectRayBox(origin, direction, boundingBox);
+
+  const int numSteps   = 4096;
+  const float tEpsilon = 1e-4f * (bboxTRange.upper - bboxTRange.lower);
+
+  for (int i = 0; i <= numSteps; i++) {
+    const float t = bboxTRange.lower +
+                    (bboxTRange.upper - bboxTRange.lower) * i / numSteps;
+    const vec3f c = origin + t * direction;
+
+    const float sample =
+        vklComputeSample(sampler, (const vkl_vec3f *)&c, 0, time);
+
+    if (!(sample >= valueRange.lower && sample <= valueRange.upper)) {
+      continue;
+    }
+
+    INFO("t = " << t << ", sample = " << sample);
+
+    bool covered = false;
+    for (const VKLInterval &interval : intervals) {
+      const vkl_range1f &r = interval.tRange;
+      if (t >= r.lower - tEpsilon && t <= r.upper + tEpsilon) {
+        covered = true;
+        break;
+      }
+    }
+
+    REQUIRE(covered);
+  }
+
+  vklRelease(referenceContext);
+  vklRelease(intervalContext);
+  vklRelease(sampler);
+}
+
+// rays through the given volume from several directions, passing close to
+// the center of a volume of the given object space extent
+void scalar_interval_value_range_culling_rays(VKLVolume vklVolume,
+                                              const vec3f &center,
+                                              float extent)
+{
+  // a narrow value range, so that most of the volume is culled
+  const vkl_range1f volumeValueRange = vklGetValueRange(vklVolume);
+  const float width = volumeValueRange.upper - volumeValueRange.lower;
+  const vkl_range1f valueRange{volumeValueRange.upper - 0.05f * width,
+                               volumeValueRange.upper};
+
+  const float scale = extent / 300.f;
+
+  for (const vec3f &direction : {vec3f(1.f, 0.f, 0.f),
+                                 vec3f(0.f, -1.f, 0.f),
+                                 vec3f(1.f, 1.f, 1.f),
+                                 vec3f(-0.3f, 0.7f, -0.2f),
+                                 vec3f(0.9f, -0.1f, 0.4f)}) {
+    const vec3f d = normalize(direction);
+    for (const vec3f &offset :
+         {vec3f(0.f), vec3f(17.f, -41.f, 5.f), vec3f(-60.f, 33.f, 71.f)}) {
+      const vec3f origin = center + scale * offset - 4.f * extent * d;
+
+      INFO("origin = " << origin.x << " " << origin.y << " " << origin.z);
+      INFO("direction = " << d.x << " " << d.y << " " << d.z);
+
+      scalar_interval_value_range_culling(vklVolume, origin, d, valueRange);
+    }
+  }
+}
+
 template <typename PROCEDURAL_VOLUME_TYPE>
 void scalar_single_attribute_interval_iterator_tests(
     PROCEDURAL_VOLUME_TYPE &proceduralVolume)
@@ -435,6 +594,54 @@ TEST_CASE("Interval iterator", "[interval_iterators]")
 #endif
   }
 
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR_LEGACY || \
+    OPENVKL_DEVICE_CPU_STRUCTURED_SPHERICAL
+  // value range culling of super cells is implemented by the grid
+  // accelerator, which backs the legacy structured regular volume and the
+  // structured spherical volume
+  SECTION("structured volumes: value range culling")
+  {
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR_LEGACY
+    SECTION("structuredRegular")
+    {
+      // large enough for several levels of culled super cells
+      const vec3i dimensions(300);
+      const vec3f gridOrigin(0.f);
+      const vec3f gridSpacing(1.f);
+
+      auto v = rkcommon::make_unique<WaveletStructuredRegularVolume<float>>(
+          dimensions, gridOrigin, gridSpacing);
+
+      VKLVolume vklVolume = v->getVKLVolume(getOpenVKLDevice());
+
+      scalar_interval_value_range_culling_rays(vklVolume, vec3f(150.f), 300.f);
+    }
+#endif
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_SPHERICAL
+    SECTION("structuredSpherical")
+    {
+      const vec3i dimensions(300);
+      const float boundingBoxSize = 300.f;
+
+      vec3f gridOrigin;
+      vec3f gridSpacing;
+      WaveletStructuredSphericalVolume<float>::generateGridParameters(
+          dimensions, boundingBoxSize, gridOrigin, gridSpacing);
+
+      auto v = rkcommon::make_unique<WaveletStructuredSphericalVolume<float>>(
+          dimensions, gridOrigin, gridSpacing);
+
+      VKLVolume vklVolume = v->getVKLVolume(getOpenVKLDevice());
+
+      // the spherical volume is centered at the origin
+      scalar_interval_value_range_culling_rays(
+          vklVolume, vec3f(0.f), boundingBoxSize);
+    }
+#endif
+  }
+#endif
+
 #if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
   SECTION("structured volumes: interval nominalDeltaT")
   {
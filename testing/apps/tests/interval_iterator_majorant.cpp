@@ -0,0 +1,143 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <algorithm>
+#include <functional>
+#include "../../external/catch.hpp"
+#include "openvkl_testing.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+// calls f for every interval along a few rays through the volume center
+static void forEachInterval(VKLIntervalIteratorContext context,
+                            const vec3f &center,
+                            const std::function<void(const VKLInterval &)> &f)
+{
+  const vkl_range1f tRange{0.f, inf};
+
+  for (const vec3f &direction : {vec3f(1.f, 0.f, 0.f),
+                                 vec3f(1.f, 1.f, 1.f),
+                                 vec3f(-0.3f, 0.7f, -0.2f)}) {
+    const vec3f d      = normalize(direction);
+    const vec3f origin = center - 1000.f * d;
+
+    std::vector<char> buffer(vklGetIntervalIteratorSize(context));
+    VKLIntervalIterator iterator =
+        vklInitIntervalIterator(context,
+                                (const vkl_vec3f *)&origin,
+                                (const vkl_vec3f *)&d,
+                                &tRange,
+                                0.f,
+                                buffer.data());
+
+    VKLInterval interval;
+    while (vklIterateInterval(iterator, &interval)) {
+      INFO("interval valueRange = " << interval.valueRange.lower << ", "
+                                    << interval.valueRange.upper);
+      f(interval);
+    }
+  }
+}
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
+TEST_CASE("Interval iterator majorants", "[interval_iterators]")
+{
+  initializeOpenVKL();
+
+  const vec3i dimensions(128);
+
+  auto v = rkcommon::make_unique<WaveletStructuredRegularVolume<float>>(
+      dimensions, vec3f(0.f), vec3f(1.f));
+
+  VKLVolume volume = v->getVKLVolume(getOpenVKLDevice());
+
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  VKLIntervalIteratorContext context = vklNewIntervalIteratorContext(sampler);
+
+  const vec3f center(64.f);
+
+  const vkl_range1f valueRange = vklGetValueRange(volume);
+
+  SECTION("majorants default to the interval value range upper bound")
+  {
+    vklCommit(context);
+
+    forEachInterval(context, center, [&](const VKLInterval &interval) {
+      REQUIRE(interval.majorant == interval.valueRange.upper);
+    });
+  }
+
+  SECTION("majorants follow a linear transfer function")
+  {
+    const std::vector<float> ramp{0.f, 2.f};
+
+    VKLData rampData = vklNewData(
+        getOpenVKLDevice(), ramp.size(), VKL_FLOAT, ramp.data());
+    vklSetData(context, "majorantTransferFunction", rampData);
+    vklRelease(rampData);
+
+    vklSetParam(context, "majorantValueRange", VKL_BOX1F, &valueRange);
+    vklCommit(context);
+
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == VKL_NO_ERROR);
+
+    const float width = valueRange.upper - valueRange.lower;
+
+    forEachInterval(context, center, [&](const VKLInterval &interval) {
+      const float upper =
+          std::min(interval.valueRange.upper, valueRange.upper);
+      REQUIRE(interval.majorant ==
+              Approx(2.f * (upper - valueRange.lower) / width).margin(1e-5f));
+    });
+  }
+
+  SECTION("majorants bound a peaked transfer function")
+  {
+    // peak at the center of the value range
+    const std::vector<float> peak{0.f, 0.f, 1.f, 0.f, 0.f};
+
+    VKLData peakData = vklNewData(
+        getOpenVKLDevice(), peak.size(), VKL_FLOAT, peak.data());
+    vklSetData(context, "majorantTransferFunction", peakData);
+    vklRelease(peakData);
+
+    vklCommit(context);
+
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == VKL_NO_ERROR);
+
+    const float centerValue = 0.5f * (valueRange.lower + valueRange.upper);
+
+    forEachInterval(context, center, [&](const VKLInterval &interval) {
+      REQUIRE(interval.majorant >= 0.f);
+      REQUIRE(interval.majorant <= 1.f);
+
+      if (interval.valueRange.lower <= centerValue &&
+          interval.valueRange.upper >= centerValue) {
+        REQUIRE(interval.majorant == 1.f);
+      }
+    });
+  }
+
+  SECTION("negative transfer function values are an error")
+  {
+    const std::vector<float> negative{0.f, -1.f};
+
+    VKLData negativeData = vklNewData(
+        getOpenVKLDevice(), negative.size(), VKL_FLOAT, negative.data());
+    vklSetData(context, "majorantTransferFunction", negativeData);
+    vklRelease(negativeData);
+
+    vklCommit(context);
+
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) != VKL_NO_ERROR);
+  }
+
+  vklRelease(context);
+  vklRelease(sampler);
+
+  shutdownOpenVKL();
+}
+#endif
@@ -0,0 +1,191 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../external/catch.hpp"
+#include "openvkl_testing.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+// batches of this size do not evenly divide typical interval and hit counts
+static const unsigned int batchSize = 3;
+
+static void batched_intervals_match_single_intervals(VKLVolume volume)
+{
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  VKLIntervalIteratorContext context = vklNewIntervalIteratorContext(sampler);
+  vklSetFloat(context, "intervalResolutionHint", 1.f);
+  vklCommit(context);
+
+  const vkl_vec3f origin{-1.f, 0.37f, 0.61f};
+  const vkl_vec3f direction{1.f, 0.1f, -0.05f};
+  const vkl_range1f tRange{0.f, inf};
+
+  std::vector<char> buffer(vklGetIntervalIteratorSize(context));
+
+  VKLIntervalIterator iterator = vklInitIntervalIterator(
+      context, &origin, &direction, &tRange, 0.f, buffer.data());
+
+  std::vector<VKLInterval> expected;
+  VKLInterval interval;
+  while (vklIterateInterval(iterator, &interval)) {
+    expected.push_back(interval);
+  }
+
+  REQUIRE(expected.size() > batchSize);
+
+  iterator = vklInitIntervalIterator(
+      context, &origin, &direction, &tRange, 0.f, buffer.data());
+
+  std::vector<VKLInterval> batched;
+  VKLInterval batch[batchSize];
+  unsigned int count;
+  do {
+    count = vklIterateIntervals(iterator, batch, batchSize);
+    batched.insert(batched.end(), batch, batch + count);
+  } while (count == batchSize);
+
+  REQUIRE(batched.size() == expected.size());
+
+  for (size_t i = 0; i < expected.size(); i++) {
+    INFO("interval " << i);
+    REQUIRE(batched[i].tRange.lower == expected[i].tRange.lower);
+    REQUIRE(batched[i].tRange.upper == expected[i].tRange.upper);
+    REQUIRE(batched[i].valueRange.lower == expected[i].valueRange.lower);
+    REQUIRE(batched[i].valueRange.upper == expected[i].valueRange.upper);
+    REQUIRE(batched[i].nominalDeltaT == expected[i].nominalDeltaT);
+    REQUIRE(batched[i].majorant == expected[i].majorant);
+  }
+
+  vklRelease(context);
+  vklRelease(sampler);
+}
+
+static void batched_hits_match_single_hits(VKLVolume volume)
+{
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  const vkl_range1f valueRange = vklGetValueRange(volume);
+
+  std::vector<float> values;
+  for (int i = 1; i < 8; i++) {
+    values.push_back(valueRange.lower +
+                     0.125f * i * (valueRange.upper - valueRange.lower));
+  }
+
+  VKLData valuesData = vklNewData(
+      getOpenVKLDevice(), values.size(), VKL_FLOAT, values.data());
+
+  VKLHitIteratorContext context = vklNewHitIteratorContext(sampler);
+  vklSetData(context, "values", valuesData);
+  vklCommit(context);
+  vklRelease(valuesData);
+
+  const vkl_vec3f origin{-1.f, 0.37f, 0.61f};
+  const vkl_vec3f direction{1.f, 0.1f, -0.05f};
+  const vkl_range1f tRange{0.f, inf};
+
+  std::vector<char> buffer(vklGetHitIteratorSize(context));
+
+  VKLHitIterator iterator = vklInitHitIterator(
+      context, &origin, &direction, &tRange, 0.f, buffer.data());
+
+  std::vector<VKLHit> expected;
+  VKLHit hit;
+  while (vklIterateHit(iterator, &hit)) {
+    expected.push_back(hit);
+  }
+
+  iterator = vklInitHitIterator(
+      context, &origin, &direction, &tRange, 0.f, buffer.data());
+
+  std::vector<VKLHit> batched;
+  VKLHit batch[batchSize];
+  unsigned int count;
+  do {
+    count = vklIterateHits(iterator, batch, batchSize);
+    batched.insert(batched.end(), batch, batch + count);
+  } while (count == batchSize);
+
+  REQUIRE(batched.size() == expected.size());
+
+  for (size_t i = 0; i < expected.size(); i++) {
+    INFO("hit " << i);
+    REQUIRE(batched[i].t == expected[i].t);
+    REQUIRE(batched[i].sample == expected[i].sample);
+    REQUIRE(batched[i].epsilon == expected[i].epsilon);
+  }
+
+  vklRelease(context);
+  vklRelease(sampler);
+}
+
+TEST_CASE("Batched iteration", "[interval_iterators]")
+{
+  initializeOpenVKL();
+
+  // unit cube physical grid [(0,0,0), (1,1,1)]
+  const vec3i dimensions(64);
+  const vec3f gridOrigin(0.f);
+  const vec3f gridSpacing(1.f / (64.f - 1.f));
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR || \
+    OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR_LEGACY
+  SECTION("structured volumes")
+  {
+    auto v = rkcommon::make_unique<WaveletStructuredRegularVolume<float>>(
+        dimensions, gridOrigin, gridSpacing);
+
+    batched_intervals_match_single_intervals(
+        v->getVKLVolume(getOpenVKLDevice()));
+    batched_hits_match_single_hits(v->getVKLVolume(getOpenVKLDevice()));
+  }
+#endif
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_SPHERICAL
+  SECTION("structured spherical volumes")
+  {
+    // unit sphere centered at the origin
+    vec3f sphericalGridOrigin;
+    vec3f sphericalGridSpacing;
+    WaveletStructuredSphericalVolume<float>::generateGridParameters(
+        dimensions, 2.f, sphericalGridOrigin, sphericalGridSpacing);
+
+    auto v = rkcommon::make_unique<WaveletStructuredSphericalVolume<float>>(
+        dimensions, sphericalGridOrigin, sphericalGridSpacing);
+
+    batched_intervals_match_single_intervals(
+        v->getVKLVolume(getOpenVKLDevice()));
+    batched_hits_match_single_hits(v->getVKLVolume(getOpenVKLDevice()));
+  }
+#endif
+
+#if OPENVKL_DEVICE_CPU_UNSTRUCTURED
+  SECTION("unstructured volumes")
+  {
+    auto v = rkcommon::make_unique<WaveletUnstructuredProceduralVolume>(
+        dimensions, gridOrigin, gridSpacing, VKL_HEXAHEDRON, false);
+
+    batched_intervals_match_single_intervals(
+        v->getVKLVolume(getOpenVKLDevice()));
+    batched_hits_match_single_hits(v->getVKLVolume(getOpenVKLDevice()));
+  }
+#endif
+
+#if OPENVKL_DEVICE_CPU_VDB
+  SECTION("VDB volumes")
+  {
+    auto v = rkcommon::make_unique<WaveletVdbVolumeFloat>(
+        getOpenVKLDevice(), dimensions, gridOrigin, gridSpacing);
+
+    batched_intervals_match_single_intervals(
+        v->getVKLVolume(getOpenVKLDevice()));
+    batched_hits_match_single_hits(v->getVKLVolume(getOpenVKLDevice()));
+  }
+#endif
+
+  shutdownOpenVKL();
+}
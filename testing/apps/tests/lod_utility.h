@@ -0,0 +1,27 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "openvkl_testing.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+// Returns a committed sampler for the given level of detail; the caller must
+// release it.
+inline VKLSampler newLodSampler(VKLVolume volume,
+                                float lod,
+                                VKLFilter filter = VKL_FILTER_TRILINEAR)
+{
+  VKLSampler sampler = vklNewSampler(volume);
+  vklSetInt(sampler, "filter", filter);
+  vklSetFloat(sampler, "lod", lod);
+  vklCommit(sampler);
+  return sampler;
+}
+
+inline float sampleAt(VKLSampler sampler, const vec3f &oc)
+{
+  return vklComputeSample(sampler, (const vkl_vec3f *)&oc, 0, 0.f);
+}
@@ -13,7 +13,8 @@ TEST_CASE("Stream gradients", "[volume_gradients]")
 {
   initializeOpenVKL();
 
-#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR || \
+    OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR_LEGACY
   SECTION("structuredRegular")
   {
     auto v = std::make_shared<WaveletStructuredRegularVolume<float>>(
@@ -55,3 +56,45 @@ TEST_CASE("Stream gradients", "[volume_gradients]")
 
   shutdownOpenVKL();
 }
+
+TEST_CASE("Sample and gradient", "[volume_gradients]")
+{
+  initializeOpenVKL();
+
+  const VKLFilter filters[] = {
+      VKL_FILTER_NEAREST, VKL_FILTER_TRILINEAR, VKL_FILTER_TRICUBIC};
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR || \
+    OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR_LEGACY
+  SECTION("structuredRegular")
+  {
+    auto v = std::make_shared<WaveletStructuredRegularVolume<float>>(
+        vec3i(64), vec3f(0.f), vec3f(1.f));
+    for (VKLFilter filter : filters) {
+      test_sample_and_gradient(v, filter);
+    }
+  }
+#endif
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_SPHERICAL
+  SECTION("structuredSpherical")
+  {
+    auto v = std::make_shared<WaveletStructuredSphericalVolume<float>>(
+        vec3i(64), vec3f(0.f), vec3f(1.f));
+    test_sample_and_gradient(v, VKL_FILTER_TRILINEAR);
+  }
+#endif
+
+#if OPENVKL_DEVICE_CPU_VDB
+  SECTION("vdb")
+  {
+    auto v = std::make_shared<WaveletVdbVolumeFloat>(
+        getOpenVKLDevice(), vec3i(64), vec3f(0.f), vec3f(1.f), true);
+    for (VKLFilter filter : filters) {
+      test_sample_and_gradient(v, filter);
+    }
+  }
+#endif
+
+  shutdownOpenVKL();
+}
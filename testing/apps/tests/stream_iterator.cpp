@@ -0,0 +1,256 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <random>
+#include "../../external/catch.hpp"
+#include "openvkl_testing.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
+TEST_CASE("Stream iteration", "[interval_iterators]")
+{
+  initializeOpenVKL();
+
+  const vec3i dimensions(64);
+
+  auto v = rkcommon::make_unique<WaveletStructuredRegularVolume<float>>(
+      dimensions, vec3f(0.f), vec3f(1.f));
+
+  VKLVolume volume = v->getVKLVolume(getOpenVKLDevice());
+
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  // rays of very different lengths through the volume, so that lanes diverge
+  const unsigned int N = 257;
+
+  std::vector<vkl_vec3f> origins(N);
+  std::vector<vkl_vec3f> directions(N);
+  std::vector<vkl_range1f> tRanges(N);
+
+  std::mt19937 eng(0);
+  std::uniform_real_distribution<float> dist(0.f, 64.f);
+
+  for (unsigned int i = 0; i < N; i++) {
+    const vec3f target(dist(eng), dist(eng), dist(eng));
+    const vec3f d = normalize(target - vec3f(32.f) + vec3f(0.1f));
+
+    (vec3f &)origins[i]    = vec3f(32.f) - 100.f * d;
+    (vec3f &)directions[i] = d;
+    tRanges[i]             = vkl_range1f{0.f, 100.f + 0.5f * dist(eng)};
+  }
+
+  SECTION("intervals are continuous and complete")
+  {
+    VKLIntervalIteratorContext context =
+        vklNewIntervalIteratorContext(sampler);
+    vklSetFloat(context, "intervalResolutionHint", 1.f);
+    vklCommit(context);
+
+    const unsigned int maxIntervals = 512;
+
+    std::vector<VKLInterval> intervals(N * maxIntervals);
+    std::vector<unsigned int> numIntervals(N);
+
+    vklIterateIntervalsN(context,
+                         N,
+                         origins.data(),
+                         directions.data(),
+                         tRanges.data(),
+                         nullptr,
+                         maxIntervals,
+                         intervals.data(),
+                         numIntervals.data());
+
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == VKL_NO_ERROR);
+
+    std::vector<char> buffer(vklGetIntervalIteratorSize(context));
+
+    for (unsigned int i = 0; i < N; i++) {
+      INFO("ray " << i);
+
+      REQUIRE(numIntervals[i] < maxIntervals);
+
+      // compare covered t-range with a scalar iterator
+      VKLIntervalIterator iterator = vklInitIntervalIterator(context,
+                                                             &origins[i],
+                                                             &directions[i],
+                                                             &tRanges[i],
+                                                             0.f,
+                                                             buffer.data());
+
+      VKLInterval first, last, interval;
+      unsigned int count = 0;
+      while (vklIterateInterval(iterator, &interval)) {
+        if (count++ == 0) {
+          first = interval;
+        }
+        last = interval;
+      }
+
+      REQUIRE((numIntervals[i] == 0) == (count == 0));
+
+      if (count == 0) {
+        continue;
+      }
+
+      const VKLInterval *stream = &intervals[i * maxIntervals];
+
+      REQUIRE(stream[0].tRange.lower == Approx(first.tRange.lower));
+      REQUIRE(stream[numIntervals[i] - 1].tRange.upper ==
+              Approx(last.tRange.upper));
+
+      for (unsigned int j = 1; j < numIntervals[i]; j++) {
+        REQUIRE(stream[j].tRange.lower == stream[j - 1].tRange.upper);
+      }
+    }
+
+    vklRelease(context);
+  }
+
+  SECTION("iteration stops at the maximum number of intervals")
+  {
+    VKLIntervalIteratorContext context =
+        vklNewIntervalIteratorContext(sampler);
+    vklSetFloat(context, "intervalResolutionHint", 1.f);
+    vklCommit(context);
+
+    const unsigned int maxIntervals = 3;
+
+    std::vector<VKLInterval> intervals(N * maxIntervals);
+    std::vector<unsigned int> numIntervals(N);
+
+    vklIterateIntervalsN(context,
+                         N,
+                         origins.data(),
+                         directions.data(),
+                         tRanges.data(),
+                         nullptr,
+                         maxIntervals,
+                         intervals.data(),
+                         numIntervals.data());
+
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == VKL_NO_ERROR);
+
+    std::vector<char> buffer(vklGetIntervalIteratorSize(context));
+
+    unsigned int numTruncated = 0;
+
+    for (unsigned int i = 0; i < N; i++) {
+      INFO("ray " << i);
+
+      REQUIRE(numIntervals[i] <= maxIntervals);
+
+      VKLIntervalIterator iterator = vklInitIntervalIterator(context,
+                                                             &origins[i],
+                                                             &directions[i],
+                                                             &tRanges[i],
+                                                             0.f,
+                                                             buffer.data());
+
+      std::vector<VKLInterval> expected;
+      VKLInterval interval;
+      while (vklIterateInterval(iterator, &interval)) {
+        expected.push_back(interval);
+      }
+
+      // rays with more intervals are truncated to exactly the first
+      // maxIntervals intervals of the scalar iterator
+      if (expected.size() > maxIntervals) {
+        numTruncated++;
+        REQUIRE(numIntervals[i] == maxIntervals);
+      } else {
+        REQUIRE(numIntervals[i] == expected.size());
+      }
+
+      const VKLInterval *stream = &intervals[i * maxIntervals];
+
+      for (unsigned int j = 0; j < numIntervals[i]; j++) {
+        INFO("interval " << j);
+        REQUIRE(stream[j].tRange.lower == Approx(expected[j].tRange.lower));
+        REQUIRE(stream[j].tRange.upper == Approx(expected[j].tRange.upper));
+        REQUIRE(stream[j].valueRange.lower ==
+                Approx(expected[j].valueRange.lower));
+        REQUIRE(stream[j].valueRange.upper ==
+                Approx(expected[j].valueRange.upper));
+      }
+    }
+
+    // the limit must actually have been exercised
+    REQUIRE(numTruncated > 0);
+
+    vklRelease(context);
+  }
+
+  SECTION("hits match scalar hit iteration")
+  {
+    const vkl_range1f valueRange = vklGetValueRange(volume);
+
+    std::vector<float> values;
+    for (int i = 1; i < 4; i++) {
+      values.push_back(valueRange.lower +
+                       0.25f * i * (valueRange.upper - valueRange.lower));
+    }
+
+    VKLData valuesData = vklNewData(
+        getOpenVKLDevice(), values.size(), VKL_FLOAT, values.data());
+
+    VKLHitIteratorContext context = vklNewHitIteratorContext(sampler);
+    vklSetData(context, "values", valuesData);
+    vklCommit(context);
+    vklRelease(valuesData);
+
+    const unsigned int maxHits = 64;
+
+    std::vector<VKLHit> hits(N * maxHits);
+    std::vector<unsigned int> numHits(N);
+
+    vklIterateHitsN(context,
+                    N,
+                    origins.data(),
+                    directions.data(),
+                    tRanges.data(),
+                    nullptr,
+                    maxHits,
+                    hits.data(),
+                    numHits.data());
+
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == VKL_NO_ERROR);
+
+    std::vector<char> buffer(vklGetHitIteratorSize(context));
+
+    for (unsigned int i = 0; i < N; i++) {
+      INFO("ray " << i);
+
+      VKLHitIterator iterator = vklInitHitIterator(context,
+                                                   &origins[i],
+                                                   &directions[i],
+                                                   &tRanges[i],
+                                                   0.f,
+                                                   buffer.data());
+
+      std::vector<VKLHit> expected;
+      VKLHit hit;
+      while (vklIterateHit(iterator, &hit)) {
+        expected.push_back(hit);
+      }
+
+      REQUIRE(numHits[i] == expected.size());
+
+      for (unsigned int j = 0; j < numHits[i]; j++) {
+        const VKLHit &h = hits[i * maxHits + j];
+        REQUIRE(h.sample == expected[j].sample);
+        REQUIRE(h.t == Approx(expected[j].t).margin(expected[j].epsilon));
+      }
+    }
+
+    vklRelease(context);
+  }
+
+  vklRelease(sampler);
+
+  shutdownOpenVKL();
+}
+#endif
@@ -8,6 +8,104 @@
 using namespace rkcommon;
 using namespace openvkl::testing;
 
+static bool sameOrNaN(float a, float b)
+{
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+// Sorted stream sampling must return exactly what unsorted sampling returns,
+// in the original order.
+static void test_sorted_stream_sampling(std::shared_ptr<TestingVolume> v)
+{
+  VKLVolume vklVolume = v->getVKLVolume(getOpenVKLDevice());
+
+  VKLSampler reference = vklNewSampler(vklVolume);
+  vklCommit(reference);
+
+  VKLSampler sorted = vklNewSampler(vklVolume);
+  vklSetBool(sorted, "sortQueries", true);
+  vklCommit(sorted);
+
+  vkl_box3f bbox = vklGetBoundingBox(vklVolume);
+
+  std::mt19937 eng(42);
+
+  // Include positions outside the bounding box.
+  const vec3f margin = 0.1f * (vec3f(bbox.upper.x, bbox.upper.y, bbox.upper.z) -
+                               vec3f(bbox.lower.x, bbox.lower.y, bbox.lower.z));
+  std::uniform_real_distribution<float> distX(bbox.lower.x - margin.x,
+                                              bbox.upper.x + margin.x);
+  std::uniform_real_distribution<float> distY(bbox.lower.y - margin.y,
+                                              bbox.upper.y + margin.y);
+  std::uniform_real_distribution<float> distZ(bbox.lower.z - margin.z,
+                                              bbox.upper.z + margin.z);
+
+  // Below and above the minimum batch size for sorting, and above the block
+  // size of the parallel sort.
+  for (const unsigned int N : {1000u, 5000u, 100000u}) {
+    std::vector<vkl_vec3f> objectCoordinates(N);
+    for (auto &oc : objectCoordinates) {
+      oc = vkl_vec3f{distX(eng), distY(eng), distZ(eng)};
+    }
+
+    std::vector<float> samples(N);
+    std::vector<float> samplesTruth(N);
+    vklComputeSampleN(
+        sorted, N, objectCoordinates.data(), samples.data(), 0, nullptr);
+    vklComputeSampleN(reference,
+                      N,
+                      objectCoordinates.data(),
+                      samplesTruth.data(),
+                      0,
+                      nullptr);
+
+    std::vector<vkl_vec3f> gradients(N);
+    std::vector<vkl_vec3f> gradientsTruth(N);
+    vklComputeGradientN(
+        sorted, N, objectCoordinates.data(), gradients.data(), 0, nullptr);
+    vklComputeGradientN(reference,
+                        N,
+                        objectCoordinates.data(),
+                        gradientsTruth.data(),
+                        0,
+                        nullptr);
+
+    std::vector<float> fusedSamples(N);
+    std::vector<vkl_vec3f> fusedGradients(N);
+    std::vector<float> fusedSamplesTruth(N);
+    std::vector<vkl_vec3f> fusedGradientsTruth(N);
+    vklComputeSampleAndGradientN(sorted,
+                                 N,
+                                 objectCoordinates.data(),
+                                 fusedSamples.data(),
+                                 fusedGradients.data(),
+                                 0,
+                                 nullptr);
+    vklComputeSampleAndGradientN(reference,
+                                 N,
+                                 objectCoordinates.data(),
+                                 fusedSamplesTruth.data(),
+                                 fusedGradientsTruth.data(),
+                                 0,
+                                 nullptr);
+
+    for (unsigned int i = 0; i < N; i++) {
+      INFO("N = " << N << ", sample = " << i);
+      REQUIRE(sameOrNaN(samples[i], samplesTruth[i]));
+      REQUIRE(sameOrNaN(gradients[i].x, gradientsTruth[i].x));
+      REQUIRE(sameOrNaN(gradients[i].y, gradientsTruth[i].y));
+      REQUIRE(sameOrNaN(gradients[i].z, gradientsTruth[i].z));
+      REQUIRE(sameOrNaN(fusedSamples[i], fusedSamplesTruth[i]));
+      REQUIRE(sameOrNaN(fusedGradients[i].x, fusedGradientsTruth[i].x));
+      REQUIRE(sameOrNaN(fusedGradients[i].y, fusedGradientsTruth[i].y));
+      REQUIRE(sameOrNaN(fusedGradients[i].z, fusedGradientsTruth[i].z));
+    }
+  }
+
+  vklRelease(sorted);
+  vklRelease(reference);
+}
+
 TEST_CASE("Stream sampling", "[volume_sampling]")
 {
   initializeOpenVKL();
@@ -63,3 +161,38 @@ TEST_CASE("Stream sampling", "[volume_sampling]")
 
   shutdownOpenVKL();
 }
+
+TEST_CASE("Sorted stream sampling", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR || \
+    OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR_LEGACY
+  SECTION("structuredRegular")
+  {
+    auto v = std::make_shared<WaveletStructuredRegularVolume<float>>(
+        vec3i(128), vec3f(0.f), vec3f(1.f));
+    test_sorted_stream_sampling(v);
+  }
+#endif
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_SPHERICAL
+  SECTION("structuredSpherical")
+  {
+    auto v = std::make_shared<WaveletStructuredSphericalVolume<float>>(
+        vec3i(128), vec3f(0.f), vec3f(1.f));
+    test_sorted_stream_sampling(v);
+  }
+#endif
+
+#if OPENVKL_DEVICE_CPU_VDB
+  SECTION("VDB")
+  {
+    auto v = std::make_shared<WaveletVdbVolumeFloat>(
+        getOpenVKLDevice(), vec3i(128), vec3f(0.f), vec3f(1.f), true);
+    test_sorted_stream_sampling(v);
+  }
+#endif
+
+  shutdownOpenVKL();
+}
@@ -1,6 +1,7 @@
 // Copyright 2020 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <random>
 #include "../../external/catch.hpp"
 #include "openvkl_testing.h"
 #include "rkcommon/utility/multidim_index_sequence.h"
@@ -108,3 +109,75 @@ inline void test_64_32bit_addressing(VKLDataCreationFlags dataCreationFlags,
   sampling_on_vertices_vs_procedural_values<VOLUME_TYPE>(
       dimensions, dataCreationFlags, byteStride, step);
 }
+
+// dimensions which are deliberately not a multiple of any brick or
+// compression block size, for tests of alternative memory layouts
+inline vec3i get_dimensions_for_layout_tests()
+{
+  return vec3i(37, 29, 45);
+}
+
+// samples a volume in an alternative memory layout at random locations, and
+// compares against the same volume in the default (linear) layout, for all
+// attributes. samples must match within the given tolerance. lossless layouts
+// (tolerance 0) must also produce identical gradients.
+inline void layout_vs_linear_sampling(VKLVolume linearVolume,
+                                      VKLVolume layoutVolume,
+                                      VKLFilter filter,
+                                      float tolerance,
+                                      bool hasTime)
+{
+  VKLSampler linearSampler = vklNewSampler(linearVolume);
+  vklSetInt(linearSampler, "filter", filter);
+  vklSetInt(linearSampler, "gradientFilter", filter);
+  vklCommit(linearSampler);
+
+  VKLSampler layoutSampler = vklNewSampler(layoutVolume);
+  vklSetInt(layoutSampler, "filter", filter);
+  vklSetInt(layoutSampler, "gradientFilter", filter);
+  vklCommit(layoutSampler);
+
+  const vkl_box3f bbox = vklGetBoundingBox(linearVolume);
+
+  std::random_device rd;
+  std::mt19937 eng(rd());
+
+  std::uniform_real_distribution<float> distX(bbox.lower.x, bbox.upper.x);
+  std::uniform_real_distribution<float> distY(bbox.lower.y, bbox.upper.y);
+  std::uniform_real_distribution<float> distZ(bbox.lower.z, bbox.upper.z);
+  std::uniform_real_distribution<float> distTime(0.f, 1.f);
+
+  for (int i = 0; i < 1000; i++) {
+    const vec3f oc(distX(eng), distY(eng), distZ(eng));
+    const float time = hasTime ? distTime(eng) : 0.f;
+
+    INFO("objectCoordinates = " << oc.x << " " << oc.y << " " << oc.z);
+    INFO("time = " << time);
+
+    for (unsigned int a = 0; a < vklGetNumAttributes(linearVolume); a++) {
+      INFO("attribute index = " << a);
+
+      const float linearSample = vklComputeSample(
+          linearSampler, (const vkl_vec3f *)&oc, a, time);
+
+      test_scalar_and_vector_sampling(
+          layoutSampler, oc, linearSample, tolerance, a, time);
+
+      if (tolerance > 0.f) {
+        continue;
+      }
+
+      const vkl_vec3f linearGradient = vklComputeGradient(
+          linearSampler, (const vkl_vec3f *)&oc, a, time);
+      const vkl_vec3f layoutGradient = vklComputeGradient(
+          layoutSampler, (const vkl_vec3f *)&oc, a, time);
+
+      REQUIRE(linearGradient.x == layoutGradient.x);
+      REQUIRE(linearGradient.y == layoutGradient.y);
+      REQUIRE(linearGradient.z == layoutGradient.z);
+    }
+  }
+
+  vklRelease(layoutSampler);
+  vklRelease(linearSampler);
+}
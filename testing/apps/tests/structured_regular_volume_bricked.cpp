@@ -0,0 +1,105 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../external/catch.hpp"
+#include "openvkl_testing.h"
+#include "structured_regular_volume.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+template <typename VOLUME_TYPE>
+void test_bricked_layout(const TemporalConfig &temporalConfig = {})
+{
+  const vec3i dimensions = get_dimensions_for_layout_tests();
+  const vec3f gridOrigin(0.f);
+  const vec3f gridSpacing(1.f);
+
+  for (int brickSize : {8, 16}) {
+    for (VKLFilter filter :
+         {VKL_FILTER_NEAREST, VKL_FILTER_TRILINEAR, VKL_FILTER_TRICUBIC}) {
+      INFO("brickSize = " << brickSize);
+      INFO("filter = " << filter);
+
+      auto linear = std::make_shared<VOLUME_TYPE>(
+          dimensions, gridOrigin, gridSpacing, temporalConfig);
+      auto bricked = std::make_shared<VOLUME_TYPE>(
+          dimensions, gridOrigin, gridSpacing, temporalConfig);
+
+      VKLVolume brickedVolume = bricked->getVKLVolume(getOpenVKLDevice());
+      vklSetInt(brickedVolume, "brickSize", brickSize);
+      vklCommit(brickedVolume);
+
+      // the bricked layout only changes the order of voxels in memory, so
+      // results must be identical
+      layout_vs_linear_sampling(linear->getVKLVolume(getOpenVKLDevice()),
+                                brickedVolume,
+                                filter,
+                                0.f,
+                                temporalConfig.hasTime());
+    }
+  }
+}
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
+TEST_CASE("Structured regular volume bricked layout", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  SECTION("invalid brick size")
+  {
+    auto v = std::make_shared<WaveletStructuredRegularVolumeFloat>(
+        vec3i(32), vec3f(0.f), vec3f(1.f));
+
+    VKLVolume vklVolume = v->getVKLVolume(getOpenVKLDevice());
+    vklSetInt(vklVolume, "brickSize", 4);
+    vklCommit(vklVolume);
+
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) != VKL_NO_ERROR);
+  }
+
+  SECTION("unsigned char")
+  {
+    test_bricked_layout<WaveletStructuredRegularVolumeUChar>();
+  }
+
+  SECTION("short")
+  {
+    test_bricked_layout<WaveletStructuredRegularVolumeShort>();
+  }
+
+  SECTION("unsigned short")
+  {
+    test_bricked_layout<WaveletStructuredRegularVolumeUShort>();
+  }
+
+  SECTION("half")
+  {
+    test_bricked_layout<WaveletStructuredRegularVolumeHalf>();
+  }
+
+  SECTION("float")
+  {
+    test_bricked_layout<WaveletStructuredRegularVolumeFloat>();
+  }
+
+  SECTION("double")
+  {
+    test_bricked_layout<WaveletStructuredRegularVolumeDouble>();
+  }
+
+  SECTION("temporally structured")
+  {
+    test_bricked_layout<WaveletStructuredRegularVolumeFloat>(
+        TemporalConfig(TemporalConfig::Structured, 4));
+  }
+
+  SECTION("temporally unstructured")
+  {
+    test_bricked_layout<WaveletStructuredRegularVolumeFloat>(
+        TemporalConfig(TemporalConfig::Unstructured, 3));
+  }
+
+  shutdownOpenVKL();
+}
+#endif
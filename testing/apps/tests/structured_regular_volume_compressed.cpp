@@ -0,0 +1,135 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <limits>
+#include <vector>
+#include "../../external/catch.hpp"
+#include "openvkl_testing.h"
+#include "structured_regular_volume.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+// samples a compressed volume at random locations, and compares against the
+// same volume without compression. each voxel is quantized to half a step of
+// its block's value range at most, which in turn is bounded by the value
+// range of the whole volume.
+template <typename VOLUME_TYPE>
+void compressed_vs_uncompressed_sampling(int bitsPerVoxel, VKLFilter filter)
+{
+  const vec3i dimensions = get_dimensions_for_layout_tests();
+  const vec3f gridOrigin(0.f);
+  const vec3f gridSpacing(1.f);
+
+  auto uncompressed =
+      std::make_shared<VOLUME_TYPE>(dimensions, gridOrigin, gridSpacing);
+  auto compressed =
+      std::make_shared<VOLUME_TYPE>(dimensions, gridOrigin, gridSpacing);
+
+  VKLVolume uncompressedVolume =
+      uncompressed->getVKLVolume(getOpenVKLDevice());
+
+  VKLVolume compressedVolume = compressed->getVKLVolume(getOpenVKLDevice());
+  vklSetInt(compressedVolume, "compressionBitsPerVoxel", bitsPerVoxel);
+  vklCommit(compressedVolume);
+
+  REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == VKL_NO_ERROR);
+
+  const range1f valueRange = uncompressed->getComputedValueRange();
+  const float tolerance =
+      1.01f * valueRange.size() / (2.f * ((1 << bitsPerVoxel) - 1)) + 1e-5f;
+
+  // the value range of the compressed volume is computed from decoded voxels
+  const vkl_range1f compressedRange = vklGetValueRange(compressedVolume, 0);
+  REQUIRE(compressedRange.lower ==
+          Approx(valueRange.lower).margin(tolerance));
+  REQUIRE(compressedRange.upper ==
+          Approx(valueRange.upper).margin(tolerance));
+
+  layout_vs_linear_sampling(
+      uncompressedVolume, compressedVolume, filter, tolerance, false);
+}
+
+template <typename VOLUME_TYPE>
+void test_compressed_volume()
+{
+  for (int bitsPerVoxel : {4, 8}) {
+    for (VKLFilter filter : {VKL_FILTER_NEAREST, VKL_FILTER_TRILINEAR}) {
+      INFO("bitsPerVoxel = " << bitsPerVoxel);
+      INFO("filter = " << filter);
+      compressed_vs_uncompressed_sampling<VOLUME_TYPE>(bitsPerVoxel, filter);
+    }
+  }
+}
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
+TEST_CASE("Structured regular volume compression", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  SECTION("invalid parameters")
+  {
+    auto v = std::make_shared<WaveletStructuredRegularVolumeFloat>(
+        vec3i(32), vec3f(0.f), vec3f(1.f));
+
+    VKLVolume vklVolume = v->getVKLVolume(getOpenVKLDevice());
+
+    vklSetInt(vklVolume, "compressionBitsPerVoxel", 6);
+    vklCommit(vklVolume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) != VKL_NO_ERROR);
+
+    vklSetInt(vklVolume, "compressionBitsPerVoxel", 8);
+    vklSetInt(vklVolume, "brickSize", 8);
+    vklCommit(vklVolume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) != VKL_NO_ERROR);
+  }
+
+  SECTION("non-finite voxels")
+  {
+    for (float invalid : {std::numeric_limits<float>::quiet_NaN(),
+                          std::numeric_limits<float>::infinity()}) {
+      INFO("invalid = " << invalid);
+
+      std::vector<float> voxels(9 * 9 * 9, 1.f);
+      voxels[100] = invalid;
+
+      VKLVolume vklVolume =
+          vklNewVolume(getOpenVKLDevice(), "structuredRegular");
+      vklSetVec3i(vklVolume, "dimensions", 9, 9, 9);
+
+      VKLData data = vklNewData(
+          getOpenVKLDevice(), voxels.size(), VKL_FLOAT, voxels.data());
+      vklSetData(vklVolume, "data", data);
+      vklRelease(data);
+
+      vklSetInt(vklVolume, "compressionBitsPerVoxel", 8);
+      vklCommit(vklVolume);
+      REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) != VKL_NO_ERROR);
+
+      vklRelease(vklVolume);
+    }
+  }
+
+  SECTION("unsigned char")
+  {
+    test_compressed_volume<WaveletStructuredRegularVolumeUChar>();
+  }
+
+  SECTION("half")
+  {
+    test_compressed_volume<WaveletStructuredRegularVolumeHalf>();
+  }
+
+  SECTION("float")
+  {
+    test_compressed_volume<WaveletStructuredRegularVolumeFloat>();
+  }
+
+  SECTION("double")
+  {
+    test_compressed_volume<WaveletStructuredRegularVolumeDouble>();
+  }
+
+  shutdownOpenVKL();
+}
+#endif
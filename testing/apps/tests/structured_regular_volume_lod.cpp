@@ -0,0 +1,106 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../external/catch.hpp"
+#include "lod_utility.h"
+#include "openvkl_testing.h"
+#include "rkcommon/utility/multidim_index_sequence.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
+TEST_CASE("Structured regular volume level of detail", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  // grid origin and spacing are identity, so object coordinates are index
+  // coordinates.
+  const vec3i dimensions(32);
+  auto v = std::make_shared<WaveletStructuredRegularVolumeFloat>(
+      dimensions, vec3f(0.f), vec3f(1.f));
+
+  VKLVolume volume = v->getVKLVolume(getOpenVKLDevice());
+  vklSetInt(volume, "mipLevels", 2);
+  vklCommit(volume);
+
+  REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == VKL_NO_ERROR);
+
+  VKLSampler nearest = newLodSampler(volume, 0.f, VKL_FILTER_NEAREST);
+
+  SECTION("lod 0 samples the full resolution volume")
+  {
+    VKLSampler reference = vklNewSampler(volume);
+    vklCommit(reference);
+    VKLSampler lod0 = newLodSampler(volume, 0.f);
+
+    multidim_index_sequence<3> mis(dimensions - 1);
+    for (const auto &ijk : mis) {
+      const vec3f oc = vec3f(ijk) + vec3f(0.3f, 0.5f, 0.7f);
+      REQUIRE(sampleAt(lod0, oc) == sampleAt(reference, oc));
+    }
+
+    vklRelease(lod0);
+    vklRelease(reference);
+  }
+
+  SECTION("coarse voxels are averages of fine voxels")
+  {
+    VKLSampler lod1 = newLodSampler(volume, 1.f);
+
+    multidim_index_sequence<3> mis(dimensions / 2);
+    for (const auto &ijk : mis) {
+      float average = 0.f;
+      for (int k = 0; k < 8; k++) {
+        const vec3i fine = 2 * ijk + vec3i(k & 1, (k >> 1) & 1, k >> 2);
+        average += sampleAt(nearest, vec3f(fine)) / 8.f;
+      }
+
+      // coarse voxel centers are halfway between their fine voxels
+      const vec3f oc = vec3f(2 * ijk) + vec3f(0.5f);
+
+      INFO("coarse voxel = " << ijk.x << " " << ijk.y << " " << ijk.z);
+      REQUIRE(sampleAt(lod1, oc) == Approx(average).margin(1e-5f));
+    }
+
+    vklRelease(lod1);
+  }
+
+  SECTION("fractional lod blends between levels")
+  {
+    VKLSampler lod1  = newLodSampler(volume, 1.f);
+    VKLSampler lod2  = newLodSampler(volume, 2.f);
+    VKLSampler lod15 = newLodSampler(volume, 1.5f);
+    VKLSampler lod9  = newLodSampler(volume, 9.f);
+
+    multidim_index_sequence<3> mis(dimensions / 3);
+    for (const auto &ijk : mis) {
+      const vec3f oc = vec3f(3 * ijk) + vec3f(0.25f);
+
+      INFO("objectCoordinates = " << oc.x << " " << oc.y << " " << oc.z);
+      REQUIRE(sampleAt(lod15, oc) ==
+              Approx(0.5f * (sampleAt(lod1, oc) + sampleAt(lod2, oc)))
+                  .margin(1e-5f));
+
+      // only two levels were requested
+      REQUIRE(sampleAt(lod9, oc) == sampleAt(lod2, oc));
+    }
+
+    vklRelease(lod9);
+    vklRelease(lod15);
+    vklRelease(lod2);
+    vklRelease(lod1);
+  }
+
+  SECTION("negative lod is an error")
+  {
+    VKLSampler sampler = newLodSampler(volume, -1.f);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) != VKL_NO_ERROR);
+    vklRelease(sampler);
+  }
+
+  vklRelease(nearest);
+
+  shutdownOpenVKL();
+}
+#endif
@@ -0,0 +1,192 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdio>
+#include <fstream>
+#include "../../external/catch.hpp"
+#include "openvkl_testing.h"
+#include "rkcommon/utility/multidim_index_sequence.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+// raw files are memory mapped and shared with Open VKL; sampling must match
+// the procedural volume the file was written from.
+inline void test_mapped_file(
+    std::shared_ptr<TestingStructuredVolume> fileVolume,
+    std::shared_ptr<TestingStructuredVolume> reference)
+{
+  VKLVolume fileVKLVolume      = fileVolume->getVKLVolume(getOpenVKLDevice());
+  VKLVolume referenceVKLVolume = reference->getVKLVolume(getOpenVKLDevice());
+
+  REQUIRE(fileVolume->getComputedValueRange() ==
+          reference->getComputedValueRange());
+
+  VKLSampler fileSampler = vklNewSampler(fileVKLVolume);
+  vklCommit(fileSampler);
+  VKLSampler referenceSampler = vklNewSampler(referenceVKLVolume);
+  vklCommit(referenceSampler);
+
+  const bool hasTime = reference->getTemporalConfig().hasTime();
+
+  multidim_index_sequence<3> mis(reference->getDimensions() / 3);
+
+  for (const auto &offset : mis) {
+    const vec3f oc = reference->getGridOrigin() +
+                     vec3f(offset * 3) * reference->getGridSpacing() +
+                     vec3f(0.25f);
+
+    for (float time : {0.f, 0.3f, 1.f}) {
+      if (!hasTime && time != 0.f) {
+        continue;
+      }
+
+      INFO("offset = " << offset.x << " " << offset.y << " " << offset.z);
+      INFO("time = " << time);
+
+      const float fileSample =
+          vklComputeSample(fileSampler, (const vkl_vec3f *)&oc, 0, time);
+      const float referenceSample =
+          vklComputeSample(referenceSampler, (const vkl_vec3f *)&oc, 0, time);
+
+      REQUIRE(fileSample == referenceSample);
+    }
+  }
+
+  vklRelease(referenceSampler);
+  vklRelease(fileSampler);
+}
+
+template <typename T>
+inline void writeItems(std::ofstream &out, const std::vector<T> &items)
+{
+  out.write((const char *)items.data(), items.size() * sizeof(T));
+}
+
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
+TEST_CASE("Structured regular volume raw files", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  const vec3i dimensions(41, 37, 29);
+  const vec3f gridOrigin(0.f);
+  const vec3f gridSpacing(1.f);
+
+  std::vector<unsigned char> voxels;
+  std::vector<float> time;
+  std::vector<uint32_t> tuvIndex;
+
+  SECTION("raw")
+  {
+    const std::string filename = "structured_regular_volume_raw_file.raw";
+
+    auto reference = std::make_shared<WaveletStructuredRegularVolumeUShort>(
+        dimensions, gridOrigin, gridSpacing);
+    reference->generateVoxels(voxels, time, tuvIndex);
+
+    {
+      std::ofstream out(filename, std::ios::binary);
+      writeItems(out, voxels);
+    }
+
+    for (auto advice : {MappedFileAdvice::Normal,
+                        MappedFileAdvice::Random,
+                        MappedFileAdvice::WillNeed}) {
+      auto fileVolume =
+          std::make_shared<RawFileStructuredVolume>(filename,
+                                                    "structuredRegular",
+                                                    dimensions,
+                                                    gridOrigin,
+                                                    gridSpacing,
+                                                    VKL_USHORT,
+                                                    advice);
+      test_mapped_file(fileVolume, reference);
+    }
+
+    std::remove(filename.c_str());
+  }
+
+  SECTION("rawh, temporally constant")
+  {
+    const std::string filename = "structured_regular_volume_raw_file.rwh";
+
+    auto reference = std::make_shared<WaveletStructuredRegularVolumeFloat>(
+        dimensions, gridOrigin, gridSpacing);
+    reference->generateVoxels(voxels, time, tuvIndex);
+
+    {
+      std::ofstream out(filename, std::ios::binary);
+      writeItems(out,
+                 std::vector<int>{0, dimensions.x, dimensions.y, dimensions.z});
+      writeItems(out, voxels);
+    }
+
+    {
+      auto fileVolume = std::make_shared<RawHFileStructuredVolume>(
+          filename, "structuredRegular", gridOrigin, gridSpacing);
+      test_mapped_file(fileVolume, reference);
+    }
+
+    std::remove(filename.c_str());
+  }
+
+  SECTION("rawh, temporally structured")
+  {
+    const std::string filename = "structured_regular_volume_raw_file.rwh";
+
+    auto reference = std::make_shared<WaveletStructuredRegularVolumeFloat>(
+        dimensions,
+        gridOrigin,
+        gridSpacing,
+        TemporalConfig(TemporalConfig::Structured, 3));
+    reference->generateVoxels(voxels, time, tuvIndex);
+
+    {
+      std::ofstream out(filename, std::ios::binary);
+      writeItems(out,
+                 std::vector<int>{1, dimensions.x, dimensions.y, dimensions.z});
+      writeItems(out, std::vector<size_t>{3});
+      writeItems(out, voxels);
+    }
+
+    {
+      auto fileVolume = std::make_shared<RawHFileStructuredVolume>(
+          filename, "structuredRegular", gridOrigin, gridSpacing);
+      test_mapped_file(fileVolume, reference);
+    }
+
+    std::remove(filename.c_str());
+  }
+
+  SECTION("rawh, temporally unstructured")
+  {
+    const std::string filename = "structured_regular_volume_raw_file.rwh";
+
+    auto reference = std::make_shared<WaveletStructuredRegularVolumeFloat>(
+        dimensions,
+        gridOrigin,
+        gridSpacing,
+        TemporalConfig(TemporalConfig::Unstructured, 3));
+    reference->generateVoxels(voxels, time, tuvIndex);
+
+    {
+      std::ofstream out(filename, std::ios::binary);
+      writeItems(out,
+                 std::vector<int>{2, dimensions.x, dimensions.y, dimensions.z});
+      writeItems(out, tuvIndex);
+      writeItems(out, time);
+      writeItems(out, voxels);
+    }
+
+    {
+      auto fileVolume = std::make_shared<RawHFileStructuredVolume>(
+          filename, "structuredRegular", gridOrigin, gridSpacing);
+      test_mapped_file(fileVolume, reference);
+    }
+
+    std::remove(filename.c_str());
+  }
+
+  shutdownOpenVKL();
+}
+#endif
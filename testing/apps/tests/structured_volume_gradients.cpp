@@ -66,13 +66,15 @@ void scalar_gradients(float tolerance = 0.1f, bool skipBoundaries = true)
   vklRelease(vklSampler);
 }
 
-#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR || \
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR ||        \
+    OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR_LEGACY || \
     OPENVKL_DEVICE_CPU_STRUCTURED_SPHERICAL
 TEST_CASE("Structured volume gradients", "[volume_gradients]")
 {
   initializeOpenVKL();
 
-#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR
+#if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR || \
+    OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR_LEGACY
   SECTION("XYZStructuredRegularVolume<float>")
   {
     scalar_gradients<XYZStructuredRegularVolume<float>>();
@@ -38,6 +38,118 @@ void computed_vs_api_value_range(vec3i dimensions = vec3i(128))
            apiValueRange.upper == computedValueRange.upper));
 }
 
+// voxel data is modified in place in a shared buffer, and the volume is
+// recommitted with only the modified regions updated; the resulting value
+// range must match that of a volume built from scratch.
+inline void modified_regions_value_range(const std::string &volumeType,
+                                         const vec3i &dimensions,
+                                         const vec3f &gridSpacing)
+{
+  std::vector<float> voxels(dimensions.long_product());
+  for (size_t i = 0; i < voxels.size(); i++) {
+    voxels[i] = float(i % 97) / 97.f;
+  }
+
+  auto setVoxels = [&](const box3i &region, float value) {
+    for (int z = region.lower.z; z <= region.upper.z; z++)
+      for (int y = region.lower.y; y <= region.upper.y; y++)
+        for (int x = region.lower.x; x <= region.upper.x; x++)
+          voxels[x + dimensions.x * (y + dimensions.y * size_t(z))] = value;
+  };
+
+  auto newVolume = [&](VKLDataCreationFlags flags) -> VKLVolume {
+    VKLVolume volume = vklNewVolume(getOpenVKLDevice(), volumeType.c_str());
+    vklSetVec3i(
+        volume, "dimensions", dimensions.x, dimensions.y, dimensions.z);
+    vklSetVec3f(
+        volume, "gridSpacing", gridSpacing.x, gridSpacing.y, gridSpacing.z);
+
+    VKLData data = vklNewData(
+        getOpenVKLDevice(), voxels.size(), VKL_FLOAT, voxels.data(), flags);
+    vklSetData(volume, "data", data);
+    vklRelease(data);
+
+    vklCommit(volume);
+    return volume;
+  };
+
+  auto requireValueRange = [&](VKLVolume volume, const range1f &expected) {
+    VKLVolume reference = newVolume(VKL_DATA_DEFAULT);
+
+    const vkl_range1f valueRange          = vklGetValueRange(volume);
+    const vkl_range1f referenceValueRange = vklGetValueRange(reference);
+
+    vklRelease(reference);
+
+    INFO("valueRange = " << valueRange.lower << " " << valueRange.upper);
+    INFO("reference valueRange = " << referenceValueRange.lower << " "
+                                   << referenceValueRange.upper);
+
+    REQUIRE((valueRange.lower == referenceValueRange.lower &&
+             valueRange.upper == referenceValueRange.upper));
+    REQUIRE((valueRange.lower == expected.lower &&
+             valueRange.upper == expected.upper));
+  };
+
+  auto commitModifiedRegions = [&](VKLVolume volume,
+                                   const std::vector<box3i> &regions) {
+    VKLData data = vklNewData(
+        getOpenVKLDevice(), regions.size(), VKL_BOX3I, regions.data());
+    vklSetData(volume, "modifiedRegions", data);
+    vklRelease(data);
+
+    vklCommit(volume);
+  };
+
+  VKLVolume volume = newVolume(VKL_DATA_SHARED_BUFFER);
+  requireValueRange(volume, range1f(0.f, 96.f / 97.f));
+
+  // extend the value range in the interior, on a macrocell boundary, and at
+  // the upper corner of the volume
+  const box3i interior(vec3i(20, 10, 5), vec3i(35, 22, 17));
+  const box3i boundary(vec3i(16), vec3i(16));
+  const box3i corner(dimensions - 1, dimensions - 1);
+
+  setVoxels(interior, 2.f);
+  setVoxels(boundary, 3.f);
+  setVoxels(corner, -1.f);
+  commitModifiedRegions(volume, {interior, boundary, corner});
+  requireValueRange(volume, range1f(-1.f, 3.f));
+
+  // shrinking the value range requires the modified cells to be recomputed
+  setVoxels(boundary, 0.5f);
+  setVoxels(corner, 0.5f);
+  commitModifiedRegions(volume, {boundary, corner});
+  requireValueRange(volume, range1f(0.f, 2.f));
+
+  setVoxels(interior, 0.5f);
+  commitModifiedRegions(volume, {interior});
+  requireValueRange(volume, range1f(0.f, 96.f / 97.f));
+
+  // regions still set from the previous commit do not describe later
+  // modifications, so the whole volume must be updated
+  setVoxels(box3i(vec3i(1), vec3i(1)), 5.f);
+  vklCommit(volume);
+  requireValueRange(volume, range1f(0.f, 5.f));
+
+  // new data arrays are not covered by modified regions either
+  std::vector<float> otherVoxels(voxels.size(), 10.f);
+  otherVoxels.back() = 11.f;
+  VKLData otherData = vklNewData(getOpenVKLDevice(),
+                                 otherVoxels.size(),
+                                 VKL_FLOAT,
+                                 otherVoxels.data());
+  vklSetData(volume, "data", otherData);
+  vklRelease(otherData);
+  commitModifiedRegions(volume, {boundary});
+
+  const vkl_range1f otherValueRange = vklGetValueRange(volume);
+  REQUIRE(otherValueRange.lower == 10.f);
+  REQUIRE(otherValueRange.upper == 11.f);
+
+  vklRelease(volume);
+}
+
 #if OPENVKL_DEVICE_CPU_STRUCTURED_REGULAR || \
     OPENVKL_DEVICE_CPU_STRUCTURED_SPHERICAL
 TEST_CASE("Structured volume value range", "[volume_value_range]")
@@ -111,6 +223,13 @@ TEST_CASE("Structured volume value range", "[volume_value_range]")
     {
       computed_vs_api_value_range<WaveletStructuredSphericalVolumeDouble>();
     }
+
+    SECTION("modified regions")
+    {
+      modified_regions_value_range("structuredSpherical",
+                                   vec3i(70, 50, 40),
+                                   vec3f(1.f, 3.f, 9.f));
+    }
   }
 #endif
 
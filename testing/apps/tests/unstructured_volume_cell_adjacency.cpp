@@ -0,0 +1,116 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <random>
+#include "unstructured_volume_utility.h"
+
+static std::vector<VKLHit> iterateHits(VKLHitIteratorContext context,
+                                       const vkl_vec3f &origin,
+                                       const vkl_vec3f &direction)
+{
+  const vkl_range1f tRange{0.f, inf};
+
+  std::vector<char> buffer(vklGetHitIteratorSize(context));
+
+  VKLHitIterator iterator = vklInitHitIterator(
+      context, &origin, &direction, &tRange, 0.f, buffer.data());
+
+  std::vector<VKLHit> hits;
+  VKLHit hit;
+  while (vklIterateHit(iterator, &hit)) {
+    hits.push_back(hit);
+  }
+
+  return hits;
+}
+
+static VKLHitIteratorContext newHitIteratorContext(
+    VKLSampler sampler, const std::vector<float> &values)
+{
+  VKLData valuesData = vklNewData(
+      getOpenVKLDevice(), values.size(), VKL_FLOAT, values.data());
+
+  VKLHitIteratorContext context = vklNewHitIteratorContext(sampler);
+  vklSetData(context, "values", valuesData);
+  vklCommit(context);
+  vklRelease(valuesData);
+
+  return context;
+}
+
+#if OPENVKL_DEVICE_CPU_UNSTRUCTURED
+TEST_CASE("Unstructured volume cell adjacency", "[hit_iterators]")
+{
+  initializeOpenVKL();
+
+  const vec3i dimensions(32);
+
+  std::unique_ptr<WaveletUnstructuredProceduralVolume> v, vAdjacency;
+
+  VKLVolume volume = newWaveletUnstructuredVolume(
+      v, dimensions, {{"cellAdjacency", false}});
+  VKLVolume volumeAdjacency = newWaveletUnstructuredVolume(
+      vAdjacency, dimensions, {{"cellAdjacency", true}});
+
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  VKLSampler samplerAdjacency = vklNewSampler(volumeAdjacency);
+  vklCommit(samplerAdjacency);
+
+  const vkl_range1f valueRange = vklGetValueRange(volume);
+  const float valueWidth       = valueRange.upper - valueRange.lower;
+
+  std::vector<float> values;
+  for (int i = 1; i < 4; i++) {
+    values.push_back(valueRange.lower + 0.25f * i * valueWidth);
+  }
+
+  VKLHitIteratorContext context = newHitIteratorContext(sampler, values);
+  VKLHitIteratorContext contextAdjacency =
+      newHitIteratorContext(samplerAdjacency, values);
+
+  std::mt19937 eng(42);
+  std::uniform_real_distribution<float> dist(0.f, float(dimensions.x));
+
+  SECTION("hits match BVH traversal")
+  {
+    for (int i = 0; i < 16; i++) {
+      // rays both from outside and from inside the mesh
+      const vec3f o = (i % 2) ? vec3f(dist(eng), dist(eng), dist(eng))
+                              : vec3f(-1.f);
+      const vec3f target(dist(eng), dist(eng), dist(eng));
+      const vec3f d = normalize(target - o + vec3f(0.f, 0.f, 1e-3f));
+
+      const vkl_vec3f origin{o.x, o.y, o.z};
+      const vkl_vec3f direction{d.x, d.y, d.z};
+
+      const std::vector<VKLHit> hits = iterateHits(context, origin, direction);
+      const std::vector<VKLHit> hitsAdjacency =
+          iterateHits(contextAdjacency, origin, direction);
+
+      INFO("origin = " << o.x << " " << o.y << " " << o.z);
+      INFO("direction = " << d.x << " " << d.y << " " << d.z);
+
+      REQUIRE(hitsAdjacency.size() == hits.size());
+
+      for (size_t j = 0; j < hits.size(); j++) {
+        REQUIRE(hitsAdjacency[j].sample == hits[j].sample);
+        REQUIRE(std::abs(hitsAdjacency[j].t - hits[j].t) <=
+                hits[j].epsilon + hitsAdjacency[j].epsilon);
+      }
+    }
+  }
+
+  vklRelease(contextAdjacency);
+  vklRelease(context);
+
+  vklRelease(samplerAdjacency);
+  vklRelease(sampler);
+
+  v.reset();
+  vAdjacency.reset();
+
+  shutdownOpenVKL();
+}
+#endif
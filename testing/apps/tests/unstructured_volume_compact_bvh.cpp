@@ -0,0 +1,111 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include <random>
+#include "unstructured_volume_utility.h"
+
+#if OPENVKL_DEVICE_CPU_UNSTRUCTURED
+TEST_CASE("Unstructured volume compact BVH", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  const vec3i dimensions(32);
+
+  std::unique_ptr<WaveletUnstructuredProceduralVolume> v, vCompact;
+
+  VKLVolume volume =
+      newWaveletUnstructuredVolume(v, dimensions, {{"compactBVH", false}});
+  VKLVolume volumeCompact = newWaveletUnstructuredVolume(
+      vCompact, dimensions, {{"compactBVH", true}});
+
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  VKLSampler samplerCompact = vklNewSampler(volumeCompact);
+  vklCommit(samplerCompact);
+
+  std::mt19937 eng(42);
+  std::uniform_real_distribution<float> dist(-1.f, dimensions.x + 1.f);
+
+  SECTION("sampling matches the default BVH")
+  {
+    for (int i = 0; i < 1000; i++) {
+      const vec3f oc(dist(eng), dist(eng), dist(eng));
+
+      const float sample =
+          vklComputeSample(sampler, (const vkl_vec3f *)&oc, 0, 0.f);
+      const float sampleCompact =
+          vklComputeSample(samplerCompact, (const vkl_vec3f *)&oc, 0, 0.f);
+
+      INFO("objectCoordinates = " << oc.x << " " << oc.y << " " << oc.z);
+
+      requireSameSample(sample, sampleCompact);
+    }
+  }
+
+  SECTION("interval value ranges are conservative")
+  {
+    VKLIntervalIteratorContext context =
+        vklNewIntervalIteratorContext(samplerCompact);
+    vklCommit(context);
+
+    std::vector<char> buffer(vklGetIntervalIteratorSize(context));
+
+    // allows for rounding of the quantized node bounds
+    const vkl_range1f valueRange = vklGetValueRange(volume);
+    const float valueWidth       = valueRange.upper - valueRange.lower;
+    const float tolerance        = 1e-3f * valueWidth;
+
+    for (int i = 0; i < 16; i++) {
+      const vec3f target(dist(eng), dist(eng), dist(eng));
+      const vec3f d = normalize(target - vec3f(-1.f));
+
+      const vkl_vec3f origin{-1.f, -1.f, -1.f};
+      const vkl_vec3f direction{d.x, d.y, d.z};
+      const vkl_range1f tRange{0.f, inf};
+
+      VKLIntervalIterator iterator = vklInitIntervalIterator(
+          context, &origin, &direction, &tRange, 0.f, buffer.data());
+
+      int numIntervals = 0;
+
+      VKLInterval interval;
+      while (vklIterateInterval(iterator, &interval)) {
+        numIntervals++;
+
+        // interior points only, as decoded node bounds are slightly larger
+        // than the original ones
+        for (int j = 1; j < 8; j++) {
+          const float t = interval.tRange.lower +
+                          j / 8.f * (interval.tRange.upper -
+                                     interval.tRange.lower);
+          const vec3f p = vec3f(-1.f) + t * d;
+
+          const float sample =
+              vklComputeSample(samplerCompact, (const vkl_vec3f *)&p, 0, 0.f);
+
+          INFO("t = " << t << " sample = " << sample);
+
+          if (!std::isnan(sample)) {
+            REQUIRE(sample >= interval.valueRange.lower - tolerance);
+            REQUIRE(sample <= interval.valueRange.upper + tolerance);
+          }
+        }
+      }
+
+      REQUIRE(numIntervals > 0);
+    }
+
+    vklRelease(context);
+  }
+
+  vklRelease(samplerCompact);
+  vklRelease(sampler);
+
+  v.reset();
+  vCompact.reset();
+
+  shutdownOpenVKL();
+}
+#endif
@@ -0,0 +1,96 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <random>
+#include "unstructured_volume_utility.h"
+
+static void reordered_sampling_matches(VKLUnstructuredCellType primType,
+                                       bool cellValued,
+                                       bool indexPrefix)
+{
+  const vec3i dimensions(16);
+
+  std::unique_ptr<WaveletUnstructuredProceduralVolume> v, vReordered;
+
+  VKLVolume volume = newWaveletUnstructuredVolume(v,
+                                                  dimensions,
+                                                  {{"spatialReorder", false}},
+                                                  primType,
+                                                  cellValued,
+                                                  indexPrefix);
+  VKLVolume volumeReordered =
+      newWaveletUnstructuredVolume(vReordered,
+                                   dimensions,
+                                   {{"spatialReorder", true}},
+                                   primType,
+                                   cellValued,
+                                   indexPrefix);
+
+  const vkl_box3f bbox          = vklGetBoundingBox(volume);
+  const vkl_box3f bboxReordered = vklGetBoundingBox(volumeReordered);
+
+  REQUIRE(bboxReordered.lower.x == bbox.lower.x);
+  REQUIRE(bboxReordered.lower.y == bbox.lower.y);
+  REQUIRE(bboxReordered.lower.z == bbox.lower.z);
+  REQUIRE(bboxReordered.upper.x == bbox.upper.x);
+  REQUIRE(bboxReordered.upper.y == bbox.upper.y);
+  REQUIRE(bboxReordered.upper.z == bbox.upper.z);
+
+  const vkl_range1f valueRange          = vklGetValueRange(volume);
+  const vkl_range1f valueRangeReordered = vklGetValueRange(volumeReordered);
+
+  REQUIRE(valueRangeReordered.lower == valueRange.lower);
+  REQUIRE(valueRangeReordered.upper == valueRange.upper);
+
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  VKLSampler samplerReordered = vklNewSampler(volumeReordered);
+  vklCommit(samplerReordered);
+
+  std::mt19937 eng(42);
+  std::uniform_real_distribution<float> dist(-1.f, dimensions.x + 1.f);
+
+  for (int i = 0; i < 1000; i++) {
+    const vec3f oc(dist(eng), dist(eng), dist(eng));
+
+    const float sample =
+        vklComputeSample(sampler, (const vkl_vec3f *)&oc, 0, 0.f);
+    const float sampleReordered =
+        vklComputeSample(samplerReordered, (const vkl_vec3f *)&oc, 0, 0.f);
+
+    INFO("objectCoordinates = " << oc.x << " " << oc.y << " " << oc.z);
+
+    requireSameSample(sample, sampleReordered);
+  }
+
+  vklRelease(samplerReordered);
+  vklRelease(sampler);
+
+  v.reset();
+  vReordered.reset();
+}
+
+#if OPENVKL_DEVICE_CPU_UNSTRUCTURED
+TEST_CASE("Unstructured volume spatial reorder", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  SECTION("vertex-valued hexahedra")
+  {
+    reordered_sampling_matches(VKL_HEXAHEDRON, false, false);
+  }
+
+  SECTION("cell-valued hexahedra with index prefix")
+  {
+    reordered_sampling_matches(VKL_HEXAHEDRON, true, true);
+  }
+
+  SECTION("vertex-valued tetrahedra")
+  {
+    reordered_sampling_matches(VKL_TETRAHEDRON, false, false);
+  }
+
+  shutdownOpenVKL();
+}
+#endif
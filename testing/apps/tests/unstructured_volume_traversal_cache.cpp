@@ -0,0 +1,102 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <random>
+#include "unstructured_volume_utility.h"
+
+static void ray_marching_matches_traversal(bool cellAdjacency)
+{
+  const vec3i dimensions(16);
+
+  std::unique_ptr<WaveletUnstructuredProceduralVolume> v, vCached;
+
+  VKLVolume volume = newWaveletUnstructuredVolume(
+      v, dimensions, {{"traversalCache", false}, {"cellAdjacency", false}});
+  VKLVolume volumeCached = newWaveletUnstructuredVolume(
+      vCached,
+      dimensions,
+      {{"traversalCache", true}, {"cellAdjacency", cellAdjacency}});
+
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  VKLSampler samplerCached = vklNewSampler(volumeCached);
+  vklCommit(samplerCached);
+
+  std::mt19937 eng(42);
+  std::uniform_real_distribution<float> dist(0.f, float(dimensions.x));
+
+  for (int i = 0; i < 8; i++) {
+    // rays start outside of the volume, and leave it again
+    const vec3f origin(-1.f);
+    const vec3f target(dist(eng), dist(eng), dist(eng));
+    const vec3f d = normalize(target - origin);
+
+    std::vector<vec3f> positions;
+    for (float t = 0.f; t < 2.f * dimensions.x; t += 0.37f) {
+      positions.push_back(origin + t * d);
+    }
+
+    for (const vec3f &p : positions) {
+      INFO("objectCoordinates = " << p.x << " " << p.y << " " << p.z);
+
+      requireSameSample(
+          vklComputeSample(sampler, (const vkl_vec3f *)&p, 0, 0.f),
+          vklComputeSample(samplerCached, (const vkl_vec3f *)&p, 0, 0.f));
+
+      const vkl_vec3f g =
+          vklComputeGradient(sampler, (const vkl_vec3f *)&p, 0, 0.f);
+      const vkl_vec3f gCached =
+          vklComputeGradient(samplerCached, (const vkl_vec3f *)&p, 0, 0.f);
+
+      for (int k = 0; k < 3; k++) {
+        requireSameSample((&g.x)[k], (&gCached.x)[k], 1e-3f);
+      }
+    }
+
+    std::vector<float> samples(positions.size());
+    std::vector<float> samplesCached(positions.size());
+
+    vklComputeSampleN(sampler,
+                      positions.size(),
+                      (const vkl_vec3f *)positions.data(),
+                      samples.data(),
+                      0,
+                      nullptr);
+    vklComputeSampleN(samplerCached,
+                      positions.size(),
+                      (const vkl_vec3f *)positions.data(),
+                      samplesCached.data(),
+                      0,
+                      nullptr);
+
+    for (size_t j = 0; j < positions.size(); j++) {
+      requireSameSample(samples[j], samplesCached[j]);
+    }
+  }
+
+  vklRelease(samplerCached);
+  vklRelease(sampler);
+
+  v.reset();
+  vCached.reset();
+}
+
+#if OPENVKL_DEVICE_CPU_UNSTRUCTURED
+TEST_CASE("Unstructured volume traversal cache", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  SECTION("hinted cell only")
+  {
+    ray_marching_matches_traversal(false);
+  }
+
+  SECTION("hinted cell and its neighbors")
+  {
+    ray_marching_matches_traversal(true);
+  }
+
+  shutdownOpenVKL();
+}
+#endif
@@ -0,0 +1,50 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "../../external/catch.hpp"
+#include "openvkl_testing.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+// Creates a wavelet unstructured volume on a unit spaced grid at the origin,
+// and commits it with the given boolean volume parameters (e.g. options that
+// only change acceleration structures, to be compared against the defaults).
+inline VKLVolume newWaveletUnstructuredVolume(
+    std::unique_ptr<WaveletUnstructuredProceduralVolume> &v,
+    const vec3i &dimensions,
+    const std::vector<std::pair<const char *, bool>> &boolParams,
+    VKLUnstructuredCellType primType = VKL_HEXAHEDRON,
+    bool cellValued                  = false,
+    bool indexPrefix                 = true)
+{
+  v = rkcommon::make_unique<WaveletUnstructuredProceduralVolume>(
+      dimensions, vec3f(0.f), vec3f(1.f), primType, cellValued, indexPrefix);
+
+  VKLVolume vklVolume = v->getVKLVolume(getOpenVKLDevice());
+  for (const auto &param : boolParams) {
+    vklSetBool(vklVolume, param.first, param.second);
+  }
+  vklCommit(vklVolume);
+
+  return vklVolume;
+}
+
+// Requires two samples (or gradient components) to match, where NaN (outside
+// of any cell) only matches NaN.
+inline void requireSameSample(float expected,
+                              float actual,
+                              float margin = 1e-5f)
+{
+  if (std::isnan(expected)) {
+    REQUIRE(std::isnan(actual));
+  } else {
+    REQUIRE(actual == Approx(expected).margin(margin));
+  }
+}
@@ -0,0 +1,257 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <random>
+#include "unstructured_volume_utility.h"
+
+// Rectilinear mesh of axis-aligned hexahedra with irregular integer spacing,
+// so that BVH splits do not line up with a regular pattern, and positions on
+// shared faces, edges and corners are exactly representable.
+struct RectilinearHexMesh
+{
+  RectilinearHexMesh(const vec3i &dimensions, std::mt19937 &eng)
+      : dimensions(dimensions)
+  {
+    std::uniform_int_distribution<int> spacing(1, 3);
+
+    for (int d = 0; d < 3; d++) {
+      planes[d].push_back(0.f);
+      for (int i = 0; i < dimensions[d]; i++) {
+        planes[d].push_back(planes[d].back() + spacing(eng));
+      }
+    }
+  }
+
+  uint64_t numCells() const
+  {
+    return dimensions.long_product();
+  }
+
+  box3f getCellBounds(uint64_t cellId) const
+  {
+    const int x = cellId % dimensions.x;
+    const int y = (cellId / dimensions.x) % dimensions.y;
+    const int z = cellId / (dimensions.x * dimensions.y);
+
+    return box3f(vec3f(planes[0][x], planes[1][y], planes[2][z]),
+                 vec3f(planes[0][x + 1], planes[1][y + 1], planes[2][z + 1]));
+  }
+
+  box3f getBounds() const
+  {
+    return box3f(vec3f(planes[0].front(), planes[1].front(), planes[2].front()),
+                 vec3f(planes[0].back(), planes[1].back(), planes[2].back()));
+  }
+
+  // values are the cell ID for cell-valued meshes, and a linear function
+  // (which hexahedra on axis-aligned boxes interpolate exactly) otherwise
+  static float linearValue(const vec3f &p)
+  {
+    return p.x + 2.f * p.y + 3.f * p.z;
+  }
+
+  VKLVolume newVKLVolume(bool cellValued) const
+  {
+    const vec3i vdim = dimensions + vec3i(1);
+
+    std::vector<vec3f> positions;
+    std::vector<float> vertexValues;
+
+    for (int z = 0; z < vdim.z; z++) {
+      for (int y = 0; y < vdim.y; y++) {
+        for (int x = 0; x < vdim.x; x++) {
+          const vec3f p(planes[0][x], planes[1][y], planes[2][z]);
+          positions.push_back(p);
+          vertexValues.push_back(linearValue(p));
+        }
+      }
+    }
+
+    std::vector<uint32_t> index;
+    std::vector<uint32_t> cellIndex;
+    std::vector<uint8_t> cellType(numCells(), VKL_HEXAHEDRON);
+    std::vector<float> cellValues;
+
+    for (uint64_t c = 0; c < numCells(); c++) {
+      const uint32_t x = c % dimensions.x;
+      const uint32_t y = (c / dimensions.x) % dimensions.y;
+      const uint32_t z = c / (dimensions.x * dimensions.y);
+
+      const uint32_t v0 = (z * vdim.y + y) * vdim.x + x;
+      const uint32_t v4 = v0 + vdim.x * vdim.y;
+
+      cellIndex.push_back(index.size());
+      for (uint32_t v : {v0,
+                         v0 + 1,
+                         v0 + vdim.x + 1,
+                         v0 + vdim.x,
+                         v4,
+                         v4 + 1,
+                         v4 + vdim.x + 1,
+                         v4 + vdim.x}) {
+        index.push_back(v);
+      }
+
+      cellValues.push_back(float(c));
+    }
+
+    VKLVolume volume = vklNewVolume(getOpenVKLDevice(), "unstructured");
+
+    const auto setData = [&](const char *name,
+                             size_t numItems,
+                             VKLDataType dataType,
+                             const void *source) {
+      VKLData data =
+          vklNewData(getOpenVKLDevice(), numItems, dataType, source);
+      vklSetData(volume, name, data);
+      vklRelease(data);
+    };
+
+    setData("vertex.position", positions.size(), VKL_VEC3F, positions.data());
+    setData("index", index.size(), VKL_UINT, index.data());
+    setData("cell.index", cellIndex.size(), VKL_UINT, cellIndex.data());
+    setData("cell.type", cellType.size(), VKL_UCHAR, cellType.data());
+
+    if (cellValued) {
+      setData("cell.data", cellValues.size(), VKL_FLOAT, cellValues.data());
+    } else {
+      setData(
+          "vertex.data", vertexValues.size(), VKL_FLOAT, vertexValues.data());
+    }
+
+    vklCommit(volume);
+
+    return volume;
+  }
+
+  vec3i dimensions;
+  std::vector<float> planes[3];
+};
+
+// Checks a sample against all cells containing the position, found by
+// testing every cell of the mesh. Positions on shared faces are contained in
+// several cells; traversal order decides which one answers, so any of them is
+// accepted.
+static void requireBruteForceSample(const RectilinearHexMesh &mesh,
+                                    bool cellValued,
+                                    const vec3f &p,
+                                    float sample)
+{
+  INFO("objectCoordinates = " << p.x << " " << p.y << " " << p.z);
+  INFO("sample = " << sample);
+
+  std::vector<uint64_t> containing;
+  for (uint64_t c = 0; c < mesh.numCells(); c++) {
+    const box3f b = mesh.getCellBounds(c);
+    if (p.x >= b.lower.x && p.y >= b.lower.y && p.z >= b.lower.z &&
+        p.x <= b.upper.x && p.y <= b.upper.y && p.z <= b.upper.z) {
+      containing.push_back(c);
+    }
+  }
+
+  if (containing.empty()) {
+    REQUIRE(std::isnan(sample));
+  } else if (cellValued) {
+    bool matched = false;
+    for (uint64_t c : containing) {
+      matched |= sample == float(c);
+    }
+    REQUIRE(matched);
+  } else {
+    const float expected = RectilinearHexMesh::linearValue(p);
+    REQUIRE(sample == Approx(expected).epsilon(1e-5f).margin(1e-4f));
+  }
+}
+
+static void wide_bvh_matches_brute_force(bool cellValued)
+{
+  std::mt19937 eng(42);
+
+  const RectilinearHexMesh mesh(vec3i(12, 9, 7), eng);
+
+  VKLVolume volume = mesh.newVKLVolume(cellValued);
+
+  VKLSampler sampler = vklNewSampler(volume);
+  vklCommit(sampler);
+
+  const box3f bounds = mesh.getBounds();
+
+  std::vector<vec3f> positions;
+
+  // random positions in and around the mesh
+  std::uniform_real_distribution<float> distX(bounds.lower.x - 1.f,
+                                              bounds.upper.x + 1.f);
+  std::uniform_real_distribution<float> distY(bounds.lower.y - 1.f,
+                                              bounds.upper.y + 1.f);
+  std::uniform_real_distribution<float> distZ(bounds.lower.z - 1.f,
+                                              bounds.upper.z + 1.f);
+
+  for (int i = 0; i < 1000; i++) {
+    positions.push_back(vec3f(distX(eng), distY(eng), distZ(eng)));
+  }
+
+  // positions inside the mesh snapped to interior grid planes in one or more
+  // dimensions, i.e. on shared faces, edges and corners
+  std::uniform_real_distribution<float> unit(0.f, 1.f);
+  std::uniform_int_distribution<int> snapMask(1, 7);
+
+  for (int i = 0; i < 1000; i++) {
+    const int mask = snapMask(eng);
+
+    vec3f p;
+    for (int d = 0; d < 3; d++) {
+      const std::vector<float> &planes = mesh.planes[d];
+
+      if (mask & (1 << d)) {
+        std::uniform_int_distribution<size_t> plane(1, planes.size() - 2);
+        p[d] = planes[plane(eng)];
+      } else {
+        p[d] = planes.front() + unit(eng) * (planes.back() - planes.front());
+      }
+    }
+
+    positions.push_back(p);
+  }
+
+  for (const vec3f &p : positions) {
+    const float sample =
+        vklComputeSample(sampler, (const vkl_vec3f *)&p, 0, 0.f);
+    requireBruteForceSample(mesh, cellValued, p, sample);
+  }
+
+  // streams traverse the BVH with many different positions per SIMD step
+  std::vector<float> samples(positions.size());
+
+  vklComputeSampleN(sampler,
+                    positions.size(),
+                    (const vkl_vec3f *)positions.data(),
+                    samples.data(),
+                    0,
+                    nullptr);
+
+  for (size_t i = 0; i < positions.size(); i++) {
+    requireBruteForceSample(mesh, cellValued, positions[i], samples[i]);
+  }
+
+  vklRelease(sampler);
+  vklRelease(volume);
+}
+
+#if OPENVKL_DEVICE_CPU_UNSTRUCTURED
+TEST_CASE("Unstructured volume wide BVH", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  SECTION("vertex-valued hexahedra")
+  {
+    wide_bvh_matches_brute_force(false);
+  }
+
+  SECTION("cell-valued hexahedra")
+  {
+    wide_bvh_matches_brute_force(true);
+  }
+
+  shutdownOpenVKL();
+}
+#endif
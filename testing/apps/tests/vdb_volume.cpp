@@ -1,7 +1,12 @@
 // Copyright 2020 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
 #include "../../external/catch.hpp"
+#include "lod_utility.h"
 #include "openvkl_testing.h"
 #include "rkcommon/utility/multidim_index_sequence.h"
 #include "sampling_utility.h"
@@ -915,4 +920,736 @@ TEST_CASE("VDB volume special cases", "[interval_iterators]")
 
   shutdownOpenVKL();
 }
+
+TEST_CASE("VDB volume quantized leaves", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  const uint32_t level   = vklVdbNumLevels() - 1;
+  const uint32_t res     = vklVdbLevelRes(level);
+  const VKLFormat format = VKL_FORMAT_DENSE_ZYX;
+  const vec3i origin     = vec3i(0, 0, 0);
+
+  const float scale  = 0.5f;
+  const float offset = -3.f;
+
+  std::vector<uint8_t> voxels(vklVdbLevelNumVoxels(level));
+  for (size_t i = 0; i < voxels.size(); ++i) {
+    voxels[i] = static_cast<uint8_t>(i % 251);
+  }
+
+  auto setNode = [&](VKLVolume volume) {
+    VKLData data =
+        vklNewData(getOpenVKLDevice(), voxels.size(), VKL_UCHAR, voxels.data());
+    VKLData levelData = vklNewData(getOpenVKLDevice(), 1, VKL_UINT, &level);
+    vklSetData(volume, "node.level", levelData);
+    vklRelease(levelData);
+    VKLData originData = vklNewData(getOpenVKLDevice(), 1, VKL_VEC3I, &origin);
+    vklSetData(volume, "node.origin", originData);
+    vklRelease(originData);
+    VKLData formatData = vklNewData(getOpenVKLDevice(), 1, VKL_UINT, &format);
+    vklSetData(volume, "node.format", formatData);
+    vklRelease(formatData);
+    VKLData dataData = vklNewData(getOpenVKLDevice(), 1, VKL_DATA, &data);
+    vklSetData(volume, "node.data", dataData);
+    vklRelease(dataData);
+    vklRelease(data);
+  };
+
+  VKLVolume volume = vklNewVolume(getOpenVKLDevice(), "vdb");
+  setNode(volume);
+
+  SECTION("Missing quantization parameters")
+  {
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 1);
+    REQUIRE(std::string(vklDeviceGetLastErrorMsg(getOpenVKLDevice()))
+                .find("node.quantizationScale") != std::string::npos);
+  }
+
+  SECTION("Nearest sampling")
+  {
+    VKLData scaleData = vklNewData(getOpenVKLDevice(), 1, VKL_FLOAT, &scale);
+    vklSetData(volume, "node.quantizationScale", scaleData);
+    vklRelease(scaleData);
+    VKLData offsetData = vklNewData(getOpenVKLDevice(), 1, VKL_FLOAT, &offset);
+    vklSetData(volume, "node.quantizationOffset", offsetData);
+    vklRelease(offsetData);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+
+    VKLSampler sampler = vklNewSampler(volume);
+    vklSetInt(sampler, "filter", VKL_FILTER_NEAREST);
+    vklCommit(sampler);
+
+    const vkl_range1f valueRange = vklGetValueRange(volume);
+    REQUIRE(valueRange.lower == Approx(offset));
+    REQUIRE(valueRange.upper == Approx(offset + scale * 250.f));
+
+    multidim_index_sequence<3> mis(vec3i(res));
+    for (const auto &offsetIndex : mis) {
+      const vec3f oc = vec3f(offsetIndex) + 0.5f;
+      const uint64_t idx = vklVdbDomainOffsetToLinear(
+          level, offsetIndex.x, offsetIndex.y, offsetIndex.z);
+      INFO("offset = " << offsetIndex.x << " " << offsetIndex.y << " "
+                       << offsetIndex.z);
+      REQUIRE(vklComputeSample(sampler, (const vkl_vec3f *)&oc) ==
+              Approx(offset + scale * voxels[idx]));
+    }
+
+    vklRelease(sampler);
+  }
+
+  vklRelease(volume);
+
+  shutdownOpenVKL();
+}
+
+// Set the given dense leaf nodes (all on the leaf level) on a vdb volume.
+static void setVdbLeafNodes(VKLVolume volume,
+                            const std::vector<vec3i> &origins,
+                            const std::vector<VKLData> &leaves)
+{
+  const std::vector<uint32_t> levels(origins.size(), vklVdbNumLevels() - 1);
+  const std::vector<uint32_t> formats(origins.size(), VKL_FORMAT_DENSE_ZYX);
+
+  VKLData levelData =
+      vklNewData(getOpenVKLDevice(), levels.size(), VKL_UINT, levels.data());
+  vklSetData(volume, "node.level", levelData);
+  vklRelease(levelData);
+  VKLData originData = vklNewData(
+      getOpenVKLDevice(), origins.size(), VKL_VEC3I, origins.data());
+  vklSetData(volume, "node.origin", originData);
+  vklRelease(originData);
+  VKLData formatData =
+      vklNewData(getOpenVKLDevice(), formats.size(), VKL_UINT, formats.data());
+  vklSetData(volume, "node.format", formatData);
+  vklRelease(formatData);
+  VKLData dataData =
+      vklNewData(getOpenVKLDevice(), leaves.size(), VKL_DATA, leaves.data());
+  vklSetData(volume, "node.data", dataData);
+  vklRelease(dataData);
+}
+
+// Verify that the incrementally committed volume matches a volume built from
+// scratch from the same nodes. With prefiltered inner levels, coarse levels of
+// detail are compared as well.
+static void requireEqualToFullRebuild(VKLVolume volume,
+                                      const std::vector<vec3i> &origins,
+                                      const std::vector<VKLData> &leaves,
+                                      bool prefilterInnerLevels = false)
+{
+  VKLVolume reference = vklNewVolume(getOpenVKLDevice(), "vdb");
+  vklSetBool(reference, "prefilterInnerLevels", prefilterInnerLevels);
+  setVdbLeafNodes(reference, origins, leaves);
+  vklCommit(reference);
+
+  const vkl_range1f range          = vklGetValueRange(volume);
+  const vkl_range1f referenceRange = vklGetValueRange(reference);
+  REQUIRE(range.lower == referenceRange.lower);
+  REQUIRE(range.upper == referenceRange.upper);
+
+  std::vector<float> lods{0.f};
+  if (prefilterInnerLevels) {
+    for (uint32_t l = 0; (l + 1) < vklVdbNumLevels(); ++l) {
+      lods.push_back(std::log2(float(vklVdbLevelRes(l + 1))));
+    }
+  }
+
+  for (float lod : lods) {
+    VKLSampler sampler          = newLodSampler(volume, lod);
+    VKLSampler referenceSampler = newLodSampler(reference, lod);
+
+    multidim_index_sequence<3> mis(vec3i(20));
+    for (const auto &index : mis) {
+      const vec3f oc = vec3f(index) * 2.5f - 4.f;
+      const float sample = vklComputeSample(sampler, (const vkl_vec3f *)&oc);
+      const float referenceSample =
+          vklComputeSample(referenceSampler, (const vkl_vec3f *)&oc);
+      INFO("lod = " << lod);
+      INFO("oc = " << oc.x << " " << oc.y << " " << oc.z);
+      REQUIRE(((std::isnan(sample) && std::isnan(referenceSample)) ||
+               sample == referenceSample));
+    }
+
+    vklRelease(referenceSampler);
+    vklRelease(sampler);
+  }
+
+  vklRelease(reference);
+}
+
+TEST_CASE("VDB volume incremental commit", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  const uint32_t level = vklVdbNumLevels() - 1;
+  const int res        = vklVdbLevelRes(level);
+
+  const auto makeLeaf = [&](float base) {
+    std::vector<float> voxels(vklVdbLevelNumVoxels(level));
+    for (size_t i = 0; i < voxels.size(); ++i) {
+      voxels[i] = base + 0.01f * i;
+    }
+    return vklNewData(
+        getOpenVKLDevice(), voxels.size(), VKL_FLOAT, voxels.data());
+  };
+
+  std::vector<vec3i> origins;
+  std::vector<VKLData> leaves;
+  multidim_index_sequence<3> mis(vec3i(4));
+  for (const auto &index : mis) {
+    origins.push_back(index * res);
+    leaves.push_back(makeLeaf(static_cast<float>(origins.size())));
+  }
+
+  VKLVolume volume = vklNewVolume(getOpenVKLDevice(), "vdb");
+  vklSetBool(volume, "incrementalCommit", true);
+  setVdbLeafNodes(volume, origins, leaves);
+  vklCommit(volume);
+  REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+
+  SECTION("modify, add and remove nodes")
+  {
+    // Modify a node, so that it dominates the value range.
+    vklRelease(leaves[5]);
+    leaves[5] = makeLeaf(100.f);
+
+    // Remove a node.
+    vklRelease(leaves[10]);
+    leaves.erase(leaves.begin() + 10);
+    origins.erase(origins.begin() + 10);
+
+    // Add a node that requires a new inner node.
+    origins.push_back(vec3i(4 * res, 0, 0));
+    leaves.push_back(makeLeaf(-50.f));
+
+    setVdbLeafNodes(volume, origins, leaves);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+    requireEqualToFullRebuild(volume, origins, leaves);
+
+    // Removing the dominating node again must shrink the value range.
+    vklRelease(leaves[5]);
+    leaves.erase(leaves.begin() + 5);
+    origins.erase(origins.begin() + 5);
+
+    setVdbLeafNodes(volume, origins, leaves);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+    requireEqualToFullRebuild(volume, origins, leaves);
+  }
+
+  SECTION("reordered nodes")
+  {
+    std::reverse(origins.begin(), origins.end());
+    std::reverse(leaves.begin(), leaves.end());
+
+    setVdbLeafNodes(volume, origins, leaves);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+    requireEqualToFullRebuild(volume, origins, leaves);
+  }
+
+  SECTION("prefiltered inner levels")
+  {
+    vklSetBool(volume, "prefilterInnerLevels", true);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+    requireEqualToFullRebuild(volume, origins, leaves, true);
+
+    // Modify and remove interior nodes, so that the domain does not change
+    // and only affected averages are recomputed.
+    vklRelease(leaves[5]);
+    leaves[5] = makeLeaf(100.f);
+
+    vklRelease(leaves[10]);
+    leaves.erase(leaves.begin() + 10);
+    origins.erase(origins.begin() + 10);
+
+    setVdbLeafNodes(volume, origins, leaves);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+    requireEqualToFullRebuild(volume, origins, leaves, true);
+
+    // Extending the domain requires recomputing all averages.
+    origins.push_back(vec3i(4 * res, 0, 0));
+    leaves.push_back(makeLeaf(-50.f));
+
+    setVdbLeafNodes(volume, origins, leaves);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+    requireEqualToFullRebuild(volume, origins, leaves, true);
+  }
+
+  SECTION("samplers follow the volume across commits")
+  {
+    VKLSampler sampler = vklNewSampler(volume);
+    vklSetInt(sampler, "filter", VKL_FILTER_NEAREST);
+    vklCommit(sampler);
+
+    // The first voxel of each node holds the node's base value. Sampling
+    // fills the traversal cache of this thread, which must not be used
+    // across commits of the volume.
+    const auto sampleNode = [&](size_t i) {
+      const vec3f oc = vec3f(origins[i]) + vec3f(0.5f);
+      return vklComputeSample(sampler, (const vkl_vec3f *)&oc);
+    };
+
+    REQUIRE(sampleNode(4) == 5.f);
+    REQUIRE(sampleNode(5) == 6.f);
+
+    // The tree is updated in place.
+    vklRelease(leaves[5]);
+    leaves[5] = makeLeaf(100.f);
+    setVdbLeafNodes(volume, origins, leaves);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+
+    REQUIRE(sampleNode(5) == 100.f);
+    REQUIRE(sampleNode(4) == 5.f);
+    REQUIRE(sampleNode(5) == 100.f);
+
+    // The tree is rebuilt.
+    vklSetBool(volume, "incrementalCommit", false);
+    vklRelease(leaves[4]);
+    leaves[4] = makeLeaf(200.f);
+    setVdbLeafNodes(volume, origins, leaves);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+
+    REQUIRE(sampleNode(5) == 100.f);
+    REQUIRE(sampleNode(4) == 200.f);
+
+    vklRelease(sampler);
+  }
+
+  vklRelease(volume);
+
+  for (VKLData leaf : leaves) {
+    vklRelease(leaf);
+  }
+
+  shutdownOpenVKL();
+}
+
+TEST_CASE("VDB volume reordered packed nodes", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  WaveletVdbVolumeFloat *volume = nullptr;
+  REQUIRE_NOTHROW(volume = new WaveletVdbVolumeFloat(
+                      getOpenVKLDevice(), 128, vec3f(0.f), vec3f(1.f), true));
+
+  VKLVolume vklVolume = volume->getVKLVolume(getOpenVKLDevice());
+  const range1f valueRange = volume->getComputedValueRange();
+
+  vklSetBool(vklVolume, "reorderPackedNodes", true);
+  REQUIRE_NOTHROW(vklCommit(vklVolume));
+
+  vkl_range1f reorderedValueRange = vklGetValueRange(vklVolume, 0);
+  REQUIRE(reorderedValueRange.lower == valueRange.lower);
+  REQUIRE(reorderedValueRange.upper == valueRange.upper);
+
+  VKLSampler vklSampler = vklNewSampler(vklVolume);
+  vklSetInt(vklSampler, "filter", VKL_FILTER_TRILINEAR);
+  vklSetInt(vklSampler, "gradientFilter", VKL_FILTER_TRILINEAR);
+  vklCommit(vklSampler);
+
+  const vec3i step(2);
+  multidim_index_sequence<3> mis(volume->getDimensions() / step);
+  for (const auto &offset : mis) {
+    const auto offsetWithStep = offset * step;
+
+    const vec3f objectCoordinates =
+        volume->transformLocalToObjectCoordinates(offsetWithStep);
+
+    const float proceduralValue =
+        volume->computeProceduralValue(objectCoordinates);
+
+    INFO("offset = " << offsetWithStep.x << " " << offsetWithStep.y << " "
+                     << offsetWithStep.z);
+
+    test_scalar_and_vector_sampling(
+        vklSampler, objectCoordinates, proceduralValue, 1e-4f);
+  }
+
+  vklRelease(vklSampler);
+  REQUIRE_NOTHROW(delete volume);
+
+  shutdownOpenVKL();
+}
+
+TEST_CASE("VDB volume traversal cache", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  // The volume spans more than one node on the last inner level.
+  WaveletVdbVolumeFloat *volume = nullptr;
+  REQUIRE_NOTHROW(volume = new WaveletVdbVolumeFloat(getOpenVKLDevice(),
+                                                     vec3i(160, 40, 40),
+                                                     vec3f(0.f),
+                                                     vec3f(1.f)));
+  VKLVolume vklVolume = volume->getVKLVolume(getOpenVKLDevice());
+
+  // Ray marching access pattern.
+  std::vector<vec3f> objectCoordinates;
+  const vec3f directions[] = {vec3f(1.f, 0.13f, 0.07f),
+                              vec3f(0.9f, -0.2f, 0.3f),
+                              vec3f(-1.f, 0.05f, -0.11f)};
+  const vec3f origins[]    = {vec3f(0.5f, 3.2f, 7.1f),
+                              vec3f(0.1f, 30.7f, 2.3f),
+                              vec3f(158.f, 20.f, 30.f)};
+  for (int r = 0; r < 3; ++r) {
+    const vec3f step = 0.37f * normalize(directions[r]);
+    for (vec3f p = origins[r]; p.x >= 0.f && p.x < 159.f && p.y >= 0.f &&
+                               p.y < 39.f && p.z >= 0.f && p.z < 39.f;
+         p += step) {
+      objectCoordinates.push_back(p);
+    }
+  }
+
+  auto newSampler = [&](VKLFilter filter,
+                        int maxSamplingDepth,
+                        bool traversalCache) -> VKLSampler {
+    VKLSampler sampler = vklNewSampler(vklVolume);
+    vklSetInt(sampler, "filter", filter);
+    vklSetInt(sampler, "gradientFilter", filter);
+    vklSetInt(sampler, "maxSamplingDepth", maxSamplingDepth);
+    vklSetBool(sampler, "traversalCache", traversalCache);
+    vklCommit(sampler);
+    return sampler;
+  };
+
+  const int maxDepth = vklVdbNumLevels() - 1;
+
+  for (VKLFilter filter :
+       {VKL_FILTER_NEAREST, VKL_FILTER_TRILINEAR, VKL_FILTER_TRICUBIC}) {
+    std::ostringstream sectionName;
+    sectionName << "filter " << filter;
+
+    DYNAMIC_SECTION(sectionName.str())
+    {
+      VKLSampler cached    = newSampler(filter, maxDepth, true);
+      VKLSampler reference = newSampler(filter, maxDepth, false);
+
+      // Switching samplers between queries on the same thread must not
+      // reuse nodes from the other sampler.
+      VKLSampler cachedShallow    = newSampler(filter, 1, true);
+      VKLSampler referenceShallow = newSampler(filter, 1, false);
+
+      for (const vec3f &oc : objectCoordinates) {
+        const vkl_vec3f *c = (const vkl_vec3f *)&oc;
+        INFO("objectCoordinates = " << oc.x << " " << oc.y << " " << oc.z);
+        REQUIRE(vklComputeSample(cached, c) == vklComputeSample(reference, c));
+        REQUIRE(vklComputeSample(cachedShallow, c) ==
+                vklComputeSample(referenceShallow, c));
+
+        const vkl_vec3f g  = vklComputeGradient(cached, c);
+        const vkl_vec3f gr = vklComputeGradient(reference, c);
+        REQUIRE(g.x == gr.x);
+        REQUIRE(g.y == gr.y);
+        REQUIRE(g.z == gr.z);
+      }
+
+      std::vector<float> samples(objectCoordinates.size());
+      std::vector<float> referenceSamples(objectCoordinates.size());
+      vklComputeSampleN(cached,
+                        objectCoordinates.size(),
+                        (const vkl_vec3f *)objectCoordinates.data(),
+                        samples.data());
+      vklComputeSampleN(reference,
+                        objectCoordinates.size(),
+                        (const vkl_vec3f *)objectCoordinates.data(),
+                        referenceSamples.data());
+      REQUIRE(samples == referenceSamples);
+
+      // Re-committing a sampler must invalidate cached traversal results.
+      vklSetInt(cached, "maxSamplingDepth", 1);
+      vklCommit(cached);
+      for (const vec3f &oc : objectCoordinates) {
+        const vkl_vec3f *c = (const vkl_vec3f *)&oc;
+        INFO("objectCoordinates = " << oc.x << " " << oc.y << " " << oc.z);
+        REQUIRE(vklComputeSample(cached, c) ==
+                vklComputeSample(referenceShallow, c));
+      }
+
+      vklRelease(referenceShallow);
+      vklRelease(cachedShallow);
+      vklRelease(reference);
+      vklRelease(cached);
+    }
+  }
+
+  REQUIRE_NOTHROW(delete volume);
+
+  shutdownOpenVKL();
+}
+
+TEST_CASE("VDB volume serialized grid", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  const std::string filename = "vdb_volume_serialized_grid.bin";
+
+  for (const auto &repackNodes : {true, false}) {
+    std::stringstream sectionName;
+    sectionName << (repackNodes ? "repackNodes=true" : "repackNodes=false");
+
+    DYNAMIC_SECTION(sectionName.str())
+    {
+      WaveletVdbVolumeFloat *volume = nullptr;
+      REQUIRE_NOTHROW(
+          volume = new WaveletVdbVolumeFloat(
+              getOpenVKLDevice(), 64, vec3f(0.f), vec3f(1.f), repackNodes));
+
+      VKLVolume vklVolume = volume->getVKLVolume(getOpenVKLDevice());
+      vklSetString(vklVolume, "exportSerializedGridFile", filename.c_str());
+      vklCommit(vklVolume);
+      REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+
+      VKLVolume mapped = vklNewVolume(getOpenVKLDevice(), "vdb");
+      vklSetString(mapped, "serializedGridFile", filename.c_str());
+      vklCommit(mapped);
+      REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+
+      const vkl_box3f bbox       = vklGetBoundingBox(vklVolume);
+      const vkl_box3f mappedBbox = vklGetBoundingBox(mapped);
+      REQUIRE(mappedBbox.lower.x == bbox.lower.x);
+      REQUIRE(mappedBbox.upper.z == bbox.upper.z);
+
+      const vkl_range1f valueRange       = vklGetValueRange(vklVolume);
+      const vkl_range1f mappedValueRange = vklGetValueRange(mapped);
+      REQUIRE(mappedValueRange.lower == valueRange.lower);
+      REQUIRE(mappedValueRange.upper == valueRange.upper);
+
+      VKLSampler sampler       = vklNewSampler(vklVolume);
+      VKLSampler mappedSampler = vklNewSampler(mapped);
+      vklCommit(sampler);
+      vklCommit(mappedSampler);
+
+      multidim_index_sequence<3> mis(volume->getDimensions() - 1);
+      for (const auto &offset : mis) {
+        const vec3f oc = volume->transformLocalToObjectCoordinates(offset) +
+                         vec3f(0.25f);
+        REQUIRE(vklComputeSample(mappedSampler, (const vkl_vec3f *)&oc) ==
+                vklComputeSample(sampler, (const vkl_vec3f *)&oc));
+      }
+
+      vklRelease(mappedSampler);
+      vklRelease(sampler);
+      vklRelease(mapped);
+      REQUIRE_NOTHROW(delete volume);
+      std::remove(filename.c_str());
+    }
+  }
+
+  SECTION("invalid file")
+  {
+    VKLVolume mapped = vklNewVolume(getOpenVKLDevice(), "vdb");
+    vklSetString(mapped, "serializedGridFile", "does_not_exist.bin");
+    vklCommit(mapped);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 1);
+    REQUIRE(std::string(vklDeviceGetLastErrorMsg(getOpenVKLDevice())) ==
+            "cannot open file does_not_exist.bin");
+    vklRelease(mapped);
+  }
+
+  shutdownOpenVKL();
+}
+
+TEST_CASE("VDB volume paged nodes", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  // A 2x2x2 block of dense leaf nodes, where node i has the value i.
+  const uint32_t level    = vklVdbNumLevels() - 1;
+  const int res           = vklVdbLevelRes(level);
+  const uint64_t nodeSize = vklVdbLevelNumVoxels(level) * sizeof(float);
+  const size_t numNodes   = 8;
+
+  std::vector<uint32_t> levels(numNodes, level);
+  std::vector<uint32_t> formats(numNodes, VKL_FORMAT_DENSE_ZYX);
+  std::vector<vec3i> origins;
+  std::vector<range1f> valueRanges;
+  for (size_t i = 0; i < numNodes; ++i) {
+    origins.push_back(res * vec3i(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+    valueRanges.push_back(range1f(float(i), float(i)));
+  }
+
+  std::atomic<int> numPageIns(0);
+
+  VKLVdbNodePageCallback callback =
+      [](void *userData, uint64_t nodeIndex, unsigned int, void *buffer) {
+        static_cast<std::atomic<int> *>(userData)->fetch_add(1);
+        float *values = static_cast<float *>(buffer);
+        std::fill(values,
+                  values + vklVdbLevelNumVoxels(vklVdbNumLevels() - 1),
+                  float(nodeIndex));
+      };
+
+  VKLVolume volume = vklNewVolume(getOpenVKLDevice(), "vdb");
+
+  auto setData = [&](const char *name, VKLDataType type, const void *data) {
+    VKLData d = vklNewData(getOpenVKLDevice(), numNodes, type, data);
+    vklSetData(volume, name, d);
+    vklRelease(d);
+  };
+
+  setData("node.level", VKL_UINT, levels.data());
+  setData("node.origin", VKL_VEC3I, origins.data());
+  setData("node.format", VKL_UINT, formats.data());
+  setData("node.valueRange", VKL_BOX1F, valueRanges.data());
+
+  const uint32_t attributeType = VKL_FLOAT;
+  VKLData attributeTypes =
+      vklNewData(getOpenVKLDevice(), 1, VKL_UINT, &attributeType);
+  vklSetData(volume, "nodePageAttributeTypes", attributeTypes);
+  vklRelease(attributeTypes);
+
+  vklSetVoidPtr(volume, "nodePageCallback", (void *)callback);
+  vklSetVoidPtr(volume, "nodePageUserData", &numPageIns);
+
+  // Only half of the nodes fit into the cache.
+  const uint64_t budget = 4 * nodeSize;
+  vklSetParam(volume, "nodePageBudget", VKL_ULONG, &budget);
+
+  vklCommit(volume);
+  REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+  REQUIRE(numPageIns == 0);
+
+  auto sampleNode = [&](VKLSampler sampler, size_t i) {
+    const vec3f p = vec3f(origins[i]) + vec3f(0.5f * res);
+    return vklComputeSample(sampler, (const vkl_vec3f *)&p);
+  };
+
+  SECTION("nodes are paged in on access, paging out others if needed")
+  {
+    VKLSampler sampler = vklNewSampler(volume);
+    vklCommit(sampler);
+    VKLObserver observer = vklNewSamplerObserver(sampler, "LeafNodeAccess");
+    REQUIRE(observer);
+
+    for (size_t i = 0; i < 4; ++i) {
+      REQUIRE(sampleNode(sampler, i) == float(i));
+    }
+    REQUIRE(numPageIns == 4);
+
+    // These do not fit along with the first four nodes.
+    for (size_t i = 4; i < numNodes; ++i) {
+      REQUIRE(sampleNode(sampler, i) == float(i));
+    }
+    REQUIRE(numPageIns == 8);
+
+    // Some of the first nodes were paged out, and are paged in again.
+    for (size_t i = 0; i < numNodes; ++i) {
+      REQUIRE(sampleNode(sampler, i) == float(i));
+    }
+    REQUIRE(numPageIns > 8);
+
+    const uint32_t *access =
+        static_cast<const uint32_t *>(vklMapObserver(observer));
+    REQUIRE(access);
+    for (size_t i = 0; i < numNodes; ++i) {
+      REQUIRE(access[i] == 1);
+    }
+    vklUnmapObserver(observer);
+
+    vklRelease(observer);
+    vklRelease(sampler);
+  }
+
+  SECTION("filter stencils spanning more nodes than the budget")
+  {
+    const uint64_t singleNode = nodeSize;
+    vklSetParam(volume, "nodePageBudget", VKL_ULONG, &singleNode);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+
+    VKLSampler sampler = vklNewSampler(volume);
+    vklSetInt(sampler, "filter", VKL_FILTER_TRILINEAR);
+    vklCommit(sampler);
+
+    // Halfway between the voxels around the corner shared by all nodes,
+    // each of the 8 stencil voxels is in a different node.
+    const vec3f p(res - 0.5f);
+    for (int i = 0; i < 4; ++i) {
+      REQUIRE(vklComputeSample(sampler, (const vkl_vec3f *)&p) ==
+              Approx(3.5f));
+    }
+
+    vklRelease(sampler);
+  }
+
+  SECTION("concurrent sampling under a small budget")
+  {
+    const uint64_t twoNodes = 2 * nodeSize;
+    vklSetParam(volume, "nodePageBudget", VKL_ULONG, &twoNodes);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+
+    VKLSampler sampler = vklNewSampler(volume);
+    vklCommit(sampler);
+
+    std::atomic<int> numWrong(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int k = 0; k < 1000; ++k) {
+          const size_t i = (k * 3 + t) % numNodes;
+          if (sampleNode(sampler, i) != float(i)) {
+            numWrong++;
+          }
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    REQUIRE(numWrong == 0);
+
+    vklRelease(sampler);
+  }
+
+  SECTION("budgets must hold a node")
+  {
+    const uint64_t tooSmall = nodeSize - 1;
+    vklSetParam(volume, "nodePageBudget", VKL_ULONG, &tooSmall);
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) != 0);
+  }
+
+  SECTION("re-commits page out least recently used nodes, and prefetch")
+  {
+    VKLSampler sampler = vklNewSampler(volume);
+    vklCommit(sampler);
+    for (size_t i = 0; i < 4; ++i) {
+      REQUIRE(sampleNode(sampler, i) == float(i));
+    }
+    vklRelease(sampler);
+
+    const std::vector<uint32_t> prefetch = {4, 5, 6, 7};
+    VKLData prefetchData = vklNewData(
+        getOpenVKLDevice(), prefetch.size(), VKL_UINT, prefetch.data());
+    vklSetData(volume, "nodePagePrefetch", prefetchData);
+    vklRelease(prefetchData);
+
+    vklCommit(volume);
+    REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == 0);
+    REQUIRE(numPageIns == 8);
+
+    sampler = vklNewSampler(volume);
+    vklCommit(sampler);
+    for (size_t i = 4; i < numNodes; ++i) {
+      REQUIRE(sampleNode(sampler, i) == float(i));
+    }
+    REQUIRE(numPageIns == 8);
+    vklRelease(sampler);
+  }
+
+  vklRelease(volume);
+
+  shutdownOpenVKL();
+}
+
 #endif
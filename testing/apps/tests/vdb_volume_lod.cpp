@@ -0,0 +1,128 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cmath>
+#include <random>
+#include "../../external/catch.hpp"
+#include "lod_utility.h"
+#include "openvkl_testing.h"
+#include "rkcommon/utility/multidim_index_sequence.h"
+
+using namespace rkcommon;
+using namespace openvkl::testing;
+
+#if OPENVKL_DEVICE_CPU_VDB
+TEST_CASE("VDB volume level of detail", "[volume_sampling]")
+{
+  initializeOpenVKL();
+
+  // grid origin and spacing are identity, so object coordinates are index
+  // coordinates.
+  const int dimension = 64;
+  const int leafRes   = vklVdbLevelRes(vklVdbNumLevels() - 1);
+
+  std::unique_ptr<WaveletVdbVolumeFloat> v(new WaveletVdbVolumeFloat(
+      getOpenVKLDevice(), dimension, vec3f(0.f), vec3f(1.f), false));
+
+  VKLVolume volume = v->getVKLVolume(getOpenVKLDevice());
+
+  VKLSampler nearest = newLodSampler(volume, 0.f, VKL_FILTER_NEAREST);
+
+  // each leaf node is covered by one voxel of the last inner level.
+  const multidim_index_sequence<3> leaves(vec3i(dimension / leafRes));
+
+  const auto leafAverage = [&](const vec3i &leaf) -> float {
+    float sum = 0.f;
+    const multidim_index_sequence<3> voxels(vec3i(leafRes));
+    for (const auto &ijk : voxels) {
+      sum += sampleAt(nearest, vec3f(leaf * leafRes + ijk));
+    }
+    return sum / (leafRes * leafRes * leafRes);
+  };
+
+  SECTION("lod is ignored without prefiltered inner levels")
+  {
+    VKLSampler reference = newLodSampler(volume, 0.f);
+    VKLSampler coarse    = newLodSampler(volume, 3.f);
+
+    for (const auto &leaf : leaves) {
+      const vec3f oc = vec3f(leaf * leafRes) + vec3f(0.3f, 0.5f, 0.7f);
+      REQUIRE(sampleAt(coarse, oc) == sampleAt(reference, oc));
+    }
+
+    vklRelease(coarse);
+    vklRelease(reference);
+  }
+
+  vklSetBool(volume, "prefilterInnerLevels", true);
+  vklCommit(volume);
+  REQUIRE(vklDeviceGetLastErrorCode(getOpenVKLDevice()) == VKL_NO_ERROR);
+
+  vklRelease(nearest);
+  nearest = newLodSampler(volume, 0.f, VKL_FILTER_NEAREST);
+
+  const float innerLod = std::log2(float(leafRes));
+
+  SECTION("the last inner level stores leaf averages")
+  {
+    VKLSampler coarse = newLodSampler(volume, innerLod);
+
+    for (const auto &leaf : leaves) {
+      const vec3f oc = vec3f(leaf * leafRes) + 0.5f * (leafRes - 1);
+
+      INFO("leaf = " << leaf.x << " " << leaf.y << " " << leaf.z);
+      REQUIRE(sampleAt(coarse, oc) ==
+              Approx(leafAverage(leaf)).epsilon(1e-4f).margin(1e-4f));
+    }
+
+    vklRelease(coarse);
+  }
+
+  SECTION("maxSamplingDepth uses averages")
+  {
+    VKLSampler shallow = vklNewSampler(volume);
+    vklSetInt(shallow, "filter", VKL_FILTER_NEAREST);
+    vklSetInt(shallow, "maxSamplingDepth", vklVdbNumLevels() - 2);
+    vklCommit(shallow);
+
+    for (const auto &leaf : leaves) {
+      const vec3f oc = vec3f(leaf * leafRes) + vec3f(1.f, 2.f, 3.f);
+
+      INFO("leaf = " << leaf.x << " " << leaf.y << " " << leaf.z);
+      REQUIRE(sampleAt(shallow, oc) ==
+              Approx(leafAverage(leaf)).epsilon(1e-4f).margin(1e-4f));
+    }
+
+    vklRelease(shallow);
+  }
+
+  SECTION("fractional lod blends between levels")
+  {
+    VKLSampler fine   = newLodSampler(volume, 0.f);
+    VKLSampler coarse = newLodSampler(volume, innerLod);
+    VKLSampler blend  = newLodSampler(volume, 0.5f * innerLod);
+
+    std::mt19937 eng(0);
+    std::uniform_real_distribution<float> dist(0.f, float(dimension));
+
+    for (int i = 0; i < 1000; i++) {
+      const vec3f oc(dist(eng), dist(eng), dist(eng));
+
+      INFO("objectCoordinates = " << oc.x << " " << oc.y << " " << oc.z);
+      REQUIRE(sampleAt(blend, oc) ==
+              Approx(0.5f * (sampleAt(fine, oc) + sampleAt(coarse, oc)))
+                  .margin(1e-5f));
+    }
+
+    vklRelease(blend);
+    vklRelease(coarse);
+    vklRelease(fine);
+  }
+
+  vklRelease(nearest);
+
+  REQUIRE_NOTHROW(v.reset());
+
+  shutdownOpenVKL();
+}
+#endif
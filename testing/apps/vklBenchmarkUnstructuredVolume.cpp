@@ -1,6 +1,8 @@
 // Copyright 2019 Intel Corporation
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+#include <numeric>
 #include <random>
 #include "../common/simd.h"
 #include "benchmark/benchmark.h"
@@ -233,6 +235,222 @@ BENCHMARK_ALL_PRIMS(vectorFixedSample, 4)
 BENCHMARK_ALL_PRIMS(vectorFixedSample, 8)
 BENCHMARK_ALL_PRIMS(vectorFixedSample, 16)
 
+/*
+ * Hexahedral mesh of the wavelet on a dim^3 grid, with cells and vertices in
+ * random order, as they often come from simulation codes. The volume handle
+ * must be released by the caller.
+ */
+static VKLVolume newShuffledHexVolume(int dim, bool spatialReorder)
+{
+  const int vdim             = dim + 1;
+  const uint32_t numVertices = vdim * vdim * vdim;
+  const uint32_t numCells    = dim * dim * dim;
+
+  std::mt19937 eng(42);
+
+  std::vector<uint32_t> vertexOrder(numVertices);
+  std::iota(vertexOrder.begin(), vertexOrder.end(), 0);
+  std::shuffle(vertexOrder.begin(), vertexOrder.end(), eng);
+
+  std::vector<uint32_t> cellOrder(numCells);
+  std::iota(cellOrder.begin(), cellOrder.end(), 0);
+  std::shuffle(cellOrder.begin(), cellOrder.end(), eng);
+
+  // vertexOrder[v] is the shuffled id of grid vertex v
+  std::vector<vec3f> positions(numVertices);
+  std::vector<float> values(numVertices);
+
+  for (uint32_t v = 0; v < numVertices; v++) {
+    const vec3f p(v % vdim, (v / vdim) % vdim, v / (vdim * vdim));
+    positions[vertexOrder[v]] = p;
+    values[vertexOrder[v]]    = getWaveletValue<float>(p, 0.f);
+  }
+
+  std::vector<uint32_t> index(numCells * 8);
+  std::vector<uint32_t> cellIndex(numCells);
+  std::vector<uint8_t> cellType(numCells, VKL_HEXAHEDRON);
+
+  for (uint32_t c = 0; c < numCells; c++) {
+    const uint32_t x = c % dim;
+    const uint32_t y = (c / dim) % dim;
+    const uint32_t z = c / (dim * dim);
+
+    const uint32_t v0 = (z * vdim + y) * vdim + x;
+    const uint32_t v4 = v0 + vdim * vdim;
+
+    const uint32_t corners[8] = {
+        v0, v0 + 1, v0 + vdim + 1, v0 + vdim, v4, v4 + 1, v4 + vdim + 1,
+        v4 + vdim};
+
+    const uint32_t offset = cellOrder[c] * 8;
+
+    cellIndex[cellOrder[c]] = offset;
+    for (int i = 0; i < 8; i++) {
+      index[offset + i] = vertexOrder[corners[i]];
+    }
+  }
+
+  VKLVolume volume = vklNewVolume(getOpenVKLDevice(), "unstructured");
+
+  const auto setData = [&](const char *name,
+                           size_t numItems,
+                           VKLDataType dataType,
+                           const void *source) {
+    VKLData data = vklNewData(getOpenVKLDevice(), numItems, dataType, source);
+    vklSetData(volume, name, data);
+    vklRelease(data);
+  };
+
+  setData("vertex.position", numVertices, VKL_VEC3F, positions.data());
+  setData("vertex.data", numVertices, VKL_FLOAT, values.data());
+  setData("index", index.size(), VKL_UINT, index.data());
+  setData("cell.index", numCells, VKL_UINT, cellIndex.data());
+  setData("cell.type", numCells, VKL_UCHAR, cellType.data());
+
+  vklSetBool(volume, "spatialReorder", spatialReorder);
+  vklCommit(volume);
+
+  return volume;
+}
+
+// Random sampling of a mesh in solver order, with and without reordering.
+template <bool spatialReorder>
+static void scalarRandomSampleShuffled(benchmark::State &state)
+{
+  const int dim = getEnvBenchmarkVolumeDim();
+
+  VKLVolume vklVolume   = newShuffledHexVolume(dim, spatialReorder);
+  VKLSampler vklSampler = vklNewSampler(vklVolume);
+  vklCommit(vklSampler);
+
+  vkl_box3f bbox = vklGetBoundingBox(vklVolume);
+
+  std::random_device rd;
+  pcg32_biased_float_distribution distX(rd(), 0, bbox.lower.x, bbox.upper.x);
+  pcg32_biased_float_distribution distY(rd(), 0, bbox.lower.y, bbox.upper.y);
+  pcg32_biased_float_distribution distZ(rd(), 0, bbox.lower.z, bbox.upper.z);
+
+  BENCHMARK_WARMUP_AND_RUN(({
+    vkl_vec3f objectCoordinates{distX(), distY(), distZ()};
+
+    benchmark::DoNotOptimize(
+        vklComputeSample(vklSampler, (const vkl_vec3f *)&objectCoordinates));
+  }));
+
+  // enables rates in report output
+  state.SetItemsProcessed(state.iterations());
+  vklRelease(vklSampler);
+  vklRelease(vklVolume);
+}
+
+BENCHMARK_TEMPLATE(scalarRandomSampleShuffled, false);
+BENCHMARK_TEMPLATE(scalarRandomSampleShuffled, true);
+
+// Ray marching through a mesh in solver order, with and without reordering.
+template <bool spatialReorder>
+static void scalarCoherentSampleShuffled(benchmark::State &state)
+{
+  const int dim = getEnvBenchmarkVolumeDim();
+
+  VKLVolume vklVolume   = newShuffledHexVolume(dim, spatialReorder);
+  VKLSampler vklSampler = vklNewSampler(vklVolume);
+  vklCommit(vklSampler);
+
+  vkl_box3f bbox = vklGetBoundingBox(vklVolume);
+
+  std::random_device rd;
+  pcg32_biased_float_distribution distX(rd(), 0, bbox.lower.x, bbox.upper.x);
+  pcg32_biased_float_distribution distY(rd(), 0, bbox.lower.y, bbox.upper.y);
+
+  // rays along z, with a step of a quarter cell
+  const float step = 0.25f;
+
+  vkl_vec3f objectCoordinates{distX(), distY(), bbox.lower.z};
+
+  BENCHMARK_WARMUP_AND_RUN(({
+    objectCoordinates.z += step;
+    if (objectCoordinates.z > bbox.upper.z) {
+      objectCoordinates = vkl_vec3f{distX(), distY(), bbox.lower.z};
+    }
+
+    benchmark::DoNotOptimize(
+        vklComputeSample(vklSampler, (const vkl_vec3f *)&objectCoordinates));
+  }));
+
+  // enables rates in report output
+  state.SetItemsProcessed(state.iterations());
+  vklRelease(vklSampler);
+  vklRelease(vklVolume);
+}
+
+BENCHMARK_TEMPLATE(scalarCoherentSampleShuffled, false);
+BENCHMARK_TEMPLATE(scalarCoherentSampleShuffled, true);
+
+// Point location throughput of stream sampling, where all program instances
+// of a traversal step locate different positions. The default wide BVH tests
+// all children of a node against the active positions at once; the compact
+// BVH is a binary tree, and serves as the baseline. Coherent streams are
+// segments along z, random streams are scattered over the whole volume.
+template <bool compactBVH, bool coherent>
+static void streamSampleBVH(benchmark::State &state)
+{
+  const int dim = getEnvBenchmarkVolumeDim();
+
+  std::unique_ptr<WaveletUnstructuredProceduralVolume> v(
+      new WaveletUnstructuredProceduralVolume(
+          vec3i(dim), vec3f(0.f), vec3f(1.f), VKL_HEXAHEDRON, false));
+
+  VKLVolume vklVolume = v->getVKLVolume(getOpenVKLDevice());
+  vklSetBool(vklVolume, "compactBVH", compactBVH);
+  vklCommit(vklVolume);
+
+  VKLSampler vklSampler = vklNewSampler(vklVolume);
+  vklCommit(vklSampler);
+
+  vkl_box3f bbox = vklGetBoundingBox(vklVolume);
+
+  std::random_device rd;
+  pcg32_biased_float_distribution distX(rd(), 0, bbox.lower.x, bbox.upper.x);
+  pcg32_biased_float_distribution distY(rd(), 0, bbox.lower.y, bbox.upper.y);
+  pcg32_biased_float_distribution distZ(rd(), 0, bbox.lower.z, bbox.upper.z);
+
+  const unsigned int N = 1024;
+
+  std::vector<vkl_vec3f> objectCoordinates(N);
+  std::vector<float> samples(N);
+
+  BENCHMARK_WARMUP_AND_RUN(({
+    if (coherent) {
+      const float x = distX();
+      const float y = distY();
+      for (unsigned int i = 0; i < N; i++) {
+        objectCoordinates[i] = vkl_vec3f{
+            x, y, bbox.lower.z + (bbox.upper.z - bbox.lower.z) * i / N};
+      }
+    } else {
+      for (unsigned int i = 0; i < N; i++) {
+        objectCoordinates[i] = vkl_vec3f{distX(), distY(), distZ()};
+      }
+    }
+
+    vklComputeSampleN(vklSampler,
+                      N,
+                      objectCoordinates.data(),
+                      samples.data(),
+                      0,
+                      nullptr);
+  }));
+
+  // enables rates in report output
+  state.SetItemsProcessed(state.iterations() * N);
+  vklRelease(vklSampler);
+}
+
+BENCHMARK_TEMPLATE(streamSampleBVH, false, false);
+BENCHMARK_TEMPLATE(streamSampleBVH, true, false);
+BENCHMARK_TEMPLATE(streamSampleBVH, false, true);
+BENCHMARK_TEMPLATE(streamSampleBVH, true, true);
+
 // based on BENCHMARK_MAIN() macro from benchmark.h
 int main(int argc, char **argv)
 {
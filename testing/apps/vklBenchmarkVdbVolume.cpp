@@ -12,14 +12,35 @@ using openvkl::testing::WaveletVdbVolumeFloat;
 
 /*
  * VDB volume wrapper.
- * Parametrize with the lookup filter type.
+ * Parametrize with the lookup filter type, whether packed nodes should be
+ * reordered along a Z-order curve on commit, whether the sampler caches
+ * the nodes visited last during traversal, whether the sampler sorts
+ * stream queries spatially, and whether leaves are added to the volume in
+ * random order (which destroys the spatial locality of the node buffers).
  */
-template <VKLFilter filter>
+template <VKLFilter filter,
+          bool reorderPackedNodes = false,
+          bool traversalCache     = true,
+          bool sortQueries        = false,
+          bool shuffleLeaves      = false>
 struct Vdb
 {
   static std::string name()
   {
-    return toString<filter>();
+    std::string n = toString<filter>();
+    if (reorderPackedNodes) {
+      n += ", reorderPackedNodes";
+    }
+    if (!traversalCache) {
+      n += ", no traversalCache";
+    }
+    if (sortQueries) {
+      n += ", sortQueries";
+    }
+    if (shuffleLeaves) {
+      n += ", shuffleLeaves";
+    }
+    return n;
   }
 
   static constexpr unsigned int getNumAttributes()
@@ -33,13 +54,29 @@ struct Vdb
 
     const bool repackNodes = true;
 
-    volume = rkcommon::make_unique<WaveletVdbVolumeFloat>(
-        getOpenVKLDevice(), vec3i(dim), vec3f(0.f), vec3f(1.f), repackNodes);
+    volume = rkcommon::make_unique<WaveletVdbVolumeFloat>(getOpenVKLDevice(),
+                                                          vec3i(dim),
+                                                          vec3f(0.f),
+                                                          vec3f(1.f),
+                                                          repackNodes,
+                                                          TemporalConfig(),
+                                                          1,
+                                                          VKL_DATA_DEFAULT,
+                                                          0,
+                                                          shuffleLeaves);
+
+    vklVolume = volume->getVKLVolume(getOpenVKLDevice());
+
+    if (reorderPackedNodes) {
+      vklSetBool(vklVolume, "reorderPackedNodes", true);
+      vklCommit(vklVolume);
+    }
 
-    vklVolume  = volume->getVKLVolume(getOpenVKLDevice());
     vklSampler = vklNewSampler(vklVolume);
     vklSetInt(vklSampler, "filter", filter);
     vklSetInt(vklSampler, "gradientFilter", filter);
+    vklSetBool(vklSampler, "traversalCache", traversalCache);
+    vklSetBool(vklSampler, "sortQueries", sortQueries);
     vklCommit(vklSampler);
   }
 
@@ -73,6 +110,39 @@ int main(int argc, char **argv)
   registerVolumeBenchmarks<Vdb<VKL_FILTER_TRILINEAR>>();
   registerVolumeBenchmarks<Vdb<VKL_FILTER_TRICUBIC>>();
 
+  // Effect of reordering packed nodes, for incoherent (Random) and coherent
+  // (ray marching) access patterns. Leaves are shuffled first, so that the
+  // packed nodes are not already in spatial order.
+  using coordinate_generator::Coherent;
+  using coordinate_generator::Random;
+  using VdbShuffled = Vdb<VKL_FILTER_TRILINEAR, false, true, false, true>;
+  using VdbShuffledReordered =
+      Vdb<VKL_FILTER_TRILINEAR, true, true, false, true>;
+  registerComputeSample<VdbShuffled, Random>();
+  registerComputeSample<VdbShuffledReordered, Random>();
+  registerComputeSample<VdbShuffled, Coherent>();
+  registerComputeSample<VdbShuffledReordered, Coherent>();
+
+  // Effect of the traversal cache for ray marching access patterns.
+  registerComputeSample<Vdb<VKL_FILTER_NEAREST, false, false>, Coherent>();
+  registerComputeSample<Vdb<VKL_FILTER_NEAREST, false, true>, Coherent>();
+  registerComputeSample<Vdb<VKL_FILTER_TRILINEAR, false, false>, Coherent>();
+  registerComputeSample<Vdb<VKL_FILTER_TRICUBIC, false, false>, Coherent>();
+  registerComputeSample<Vdb<VKL_FILTER_TRICUBIC, false, true>, Coherent>();
+  registerComputeGradient<Vdb<VKL_FILTER_TRILINEAR, false, false>, Coherent>();
+  registerComputeGradient<Vdb<VKL_FILTER_TRILINEAR, false, true>, Coherent>();
+
+  // Effect of sorting large batches of incoherent stream queries.
+  using programming_model::Stream;
+  constexpr unsigned int batchSize = 1u << 20;
+  registerBenchmark<api::VklComputeSample<Stream<batchSize>,
+                                          Vdb<VKL_FILTER_TRILINEAR>,
+                                          Random>>();
+  registerBenchmark<
+      api::VklComputeSample<Stream<batchSize>,
+                            Vdb<VKL_FILTER_TRILINEAR, false, true, true>,
+                            Random>>();
+
   ::benchmark::Initialize(&argc, argv);
   if (::benchmark::ReportUnrecognizedArguments(argc, argv))
     return 1;
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <random>
 #include <rkcommon/math/AffineSpace.h>
 #include "ProceduralVolume.h"
 #include "TestingVolume.h"
@@ -96,7 +98,8 @@ namespace openvkl {
           const TemporalConfig &temporalConfig   = TemporalConfig(),
           uint32_t numAttributes                 = 1,
           VKLDataCreationFlags dataCreationFlags = VKL_DATA_DEFAULT,
-          size_t byteStride                      = 0);
+          size_t byteStride                      = 0,
+          bool shuffleLeaves                     = false);
 
       range1f getComputedValueRange() const override;
 
@@ -464,7 +467,8 @@ namespace openvkl {
                             const TemporalConfig &temporalConfig,
                             uint32_t numAttributes,
                             VKLDataCreationFlags dataCreationFlags,
-                            size_t byteStride)
+                            size_t byteStride,
+                            bool shuffleLeaves)
         : ProceduralVdbVolumeBase(dimensions,
                                   gridOrigin,
                                   gridSpacing,
@@ -514,32 +518,45 @@ namespace openvkl {
       // this may over-allocate leaf node storage, if we happen to have tiles.
       buffers->reserve(numLeafNodes, 0);
 
-      valueRange = range1f();
+      std::vector<vec3i> leaves;
+      leaves.reserve(numLeafNodes);
       for (int x = 0; x < numLeafNodesIn.x; ++x) {
         for (int y = 0; y < numLeafNodesIn.y; ++y) {
           for (int z = 0; z < numLeafNodesIn.z; ++z) {
-            switch (temporalConfig.type) {
-            case TemporalConfig::Constant:
-              addTemporallyConstantLeaf(x, y, z, byteStride, numAttributes);
-              break;
-            case TemporalConfig::Structured:
-              addTemporallyStructuredLeaf(
-                  x, y, z, byteStride, temporalConfig, numAttributes);
-              break;
-            case TemporalConfig::Unstructured:
-              if (numAttributes == 1) {
-                addTemporallyUnstructuredLeaf(
-                    x, y, z, byteStride, temporalConfig, numAttributes);
-              } else {
-                addTemporallyStructuredLeaf(
-                    x, y, z, byteStride, temporalConfig, numAttributes);
-              }
-              break;
-            default:
-              assert(false);
-              break;
-            }
+            leaves.emplace_back(x, y, z);
+          }
+        }
+      }
+
+      // Leaves are stored in the order they are added; shuffling them
+      // destroys the spatial locality of the node buffers.
+      if (shuffleLeaves) {
+        std::mt19937 eng(42);
+        std::shuffle(leaves.begin(), leaves.end(), eng);
+      }
+
+      valueRange = range1f();
+      for (const vec3i &l : leaves) {
+        switch (temporalConfig.type) {
+        case TemporalConfig::Constant:
+          addTemporallyConstantLeaf(l.x, l.y, l.z, byteStride, numAttributes);
+          break;
+        case TemporalConfig::Structured:
+          addTemporallyStructuredLeaf(
+              l.x, l.y, l.z, byteStride, temporalConfig, numAttributes);
+          break;
+        case TemporalConfig::Unstructured:
+          if (numAttributes == 1) {
+            addTemporallyUnstructuredLeaf(
+                l.x, l.y, l.z, byteStride, temporalConfig, numAttributes);
+          } else {
+            addTemporallyStructuredLeaf(
+                l.x, l.y, l.z, byteStride, temporalConfig, numAttributes);
           }
+          break;
+        default:
+          assert(false);
+          break;
         }
       }
     }
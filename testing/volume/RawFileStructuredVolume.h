@@ -4,30 +4,45 @@
 #pragma once
 
 #include "TestingStructuredVolume.h"
+#include "openvkl/utility/mapped_file/MappedFile.h"
 // std
 #include <algorithm>
 #include <fstream>
+#include <memory>
 
 using namespace rkcommon;
 
 namespace openvkl {
   namespace testing {
 
+    using utility::mapped_file::MappedFile;
+    using utility::mapped_file::MappedFileAdvice;
+
     struct RawFileStructuredVolume final : public TestingStructuredVolume
     {
-      RawFileStructuredVolume(const std::string &filename,
-                              const std::string &gridType,
-                              const vec3i &dimensions,
-                              const vec3f &gridOrigin,
-                              const vec3f &gridSpacing,
-                              VKLDataType voxelType);
+      RawFileStructuredVolume(
+          const std::string &filename,
+          const std::string &gridType,
+          const vec3i &dimensions,
+          const vec3f &gridOrigin,
+          const vec3f &gridSpacing,
+          VKLDataType voxelType,
+          MappedFileAdvice advice = MappedFileAdvice::Normal);
+
+      ~RawFileStructuredVolume();
 
       void generateVoxels(std::vector<unsigned char> &voxels,
                           std::vector<float> &time,
                           std::vector<uint32_t> &tuvIndex) const override final;
 
+     protected:
+      // The file is memory mapped and shared with Open VKL.
+      bool getSharedVoxels(SharedVoxels &shared) override final;
+
      private:
       std::string filename;
+      MappedFileAdvice advice;
+      std::unique_ptr<MappedFile> file;
     };
 
     // Inlined definitions ////////////////////////////////////////////////////
@@ -38,8 +53,10 @@ namespace openvkl {
         const vec3i &dimensions,
         const vec3f &gridOrigin,
         const vec3f &gridSpacing,
-        VKLDataType voxelType)
+        VKLDataType voxelType,
+        MappedFileAdvice advice)
         : filename(filename),
+          advice(advice),
           TestingStructuredVolume(gridType,
                                   dimensions,
                                   gridOrigin,
@@ -49,6 +66,30 @@ namespace openvkl {
     {
     }
 
+    inline RawFileStructuredVolume::~RawFileStructuredVolume()
+    {
+      // The VKL volume references the mapping.
+      release();
+    }
+
+    inline bool RawFileStructuredVolume::getSharedVoxels(SharedVoxels &shared)
+    {
+      const size_t numBytes =
+          this->dimensions.long_product() * sizeOfVKLDataType(voxelType);
+
+      if (!file) {
+        file = std::unique_ptr<MappedFile>(new MappedFile(filename, advice));
+      }
+
+      if (file->size() < numBytes) {
+        throw std::runtime_error("raw volume file is too small");
+      }
+
+      shared.voxels = file->data();
+
+      return true;
+    }
+
     inline void RawFileStructuredVolume::generateVoxels(
         std::vector<unsigned char> &voxels,
         std::vector<float> &time,
@@ -4,26 +4,39 @@
 #pragma once
 
 #include "TestingStructuredVolume.h"
+#include "openvkl/utility/mapped_file/MappedFile.h"
 // std
 #include <algorithm>
 #include <fstream>
+#include <memory>
 
 using namespace rkcommon;
 
 namespace openvkl {
   namespace testing {
 
+    using utility::mapped_file::MappedFile;
+    using utility::mapped_file::MappedFileAdvice;
+
     struct RawHFileStructuredVolume final : public TestingStructuredVolume
     {
-      RawHFileStructuredVolume(const std::string &filename,
-                               const std::string &gridType,
-                               const vec3f &gridOrigin,
-                               const vec3f &gridSpacing);
+      RawHFileStructuredVolume(
+          const std::string &filename,
+          const std::string &gridType,
+          const vec3f &gridOrigin,
+          const vec3f &gridSpacing,
+          MappedFileAdvice advice = MappedFileAdvice::Normal);
+
+      ~RawHFileStructuredVolume();
 
       void generateVoxels(std::vector<unsigned char> &voxels,
                           std::vector<float> &time,
                           std::vector<uint32_t> &tuvIndex) const override final;
 
+     protected:
+      // The file is memory mapped and shared with Open VKL.
+      bool getSharedVoxels(SharedVoxels &shared) override final;
+
      private:
       void readStaticFile(std::ifstream &input,
                           std::vector<unsigned char> &voxels,
@@ -40,6 +53,8 @@ namespace openvkl {
 
       std::string filename;
       size_t readPosition{0};
+      MappedFileAdvice advice;
+      std::unique_ptr<MappedFile> file;
     };
 
     // Inlined definitions ////////////////////////////////////////////////////
@@ -48,8 +63,10 @@ namespace openvkl {
         const std::string &filename,
         const std::string &gridType,
         const vec3f &gridOrigin,
-        const vec3f &gridSpacing)
+        const vec3f &gridSpacing,
+        MappedFileAdvice advice)
         : filename(filename),
+          advice(advice),
           TestingStructuredVolume(
               gridType,
               vec3i(0) /* will be ready from file */,
@@ -103,6 +120,55 @@ namespace openvkl {
       }
     }
 
+    inline RawHFileStructuredVolume::~RawHFileStructuredVolume()
+    {
+      // The VKL volume references the mapping.
+      release();
+    }
+
+    inline bool RawHFileStructuredVolume::getSharedVoxels(SharedVoxels &shared)
+    {
+      if (!file) {
+        file = std::unique_ptr<MappedFile>(new MappedFile(filename, advice));
+      }
+
+      const size_t voxelSize = sizeOfVKLDataType(voxelType);
+      size_t offset          = readPosition;
+
+      const auto require = [&](size_t numBytes) {
+        if (file->size() < offset + numBytes) {
+          throw std::runtime_error("rawh volume file is too small");
+        }
+      };
+
+      switch (temporalConfig.type) {
+      case TemporalConfig::Type::Constant:
+        require(dimensions.long_product() * voxelSize);
+        break;
+      case TemporalConfig::Type::Structured:
+        require(dimensions.long_product() * temporalConfig.sampleTime.size() *
+                voxelSize);
+        break;
+      case TemporalConfig::Type::Unstructured: {
+        const size_t numIndices = dimensions.long_product() + 1;
+        require(numIndices * sizeof(uint32_t));
+        shared.tuvIndex =
+            reinterpret_cast<const uint32_t *>(file->data() + offset);
+        offset += numIndices * sizeof(uint32_t);
+
+        const size_t numValues = shared.tuvIndex[numIndices - 1];
+        require(numValues * (sizeof(float) + voxelSize));
+        shared.time = reinterpret_cast<const float *>(file->data() + offset);
+        offset += numValues * sizeof(float);
+        break;
+      }
+      }
+
+      shared.voxels = file->data() + offset;
+
+      return true;
+    }
+
     inline void RawHFileStructuredVolume::readStaticFile(
         std::ifstream &input,
         std::vector<unsigned char> &voxels,
@@ -30,6 +30,23 @@ namespace openvkl {
                                   std::vector<uint32_t> &tuvIndex) const = 0;
 
      protected:
+      // Voxel data owned by the volume itself, for example a memory mapped
+      // file. This data is shared with Open VKL instead of being copied, and
+      // must remain valid until the VKL volume is released.
+      struct SharedVoxels
+      {
+        const void *voxels{nullptr};
+        const float *time{nullptr};
+        const uint32_t *tuvIndex{nullptr};
+      };
+
+      // Volumes may override this to provide shared voxel data; if it returns
+      // false, voxels are obtained through generateVoxels() instead.
+      virtual bool getSharedVoxels(SharedVoxels &shared)
+      {
+        return false;
+      }
+
       TestingStructuredVolume(
           const std::string &gridType,
           const vec3i &dimensions,
@@ -42,7 +59,7 @@ namespace openvkl {
 
       void generateVKLVolume(VKLDevice device) override final;
 
-      range1f computedValueRange = range1f(rkcommon::math::empty);
+      mutable range1f computedValueRange = range1f(rkcommon::math::empty);
 
       const std::string gridType;
       vec3i dimensions;
@@ -57,6 +74,11 @@ namespace openvkl {
       std::vector<unsigned char> voxels;
       std::vector<float> time;
       std::vector<uint32_t> tuvIndex;
+
+      // Set for shared voxel data, for which the value range is computed on
+      // demand; this avoids touching every page of a mapped file on load.
+      const void *sharedVoxels{nullptr};
+      size_t numSharedVoxels{0};
     };
 
     // Inlined definitions ////////////////////////////////////////////////////
@@ -90,6 +112,11 @@ namespace openvkl {
 
     inline range1f TestingStructuredVolume::getComputedValueRange() const
     {
+      if (computedValueRange.empty() && sharedVoxels) {
+        computedValueRange =
+            computeValueRange(voxelType, sharedVoxels, numSharedVoxels);
+      }
+
       if (computedValueRange.empty()) {
         throw std::runtime_error(
             "computedValueRange only available after VKL volume is generated");
@@ -133,7 +160,21 @@ namespace openvkl {
     {
       volume = vklNewVolume(device, gridType.c_str());
 
-      generateVoxels(voxels, time, tuvIndex);
+      SharedVoxels shared;
+      const bool isShared = getSharedVoxels(shared);
+
+      VKLDataCreationFlags flags = dataCreationFlags;
+
+      if (isShared) {
+        if (byteStride != sizeOfVKLDataType(voxelType))
+          throw std::runtime_error("shared voxel data must be compact");
+        flags = VKL_DATA_SHARED_BUFFER;
+      } else {
+        generateVoxels(voxels, time, tuvIndex);
+        shared.voxels   = voxels.data();
+        shared.time     = time.data();
+        shared.tuvIndex = tuvIndex.data();
+      }
 
       vklSetVec3i(
           volume, "dimensions", dimensions.x, dimensions.y, dimensions.z);
@@ -147,20 +188,23 @@ namespace openvkl {
       case TemporalConfig::Constant: {
         totalNumValues = dimensions.long_product();
 
-        if (voxels.size() != totalNumValues * byteStride)
-          throw std::runtime_error("generated voxel data has incorrect size");
-        if (!time.empty())
-          throw std::runtime_error(
-              "unexpected time data for temporally constant volume");
-        if (!tuvIndex.empty())
-          throw std::runtime_error(
-              "unexpected TUV index data for temporally constant volume");
+        if (!isShared) {
+          if (voxels.size() != totalNumValues * byteStride)
+            throw std::runtime_error(
+                "generated voxel data has incorrect size");
+          if (!time.empty())
+            throw std::runtime_error(
+                "unexpected time data for temporally constant volume");
+          if (!tuvIndex.empty())
+            throw std::runtime_error(
+                "unexpected TUV index data for temporally constant volume");
+        }
 
         VKLData data = vklNewData(device,
                                   totalNumValues,
                                   voxelType,
-                                  voxels.data(),
-                                  dataCreationFlags,
+                                  shared.voxels,
+                                  flags,
                                   byteStride);
         vklSetData(volume, "data", data);
         vklRelease(data);
@@ -170,20 +214,23 @@ namespace openvkl {
         totalNumValues =
             dimensions.long_product() * temporalConfig.sampleTime.size();
 
-        if (voxels.size() != totalNumValues * byteStride)
-          throw std::runtime_error("generated voxel data has incorrect size");
-        if (!time.empty())
-          throw std::runtime_error(
-              "unexpected time data for temporally structured volume");
-        if (!tuvIndex.empty())
-          throw std::runtime_error(
-              "unexpected TUV index data for temporally structured volume");
+        if (!isShared) {
+          if (voxels.size() != totalNumValues * byteStride)
+            throw std::runtime_error(
+                "generated voxel data has incorrect size");
+          if (!time.empty())
+            throw std::runtime_error(
+                "unexpected time data for temporally structured volume");
+          if (!tuvIndex.empty())
+            throw std::runtime_error(
+                "unexpected TUV index data for temporally structured volume");
+        }
 
         VKLData data = vklNewData(device,
                                   totalNumValues,
                                   voxelType,
-                                  voxels.data(),
-                                  dataCreationFlags,
+                                  shared.voxels,
+                                  flags,
                                   byteStride);
         vklSetData(volume, "data", data);
         vklRelease(data);
@@ -193,36 +240,39 @@ namespace openvkl {
         break;
       }
       case TemporalConfig::Unstructured: {
-        totalNumValues = tuvIndex.empty() ? 0 : *tuvIndex.rbegin();
+        const size_t numIndices = dimensions.long_product() + 1;
 
-        if (tuvIndex.size() != dimensions.long_product() + 1)
+        if (!isShared && tuvIndex.size() != numIndices)
           throw std::runtime_error(
               "generated TUV index data has incorrect size");
-        const size_t totalNumValues = tuvIndex.empty() ? 0 : *tuvIndex.rbegin();
-        if (voxels.size() != totalNumValues * byteStride)
-          throw std::runtime_error("generated voxel data has incorrect size");
-        if (time.size() != totalNumValues)
-          throw std::runtime_error("generated time data has incorrect size");
+
+        totalNumValues = shared.tuvIndex[numIndices - 1];
+
+        if (!isShared) {
+          if (voxels.size() != totalNumValues * byteStride)
+            throw std::runtime_error(
+                "generated voxel data has incorrect size");
+          if (time.size() != totalNumValues)
+            throw std::runtime_error(
+                "generated time data has incorrect size");
+        }
 
         VKLData data = vklNewData(device,
                                   totalNumValues,
                                   voxelType,
-                                  voxels.data(),
-                                  dataCreationFlags,
+                                  shared.voxels,
+                                  flags,
                                   byteStride);
         vklSetData(volume, "data", data);
         vklRelease(data);
 
-        VKLData indexData = vklNewData(device,
-                                       tuvIndex.size(),
-                                       VKL_UINT,
-                                       tuvIndex.data(),
-                                       dataCreationFlags);
+        VKLData indexData = vklNewData(
+            device, numIndices, VKL_UINT, shared.tuvIndex, flags);
         vklSetData(volume, "temporallyUnstructuredIndices", indexData);
         vklRelease(indexData);
 
         VKLData timeData = vklNewData(
-            device, time.size(), VKL_FLOAT, time.data(), dataCreationFlags);
+            device, totalNumValues, VKL_FLOAT, shared.time, flags);
         vklSetData(volume, "temporallyUnstructuredTimes", timeData);
         vklRelease(timeData);
 
@@ -232,6 +282,12 @@ namespace openvkl {
 
       vklCommit(volume);
 
+      if (isShared) {
+        sharedVoxels    = shared.voxels;
+        numSharedVoxels = totalNumValues;
+        return;
+      }
+
       computedValueRange =
           computeValueRange(voxelType, voxels.data(), totalNumValues);
 
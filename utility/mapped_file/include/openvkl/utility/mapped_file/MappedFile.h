@@ -0,0 +1,188 @@
+// Copyright 2022 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace openvkl {
+  namespace utility {
+    namespace mapped_file {
+
+      // Access pattern hints for mapped files. These are passed on to the
+      // operating system where supported, and ignored otherwise.
+      enum class MappedFileAdvice
+      {
+        Normal,
+        Random,
+        Sequential,
+        WillNeed  // start reading the whole file into the page cache
+      };
+
+      /*
+       * A read-only memory mapping of an entire file. The mapping can be
+       * passed to vklNewData() with VKL_DATA_SHARED_BUFFER, so that voxel
+       * data is paged in on demand rather than copied into application
+       * memory. Pages are shared through the page cache, so multiple
+       * processes mapping the same file share one copy in physical memory.
+       *
+       * Throws std::runtime_error if the file cannot be mapped.
+       */
+      class MappedFile
+      {
+       public:
+        explicit MappedFile(
+            const std::string &filename,
+            MappedFileAdvice advice = MappedFileAdvice::Normal);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        MappedFile(MappedFile &&)                 = delete;
+        MappedFile &operator=(MappedFile &&) = delete;
+
+        const uint8_t *data() const
+        {
+          return ptr;
+        }
+
+        size_t size() const
+        {
+          return numBytes;
+        }
+
+       private:
+        const uint8_t *ptr{nullptr};
+        size_t numBytes{0};
+
+#ifdef _WIN32
+        HANDLE file{INVALID_HANDLE_VALUE};
+        HANDLE mapping{nullptr};
+#endif
+      };
+
+      // Inlined definitions //////////////////////////////////////////////////
+
+#ifdef _WIN32
+
+      inline MappedFile::MappedFile(const std::string &filename,
+                                    MappedFileAdvice advice)
+      {
+        const DWORD flags = advice == MappedFileAdvice::Random
+                                ? FILE_FLAG_RANDOM_ACCESS
+                            : advice == MappedFileAdvice::Sequential
+                                ? FILE_FLAG_SEQUENTIAL_SCAN
+                                : FILE_ATTRIBUTE_NORMAL;
+
+        file = CreateFileA(filename.c_str(),
+                           GENERIC_READ,
+                           FILE_SHARE_READ,
+                           nullptr,
+                           OPEN_EXISTING,
+                           flags,
+                           nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+          throw std::runtime_error("cannot open file " + filename);
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+          CloseHandle(file);
+          throw std::runtime_error("cannot map empty file " + filename);
+        }
+        numBytes = static_cast<size_t>(fileSize.QuadPart);
+
+        mapping =
+            CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+          ptr = static_cast<const uint8_t *>(
+              MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+
+        if (!ptr) {
+          if (mapping) {
+            CloseHandle(mapping);
+          }
+          CloseHandle(file);
+          throw std::runtime_error("cannot map file " + filename);
+        }
+      }
+
+      inline MappedFile::~MappedFile()
+      {
+        UnmapViewOfFile(ptr);
+        CloseHandle(mapping);
+        CloseHandle(file);
+      }
+
+#else
+
+      inline MappedFile::MappedFile(const std::string &filename,
+                                    MappedFileAdvice advice)
+      {
+        const int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+          throw std::runtime_error("cannot open file " + filename);
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+          close(fd);
+          throw std::runtime_error("cannot map empty file " + filename);
+        }
+        numBytes = static_cast<size_t>(st.st_size);
+
+        void *p = mmap(nullptr, numBytes, PROT_READ, MAP_SHARED, fd, 0);
+
+        // The mapping stays valid after the descriptor is closed.
+        close(fd);
+
+        if (p == MAP_FAILED) {
+          throw std::runtime_error("cannot map file " + filename);
+        }
+
+        ptr = static_cast<const uint8_t *>(p);
+
+        // Hints only affect performance, so failures are not an error.
+        switch (advice) {
+        case MappedFileAdvice::Random:
+          posix_madvise(p, numBytes, POSIX_MADV_RANDOM);
+          break;
+        case MappedFileAdvice::Sequential:
+          posix_madvise(p, numBytes, POSIX_MADV_SEQUENTIAL);
+          break;
+        case MappedFileAdvice::WillNeed:
+          posix_madvise(p, numBytes, POSIX_MADV_WILLNEED);
+          break;
+        default:
+          break;
+        }
+      }
+
+      inline MappedFile::~MappedFile()
+      {
+        munmap(const_cast<uint8_t *>(ptr), numBytes);
+      }
+
+#endif
+
+    }  // namespace mapped_file
+  }    // namespace utility
+}  // namespace openvkl